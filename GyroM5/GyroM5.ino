@@ -4,10 +4,15 @@
 // PID Controler:
 //   error = ch1_in - Kg*yaw_rate
 //   ch1_out = Kp*( error + Ki*LPF(error) + Kd*HPF(error) )
+// Input:
+//   CH1/CH3 pulses by edge interrupts (no pulseIn),
+//   PID step at the fixed rate of CTRL_HERZ
 // URL:
 //   https://github.com/hshin-git/GyroM5
 //////////////////////////////////////////////////
-#include <M5StickC.h>
+#define GYROM5_BOARD BOARD_STICK
+#include <GyroM5Core.hpp>
+#include <Ticker.h>
 
 //////////////////////////////////////////////////
 // Global constants
@@ -25,13 +30,20 @@ const int PWM_WAIT = PWM_CYCL + 5000;
 const int PULSE_MIN = 1000;
 const int PULSE_MAX = 2000;
 const int RANGE_MAX = 100;
-// GPIO pins
+// GPIO pins (by board traits in GyroM5Core.hpp)
 //const int CH1_IN = 0;
 //const int CH3_IN = 36;
 //const int CH1_OUT = 26;
-const int CH1_IN = 26;
-const int CH3_IN = 36;
-const int CH1_OUT = 0;
+const int CH1_IN = Board::CH1_IN;
+const int CH3_IN = Board::CH3_IN;
+const int CH1_OUT = Board::CH1_OUT;
+// PID step rate (LPF/HPF constants are for one step per 50Hz frame)
+const int CTRL_HERZ = PWM_HERZ;
+const int CTRL_USEC = 1000000/CTRL_HERZ;
+// LCD refresh cycle in msec and text line height
+const int LCD_MSEC = 250;
+const int LCD_LINE = 8;
+const int LCD_USEC = 12000; // drawn only if the next step is this far
 
 
 //////////////////////////////////////////////////
@@ -46,6 +58,11 @@ void lcd_header(char *text) {
   lcd_clear();
   M5.Lcd.printf(text);
 }
+// overwrite from a line with background (no full clear)
+void lcd_line(int line, int bg_color=TFT_WHITE, int fg_color=TFT_BLACK) {
+  M5.Lcd.setTextColor(fg_color,bg_color);
+  M5.Lcd.setCursor(0,line*LCD_LINE);
+}
 
 
 //////////////////////////////////////////////////
@@ -53,15 +70,7 @@ void lcd_header(char *text) {
 //////////////////////////////////////////////////
 int lastVinTime = 0;
 void axp_halt(){
-  Wire1.beginTransmission(0x34);
-  Wire1.write(0x32);
-  Wire1.endTransmission();
-  Wire1.requestFrom(0x34, 1);
-  uint8_t buf = Wire1.read();
-  Wire1.beginTransmission(0x34);
-  Wire1.write(0x32);
-  Wire1.write(buf | 0x80); // halt bit
-  Wire1.endTransmission();
+  Board::halt();
 }
 void vin_watch() {
   float vin = M5.Axp.GetVinData()*1.7 /1000;
@@ -113,6 +122,74 @@ float hpf_update(float buf[],float x) {
 }
 
 
+//////////////////////////////////////////////////
+// PWM reading by edge interrupts
+//////////////////////////////////////////////////
+// PWM widths in usec (0 while no pulse)
+volatile int CH1_USEC = 0;
+volatile int CH3_USEC = 0;
+// edge handling and glitch rejection by PulseCapture (GyroM5Core.hpp),
+// timeouts checked by the timer in every 5msec
+PulseCapture CH1_CAP;
+PulseCapture CH3_CAP;
+Ticker PWMIN_WDT;
+const int PWMIN_CHECK_MS = 5;
+//
+void ch1_isr(void) {
+  CH1_CAP.edge(digitalRead(CH1_IN), micros());
+  CH1_USEC = CH1_CAP.dstUsec;
+}
+void ch3_isr(void) {
+  CH3_CAP.edge(digitalRead(CH3_IN), micros());
+  CH3_USEC = CH3_CAP.dstUsec;
+}
+void pwmin_tsr(void) {
+  unsigned long tnow = micros();
+  if (CH1_CAP.expire(tnow)) CH1_USEC = 0;
+  if (CH3_CAP.expire(tnow)) CH3_USEC = 0;
+}
+void pwmin_init(void) {
+  unsigned long tnow = micros();
+  CH1_CAP.init(CH1_IN, PWM_WAIT, tnow);
+  CH3_CAP.init(CH3_IN, PWM_WAIT, tnow);
+  attachInterrupt(CH1_IN, ch1_isr, CHANGE);
+  attachInterrupt(CH3_IN, ch3_isr, CHANGE);
+  PWMIN_WDT.attach_ms(PWMIN_CHECK_MS, pwmin_tsr);
+}
+// number of valid CH1 pulses so far
+unsigned long pwmin_frames(void) {
+  return CH1_CAP.link.frames;
+}
+
+
+//////////////////////////////////////////////////
+// Fixed rate step
+//////////////////////////////////////////////////
+unsigned long CTRL_NEXT = 0;
+int CTRL_COUNT = 0;
+int CTRL_RATE = 0;
+unsigned long CTRL_LAST = 0;
+// true once in every CTRL_USEC (steps behind are skipped, not made up)
+bool ctrl_timing(void) {
+  unsigned long tnow = micros();
+  if ((long)(tnow - CTRL_NEXT) < 0) return false;
+  CTRL_NEXT += CTRL_USEC;
+  if ((long)(tnow - CTRL_NEXT) >= 0) CTRL_NEXT = tnow + CTRL_USEC;
+  // steps per second
+  CTRL_COUNT++;
+  if (tnow - CTRL_LAST >= 1000000) {
+    CTRL_RATE = CTRL_COUNT;
+    CTRL_COUNT = 0;
+    CTRL_LAST = tnow;
+  }
+  return true;
+}
+// wait for the next step
+void ctrl_wait(void) {
+  while (!ctrl_timing()) delayMicroseconds(100);
+}
+
+
 //////////////////////////////////////////////////
 // Zero calibrators
 //////////////////////////////////////////////////
@@ -120,18 +197,22 @@ float OMEGA_ZERO = 0.0;
 float CH1DT_ZERO = 0.0;
 void zero_calibration(void) {
   lcd_header("\nGyroPID\nWAIT INPUT\n");
-  for (int n=0; n<10; n++) {
-    while (pulseIn(CH1_IN,HIGH,PWM_WAIT)==0) vin_watch();
+  unsigned long frames = pwmin_frames();
+  while (pwmin_frames() < frames + 10 || CH1_USEC == 0) {
+    vin_watch();
+    delay(10);
   }
+  lcd_header("\nZERO INPUT\n");
   for (int n=0; n<200; n++) {
-    int ch1 = pulseIn(CH1_IN,HIGH,PWM_WAIT);
+    ctrl_wait();
+    int ch1 = CH1_USEC;
     float omg[3];
     M5.MPU6886.getGyroData(&omg[0],&omg[1],&omg[2]);
     CH1DT_ZERO = lpf_update(CH1DT_LPF, map(ch1, 0,PWM_CYCL, 0,PWM_DMAX));
     OMEGA_ZERO = lpf_update(OMEGA_LPF, omg[2] * M5.MPU6886.gRes);
     //
     if (n%10==0) {
-      lcd_header("\nZERO INPUT\n");
+      lcd_line(2);
       M5.Lcd.printf(" CH1: %7.2f\n",CH1DT_ZERO);
       M5.Lcd.printf(" OMG: %7.2f\n",OMEGA_ZERO);
     }
@@ -169,20 +250,26 @@ void conf_show() {
   M5.Lcd.printf(" KD: %6d\n",CONF[I_KD]);
 }
 // conf ch1 duty range
+// (values redrawn only when changed)
 void conf_range() {
   int ch1,val;
   for (int n=0; n<2; n++) {
+    int shown = -1;
     delay(500);
+    lcd_clear();
+    M5.Lcd.printf("\n%s\n", (n? "LEFT": "RIGHT"));
+    M5.Lcd.printf("[A] SAVE\n");
+    M5.Lcd.printf("[B] CANCEL\n");
     while (true) {
-      ch1 = pulseIn(CH1_IN,HIGH,PWM_WAIT);
+      ch1 = CH1_USEC;
       val = map(ch1, 0,PWM_CYCL, 0,PWM_DMAX);
       ledcWrite(PWM_CH1,(ch1>0? val: 0));
-      lcd_clear();
-      M5.Lcd.printf("\n%s\n", (n? "LEFT": "RIGHT"));
-      M5.Lcd.printf("[A] SAVE\n");
-      M5.Lcd.printf("[B] CANCEL\n");
-      M5.Lcd.printf(" CH1: %6d\n",ch1);
-      M5.Lcd.printf(" VAL: %6d\n",val);
+      if (ch1 != shown) {
+        lcd_line(4);
+        M5.Lcd.printf(" CH1: %6d\n",ch1);
+        M5.Lcd.printf(" VAL: %6d\n",val);
+        shown = ch1;
+      }
       delay(50);
       M5.update();
       if (M5.BtnA.isPressed()) {
@@ -207,20 +294,26 @@ void conf_range() {
   delay(5*1000);  
 }
 // conf gyro gain
-void conf_value(int pin, int pos, char *str) {
+// (values redrawn only when changed)
+void conf_value(volatile int *usec, int pos, char *str) {
   int ch1,val;
   int old = CONF[pos];
+  int shown = -1;
   delay(500);
+  lcd_header(str);
+  M5.Lcd.printf("[A] SAVE\n");
+  M5.Lcd.printf("[B] CANCEL\n");
   // Gain
   while (true) {
-    ch1 = pulseIn(pin,HIGH,PWM_WAIT);
+    ch1 = *usec;
     val = map(ch1, PULSE_MIN,PULSE_MAX, -RANGE_MAX,RANGE_MAX);
-    lcd_header(str);
-    M5.Lcd.printf("[A] SAVE\n");
-    M5.Lcd.printf("[B] CANCEL\n");
-    M5.Lcd.printf(" CH1: %6d\n",ch1);
-    M5.Lcd.printf(" NEW: %6d\n",val);
-    M5.Lcd.printf(" OLD: %6d\n",old);
+    if (ch1 != shown) {
+      lcd_line(4);
+      M5.Lcd.printf(" CH1: %6d\n",ch1);
+      M5.Lcd.printf(" NEW: %6d\n",val);
+      M5.Lcd.printf(" OLD: %6d\n",old);
+      shown = ch1;
+    }
     delay(50);
     M5.update();
     if (M5.BtnA.isPressed()) {
@@ -258,10 +351,10 @@ void conf_menu() {
     M5.update();
     if (M5.BtnA.isPressed()) {
       switch (pos) {
-        case 0: conf_value(CH1_IN,I_KG,"\nPID KG\n"); break;
-        case 1: conf_value(CH1_IN,I_KP,"\nPID KP\n"); break;
-        case 2: conf_value(CH1_IN,I_KI,"\nPID KI\n"); break;
-        case 3: conf_value(CH1_IN,I_KD,"\nPID KD\n"); break;
+        case 0: conf_value(&CH1_USEC,I_KG,"\nPID KG\n"); break;
+        case 1: conf_value(&CH1_USEC,I_KP,"\nPID KP\n"); break;
+        case 2: conf_value(&CH1_USEC,I_KI,"\nPID KI\n"); break;
+        case 3: conf_value(&CH1_USEC,I_KD,"\nPID KD\n"); break;
         case 4: zero_calibration(); break;
         case 5: conf_range(); break;
         default: break;
@@ -279,8 +372,7 @@ void conf_menu() {
 //////////////////////////////////////////////////
 // CH3 mode switcher
 //////////////////////////////////////////////////
-// CH3 PWM width and mode
-int CH3_USEC = 0;
+// CH3 mode (CH3_USEC by interrupts)
 int CH3_MODE = 0;
 //
 void ch3_select() {
@@ -328,6 +420,7 @@ void setup() {
   // (2) Initialize GPIO
   pinMode(CH1_IN,INPUT);
   pinMode(CH3_IN,INPUT);
+  pwmin_init();
   
   pinMode(CH1_OUT,OUTPUT);
   ledcSetup(PWM_CH1,PWM_HERZ,PWM_BITS);
@@ -354,39 +447,87 @@ void setup() {
 //////////////////////////////////////////////////
 // put your main code here, to run repeatedly:
 //////////////////////////////////////////////////
-// PWM widths in usec
-int CH1_USEC = 0;
+// PWM widths in usec (CH1/CH3 by interrupts)
 int CH2_USEC = 0;
 // IMU values
 float OMEGA[3];
 float ACCEL[3];
-// Main loop counter
-int LOOP = 0;
+// Last step for LCD
+int ch1_usec,ch3_usec;
+int ch1_duty,ch1_dout;
+int KG,KP,KI,KD;
+float error;
+bool drift = false;
+// LCD timer and background
+unsigned long LCD_LAST = 0;
+int LCD_BG = -1;
+
+// (5) Update LCD (overwritten in place, cleared only when the background changes)
+void lcd_update() {
+  int bg = (drift? TFT_PINK: TFT_WHITE);
+  if (bg != LCD_BG) {
+    lcd_clear(bg);
+    LCD_BG = bg;
+  }
+  lcd_line(0,bg);
+  M5.Lcd.printf("\nINPUT (us)\n");
+  M5.Lcd.printf(" CH1:%6d\n",ch1_usec);
+  //M5.Lcd.printf(" CH2:%6d\n",CH2_USEC);
+  M5.Lcd.printf(" CH3:%6d\n",ch3_usec);
+  M5.Lcd.printf(" HZ :%6d\n",CTRL_RATE);
+  M5.Lcd.printf("\nOMEGA (rad/s)\n");
+  M5.Lcd.printf("  X:%7.2f\n",OMEGA[0] *M5.MPU6886.gRes);
+  M5.Lcd.printf("  Y:%7.2f\n",OMEGA[1] *M5.MPU6886.gRes);
+  M5.Lcd.printf("  Z:%7.2f\n",OMEGA[2] *M5.MPU6886.gRes);
+  //M5.Lcd.printf("\nACCEL (G)\n");
+  //M5.Lcd.printf("  X:%7.2f\n",ACCEL[0]);
+  //M5.Lcd.printf("  Y:%7.2f\n",ACCEL[1]);
+  //M5.Lcd.printf("  Z:%7.2f\n",ACCEL[2]);
+  M5.Lcd.printf("\nDUTY (16bit)\n");
+  M5.Lcd.printf("   I:%6d\n",ch1_duty);
+  M5.Lcd.printf("   O:%6d\n",ch1_dout);
+  M5.Lcd.printf("   E:%6d\n",int(error));
+  M5.Lcd.printf("\nGAIN (0-100)\n");
+  M5.Lcd.printf(" G/P:%3d/%3d\n",KG,KP);
+  M5.Lcd.printf(" I/D:%3d/%3d\n",KI,KD);
+}
 
 void loop() {
-  int ch1_duty,ch1_dout;
-  int ch3_gain,KG,KP,KI,KD;
-  float omega,error;
-  bool drift = false;
+  int ch3_gain;
+  float omega;
+
+  // (0) Wait for the step (LCD and buttons between steps)
+  if (!ctrl_timing()) {
+    if (millis() - LCD_LAST >= LCD_MSEC && (long)(CTRL_NEXT - micros()) > LCD_USEC) {
+      LCD_LAST = millis();
+      lcd_update();
+      // watch vin and buttons
+      vin_watch();
+      M5.update();
+      if (M5.BtnA.isPressed()) { conf_menu(); LCD_BG = -1; }
+      if (M5.BtnB.isPressed()) { ch3_select(); LCD_BG = -1; }
+    }
+    return;
+  }
   
-  // (1) Input PWM values
-  CH1_USEC = pulseIn(CH1_IN,HIGH,PWM_WAIT);
-  if (LOOP%25 == 0) CH3_USEC = pulseIn(CH3_IN,HIGH,PWM_WAIT);
+  // (1) Input PWM values (latest pulses)
+  ch1_usec = CH1_USEC;
+  ch3_usec = CH3_USEC;
 
   // (2) Input IMU values
   M5.MPU6886.getGyroData(&OMEGA[0],&OMEGA[1],&OMEGA[2]);
-  //if (LOOP%25 == 0) M5.MPU6886.getAccelData(&ACCEL[0],&ACCEL[1],&ACCEL[2]);
+  //M5.MPU6886.getAccelData(&ACCEL[0],&ACCEL[1],&ACCEL[2]);
 
   // (3) Compute PWM value by PID
-  ch1_duty = map(CH1_USEC, 0,PWM_CYCL, 0,PWM_DMAX);
-  ch3_gain = map(CH3_USEC, PULSE_MIN,PULSE_MAX, -RANGE_MAX,RANGE_MAX);
+  ch1_duty = map(ch1_usec, 0,PWM_CYCL, 0,PWM_DMAX);
+  ch3_gain = map(ch3_usec, PULSE_MIN,PULSE_MAX, -RANGE_MAX,RANGE_MAX);
 
   // CH3 mode -> See ch3_select().
   KG = CONF[I_KG];
   KP = CONF[I_KP];
   KI = CONF[I_KI];
   KD = CONF[I_KD];    
-  if (CH3_USEC > 0) {
+  if (ch3_usec > 0) {
     switch (CH3_MODE) {
       case 1: KG = ch3_gain; break;
       case 2: KP = ch3_gain; break;
@@ -407,43 +548,11 @@ void loop() {
   error = (ch1_duty - CH1DT_ZERO) - (KG/0.5)*omega;
   ch1_dout = int(CH1DT_ZERO + (KP/50.0)*(error + (KI/50.0)*lpf_update(CH1ER_LPF,error) + (KD/50.0)*hpf_update(CH1ER_HPF,error)));
   ch1_dout = constrain(ch1_dout, CONF[DMIN],CONF[DMAX]);
-  ch1_dout = (CH1_USEC>0? ch1_dout: 0);
+  ch1_dout = (ch1_usec>0? ch1_dout: 0);
 
   // Drifting?
   drift = omega * (ch1_dout - CH1DT_ZERO) < -500. ? true: false;
 
   // (4) Output PWM value
   ledcWrite(PWM_CH1,ch1_dout);
-  
-  // (5) Update LCD
-  if (LOOP%10 == 0) {
-    lcd_clear(drift? TFT_PINK: TFT_WHITE);
-    M5.Lcd.printf("\nINPUT (us)\n");
-    M5.Lcd.printf(" CH1:%6d\n",CH1_USEC);
-    //M5.Lcd.printf(" CH2:%6d\n",CH2_USEC);
-    M5.Lcd.printf(" CH3:%6d\n",CH3_USEC);
-    M5.Lcd.printf("\nOMEGA (rad/s)\n");
-    M5.Lcd.printf("  X:%7.2f\n",OMEGA[0] *M5.MPU6886.gRes);
-    M5.Lcd.printf("  Y:%7.2f\n",OMEGA[1] *M5.MPU6886.gRes);
-    M5.Lcd.printf("  Z:%7.2f\n",OMEGA[2] *M5.MPU6886.gRes);
-    //M5.Lcd.printf("\nACCEL (G)\n");
-    //M5.Lcd.printf("  X:%7.2f\n",ACCEL[0]);
-    //M5.Lcd.printf("  Y:%7.2f\n",ACCEL[1]);
-    //M5.Lcd.printf("  Z:%7.2f\n",ACCEL[2]);
-    M5.Lcd.printf("\nDUTY (16bit)\n");
-    M5.Lcd.printf("   I:%6d\n",ch1_duty);
-    M5.Lcd.printf("   O:%6d\n",ch1_dout);
-    M5.Lcd.printf("   E:%6d\n",int(error));
-    M5.Lcd.printf("\nGAIN (0-100)\n");
-    M5.Lcd.printf(" G/P:%3d/%3d\n",KG,KP);
-    M5.Lcd.printf(" I/D:%3d/%3d\n",KI,KD);
-    // watch vin and buttons
-    vin_watch();
-    M5.update();
-    if (M5.BtnA.isPressed()) conf_menu();
-    if (M5.BtnB.isPressed()) ch3_select();
-  }
-  
-  // (6) Do others
-  LOOP = (LOOP + 1) % 50;
 }
@@ -4,11 +4,16 @@
 // https://github.com/hshin-git/GyroM5
 ////////////////////////////////////////////////////////////////////////////////
 
+#ifndef GYROM5_BOARD
+#define GYROM5_BOARD BOARD_ATOM
+#endif
+#include <GyroM5Core.hpp>
 #include <WiFi.h>
 #include <WiFiClient.h>
 #include <WebServer.h>
 #include <ESPmDNS.h>
 #include <Preferences.h>
+#include "WebUI.h"
 
 #define DEBUG Serial
 
@@ -19,7 +24,7 @@
 //  load(): パラメータの復元
 //  save(): パラメータの保存
 //  setup(): パラメータの初期化
-//  getJSON(): パラメータのJSON文字列
+//  printJSON(): パラメータのJSON出力（テンプレートの%dを値に置換しながら送る）
 //  setCONF(): パラメータの更新
 ////////////////////////////////////////////////////////////////////////////////
 Preferences CONFIG_PREF;
@@ -45,6 +50,32 @@ public:
   int ROLL;
   int FREQ;
   int AXIS;
+  int SYNC;
+  int RX;
+  int RATE;
+  int EST;
+  int POW;
+  int LED;
+  int SAFE;
+  int TLM;
+  int NOTCH;
+  int AKP;
+  int AKI;
+  int RKP;
+  int RKI;
+  int RKD;
+  int SPD;
+  int SPS;
+  int SPT;
+  int SPG;
+  int FF;
+  int FAIL;
+  int EXPO;
+  int TRIM;
+  int SLEW;
+  int RYAW;
+  int RSLIP;
+  int RCNT;
   int MAGIC;
   //
   void init() {
@@ -60,6 +91,32 @@ public:
     ROLL = 45;
     FREQ = 50;
     AXIS = 1;
+    SYNC = 0;
+    RX = 0;
+    RATE = 0;
+    EST = 0;
+    POW = 0;
+    LED = 0;
+    SAFE = 1;
+    TLM = 0;
+    NOTCH = 1;
+    AKP = 80;
+    AKI = 10;
+    RKP = 40;
+    RKI = 40;
+    RKD = 20;
+    SPD = 0;
+    SPS = 0;
+    SPT = 100;
+    SPG = 50;
+    FF = 0;
+    FAIL = 1;
+    EXPO = 0;
+    TRIM = 0;
+    SLEW = 0;
+    RYAW = 600;
+    RSLIP = 60;
+    RCNT = 0;
     MAGIC = CONFIG_MAGIC;
   }
   void load() {
@@ -80,11 +137,22 @@ public:
       init(); save();
     }
   }
-  char *getJSON() {
-    static char json[1024];
-    sprintf(json, JSON, MODE,KG,KP,KI,KD,REV,MIN,MAX,MEAN,ROLL,FREQ,AXIS);
-    DEBUG.println(json);
-    return json;
+  size_t printJSON(Print& out) {
+    const int VALS[] = {MODE,KG,KP,KI,KD,REV,MIN,MAX,MEAN,ROLL,FREQ,AXIS,SYNC,RX,RATE,EST,POW,LED,SAFE,TLM,NOTCH,AKP,AKI,RKP,RKI,RKD,SPD,SPS,SPT,SPG,FF,FAIL,EXPO,TRIM,SLEW,RYAW,RSLIP,RCNT};
+    const int NVAL = sizeof(VALS)/sizeof(int);
+    size_t len = 0;
+    int n = 0;
+    const char* p = JSON;
+    while (*p) {
+      const char* q = strchr(p,'%');
+      if (q == NULL) q = p + strlen(p);
+      len += out.write((const uint8_t*)p, q-p);
+      if (*q == 0) break;
+      if (q[1] == 'd' && n < NVAL) len += out.print(VALS[n++]);
+      else if (q[1] == '%') len += out.write('%');
+      p = q + 2;
+    }
+    return len;
   }
   void setCONF(const char *key, int val) {
     DEBUG.print(key); DEBUG.print("="); DEBUG.println(val);
@@ -100,34 +168,157 @@ public:
     else if (strcmp(key,"ROLL")==0) ROLL = val;
     else if (strcmp(key,"FREQ")==0) FREQ = val;
     else if (strcmp(key,"AXIS")==0) AXIS = val;
+    else if (strcmp(key,"SYNC")==0) SYNC = val;
+    else if (strcmp(key,"RX")==0) RX = val;
+    else if (strcmp(key,"RATE")==0) RATE = val;
+    else if (strcmp(key,"EST")==0) EST = val;
+    else if (strcmp(key,"POW")==0) POW = val;
+    else if (strcmp(key,"LED")==0) LED = val;
+    else if (strcmp(key,"SAFE")==0) SAFE = val;
+    else if (strcmp(key,"TLM")==0) TLM = val;
+    else if (strcmp(key,"NOTCH")==0) NOTCH = val;
+    else if (strcmp(key,"AKP")==0) AKP = val;
+    else if (strcmp(key,"AKI")==0) AKI = val;
+    else if (strcmp(key,"RKP")==0) RKP = val;
+    else if (strcmp(key,"RKI")==0) RKI = val;
+    else if (strcmp(key,"RKD")==0) RKD = val;
+    else if (strcmp(key,"SPD")==0) SPD = val;
+    else if (strcmp(key,"SPS")==0) SPS = val;
+    else if (strcmp(key,"SPT")==0) SPT = val;
+    else if (strcmp(key,"SPG")==0) SPG = val;
+    else if (strcmp(key,"FF")==0) FF = val;
+    else if (strcmp(key,"FAIL")==0) FAIL = val;
+    else if (strcmp(key,"EXPO")==0) EXPO = val;
+    else if (strcmp(key,"TRIM")==0) TRIM = val;
+    else if (strcmp(key,"SLEW")==0) SLEW = val;
+    else if (strcmp(key,"RYAW")==0) RYAW = val;
+    else if (strcmp(key,"RSLIP")==0) RSLIP = val;
+    else if (strcmp(key,"RCNT")==0) RCNT = val;
   }
   //
 };
-const char CONFIG::JSON[] = R"(
-{
-'MODE':[0,1,1,%d,'drift,stunt',0],
-'KG':[0,100,1,%d,'%%',0],
-'KP':[0,100,1,%d,'%%',0],
-'KI':[0,100,1,%d,'%%',0],
-'KD':[0,100,1,%d,'%%',0],
-'REV':[0,1,1,%d,'bool',0],
-'MIN':[1000,2000,1,%d,'usec',1],
-'MAX':[1000,2000,1,%d,'usec',1],
-'MEAN':[1000,2000,1,%d,'usec',1],
-'ROLL':[0,90,1,%d,'deg',1],
-'FREQ':[50,400,50,%d,'Hz',0],
-'AXIS':[1,6,1,%d,'1-6',0],
-'CH1_FREQ':[0,400,1,50,'Hz',2],
-'CH1_USEC':[1000,2000,1,1500,'usec',2],
-'IMU_PITCH':[-90,90,1,0,'deg',2],
-'IMU_ROLL':[-90,90,1,0,'deg',2],
-'IMU_RATE':[-360,360,1,0,'deg/sec',2],
-'PID_LOOP':[0,500,1,50,'Hz',2],
-'PID_USEC':[1000,2000,1,1500,'usec',2],
-}
-)";
+const char CONFIG::JSON[] = R"({
+"MODE":[0,1,1,%d,"drift,stunt",0],
+"KG":[0,100,1,%d,"%%",0],
+"KP":[0,100,1,%d,"%%",0],
+"KI":[0,100,1,%d,"%%",0],
+"KD":[0,100,1,%d,"%%",0],
+"REV":[0,1,1,%d,"bool",0],
+"MIN":[1000,2000,1,%d,"usec",1],
+"MAX":[1000,2000,1,%d,"usec",1],
+"MEAN":[1000,2000,1,%d,"usec",1],
+"ROLL":[0,90,1,%d,"deg",1],
+"FREQ":[50,400,50,%d,"Hz",0],
+"AXIS":[1,6,1,%d,"1-6",0],
+"SYNC":[0,1,1,%d,"free,edge",0],
+"RX":[0,3,1,%d,"pwm,sbus,ibus,crsf",0],
+"RATE":[0,1,1,%d,"manual,auto",0],
+"EST":[0,1,1,%d,"mahony,ekf",0],
+"POW":[0,2,1,%d,"fixed,auto,sleep",0],
+"LED":[0,3,1,%d,"blink,steer,rate,drift",0],
+"SAFE":[0,2,1,%d,"hold,pass,neutral",0],
+"TLM":[0,1,1,%d,"off,udp",0],
+"NOTCH":[0,2,1,%d,"off,watch,auto",0],
+"AKP":[0,100,1,%d,"%%",0],
+"AKI":[0,100,1,%d,"%%",0],
+"RKP":[0,100,1,%d,"%%",0],
+"RKI":[0,100,1,%d,"%%",0],
+"RKD":[0,100,1,%d,"%%",0],
+"SPD":[0,100,1,%d,"msec",0],
+"SPS":[0,50,1,%d,"usec/msec",0],
+"SPT":[0,500,10,%d,"msec",0],
+"SPG":[0,200,1,%d,"0.01deg/sec/usec",0],
+"FF":[0,100,1,%d,"%%",0],
+"FAIL":[0,2,1,%d,"hold,pass,neutral",0],
+"EXPO":[0,100,1,%d,"%%",0],
+"TRIM":[-100,100,1,%d,"usec",0],
+"SLEW":[0,50,1,%d,"usec/msec",0],
+"RYAW":[0,1000,10,%d,"deg/sec",0],
+"RSLIP":[0,90,1,%d,"deg",0],
+"RCNT":[0,500,10,%d,"usec",0],
+"CH1_FREQ":[0,400,1,50,"Hz",2],
+"CH1_USEC":[1000,2000,1,1500,"usec",2],
+"IMU_PITCH":[-90,90,1,0,"deg",2],
+"IMU_ROLL":[-90,90,1,0,"deg",2],
+"IMU_RATE":[-360,360,1,0,"deg/sec",2],
+"PID_LOOP":[0,500,1,50,"Hz",2],
+"PID_USEC":[1000,2000,1,1500,"usec",2],
+"PID_PHASE":[0,20000,1,0,"usec",2],
+"PID_DELAY":[0,20000,1,0,"usec",2],
+"CH1_JITTER":[0,5000,1,0,"usec",2],
+"PWM_FREQ":[0,400,1,50,"Hz",2],
+"IMU_SLIP":[-90,90,1,0,"deg",2],
+"EST_USEC":[0,2500,1,0,"usec",2],
+"POW_MHZ":[80,240,1,240,"MHz",2],
+"POW_LOAD":[0,100,1,0,"%%",2],
+"POW_MARGIN":[0,20000,1,0,"usec",2],
+"POW_MA":[0,200,1,0,"mA",2],
+"WDG_MISS":[0,100000,1,0,"ticks",2],
+"WDG_WORST":[0,1000000,1,0,"usec",2],
+"TLM_PKTS":[0,1000,1,0,"1/sec",2],
+"TLM_DROP":[0,100000,1,0,"samples",2],
+"TLM_USEC":[0,100000,1,0,"usec",2],
+"VIB_HZ":[0,500,1,0,"Hz",2],
+"VIB_AMP":[0,1000,1,0,"deg/sec",2],
+"NOTCH_HZ1":[0,500,1,0,"Hz",2],
+"NOTCH_HZ2":[0,500,1,0,"Hz",2],
+"FFT_USEC":[0,100000,1,0,"usec",2],
+"ROLL_RATE":[-360,360,1,0,"deg/sec",2],
+"LINK_GLITCH":[0,100000,1,0,"pulses",2],
+"LINK_DROP":[0,100000,1,0,"times",2],
+"LINK_GAP":[0,1000000,1,0,"usec",2],
+"SYS_HEAP":[0,400000,1,0,"bytes",2],
+"SYS_BLOCK":[0,400000,1,0,"bytes",2],
+"SYS_DRIFT":[-100000,100000,1,0,"bytes",2],
+"SYS_STACK":[0,10000,1,0,"bytes",2],
+"CPU0_LOAD":[0,100,1,0,"%%",2],
+"CPU1_LOAD":[0,100,1,0,"%%",2],
+"REC_CAPS":[0,1000,1,0,"times",2]
+})";
+
 
 
+////////////////////////////////////////////////////////////////////////////////
+// class WebStream{}: WebServerへの逐次送信（chunked転送、スタック上の小バッファのみ）
+//  begin(): 応答ヘッダの送信（長さ不定）
+//  write(): バッファへ追加（一杯になったら送信）
+//  end(): 残りの送信と終端
+////////////////////////////////////////////////////////////////////////////////
+class WebStream : public Print {
+  WebServer& server;
+  uint8_t buff[256];
+  size_t size;
+public:
+  WebStream(WebServer& s) : server(s), size(0) {}
+  //
+  void begin(const char* type) {
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, type, "");
+  }
+  size_t write(uint8_t c) {
+    if (size >= sizeof(buff)) flush();
+    buff[size++] = c;
+    return 1;
+  }
+  size_t write(const uint8_t* p, size_t n) {
+    for (size_t k = 0; k < n; ) {
+      if (size >= sizeof(buff)) flush();
+      size_t m = min(n - k, sizeof(buff) - size);
+      memcpy(buff + size, p + k, m);
+      size += m; k += m;
+    }
+    return n;
+  }
+  void flush() {
+    if (size > 0) server.sendContent((const char*)buff, size);
+    size = 0;
+  }
+  void end() {
+    flush();
+    server.sendContent("");
+  }
+};
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // class SERVER{}: WiFi/WWWサーバの管理クラス
@@ -137,53 +328,91 @@ const char CONFIG::JSON[] = R"(
 //  stop(): サーバの停止
 //  isWake(): サーバの起動有無
 //  lookFloat(): Ajax監視対象の登録
+//  lookJson(): JSONを返すURIの追加（出力関数を登録、例 /api/spectrum、CSVなどは形式も指定）
+//
+//  設定画面はgzip圧縮済みの WebUI.h をそのまま送る（ETagが一致すれば304）
+//  設定値は /api/config、監視値は /json でJSONを逐次送信（固定長バッファなし）
+//  自前の処理ではヒープを使わない（URIごとに固定の関数、ヘッダは番号で参照、
+//  キーと値は短くStringの内部バッファに収まる、printfは64文字未満）
 ////////////////////////////////////////////////////////////////////////////////
 class SERVER {
+  friend class GyroM5Bench; // tools/bench_atom.hpp
   //
-  static const char _SSID_[];
+  static const char* _SSID_;
   static WebServer server;
   static bool serverInit;
   static bool serverWake;
   //
-  static const char HTML_INIT[];
-  static const char HTML_SAVE[];
-  static char CHAR_BUFF[];
+  static const char* HEADERS[];
   //
-  #define LOOK_MAX  8
+  #define LOOK_MAX  48
   static int LOOK_INDEX;
   static char* LOOK_KEY[];
   static float* LOOK_PTR[];
   //
+  #define JSON_MAX  6
+  static int JSON_INDEX;
+  static const char* JSON_URI[];
+  static const char* JSON_TYPE[];
+  static size_t (*JSON_FUNC[])(Print&);
+  //
+  static void sendPage(const uint8_t* gz, size_t len, const char* etag) {
+    server.sendHeader("ETag", etag);
+    server.sendHeader("Cache-Control", "no-cache");
+    // HEADERS[0] by index (no String of the name)
+    if (server.header(0) == etag) {
+      server.send(304);
+      return;
+    }
+    server.sendHeader("Content-Encoding", "gzip");
+    server.send_P(200, "text/html", (const char*)gz, len);
+  }
+  static void setArgs() {
+    char key[16];
+    for (int n = 0; n < server.args(); n++) {
+      server.argName(n).toCharArray(key, sizeof(key));
+      CONF.setCONF(key, server.arg(n).toInt());
+    }
+    CONF.save();
+  }
   static void handleRoot() { 
-    sprintf(CHAR_BUFF, HTML_INIT, CONF.getJSON());
-    server.send(200, "text/html", CHAR_BUFF); 
-    //DEBUG.println(CHAR_BUFF);
+    sendPage(WEBUI_INDEX, WEBUI_INDEX_LEN, WEBUI_INDEX_ETAG);
   }
   static void handleSave() {
-    for (int n = 0; n < server.args(); n++) CONF.setCONF(server.argName(n).c_str(),server.arg(n).toInt());
-    CONF.save();
-    sprintf(CHAR_BUFF, HTML_SAVE, CONF.getJSON());
-    server.send(200, "text/html", CHAR_BUFF);
+    const char* tag = Supervisor::cause("save");
+    setArgs();
+    sendPage(WEBUI_SAVE, WEBUI_SAVE_LEN, WEBUI_SAVE_ETAG);
     delay(500); stop();
-    //DEBUG.println(CHAR_BUFF);
+    Supervisor::cause(tag);
   }
   static void handleSaveOnly() {
-    for (int n = 0; n < server.args(); n++) CONF.setCONF(server.argName(n).c_str(),server.arg(n).toInt());
-    CONF.save();
-    sprintf(CHAR_BUFF, HTML_INIT, CONF.getJSON());
-    server.send(200, "text/html", CHAR_BUFF);
+    setArgs();
+    sendPage(WEBUI_INDEX, WEBUI_INDEX_LEN, WEBUI_INDEX_ETAG);
     //delay(500); stop();
-    //DEBUG.println(CHAR_BUFF);
+  }
+  static void handleConfig() {
+    WebStream out(server);
+    out.begin("application/json");
+    CONF.printJSON(out);
+    out.end();
   }
   static void handleJson() {
-    char* p = CHAR_BUFF;
-    p = p + sprintf(p, "{");
+    WebStream out(server);
+    out.begin("application/json");
+    out.print("{");
     for (int n = 0; n < LOOK_INDEX; n++) {
-      p = p + sprintf(p,"\"%s\":%.f,", LOOK_KEY[n],*LOOK_PTR[n]);
+      out.printf("%s\"%s\":%.f", (n? ",": ""), LOOK_KEY[n],*LOOK_PTR[n]);
     }
-    sprintf(--p, "}");
-    server.send(200, "application/json", CHAR_BUFF);
-    //DEBUG.println(CHAR_BUFF);
+    out.print("}");
+    out.end();
+  }
+  // one handler per registered URI (no String compare of the URI)
+  template <int N>
+  static void handleLook() {
+    WebStream out(server);
+    out.begin(JSON_TYPE[N]);
+    JSON_FUNC[N](out);
+    out.end();
   }
   static void handleNotFound() {
     server.send(404, "text/plain", "Not Found.");
@@ -198,6 +427,7 @@ public:
   }
   //
   static void start(void) {
+    const char* tag = Supervisor::cause("wifi");
   
     DEBUG.println("Setup WIFI AP mode");
     WiFi.mode(WIFI_AP);
@@ -219,14 +449,19 @@ public:
     if (!serverInit) {
       server.on("/", HTTP_GET, handleRoot);
       server.on("/json", HTTP_GET, handleJson);
+      server.on("/api/config", HTTP_GET, handleConfig);
       server.on("/save", HTTP_GET, handleSave);
+      static void (*const LOOK[JSON_MAX])(void) = {handleLook<0>, handleLook<1>, handleLook<2>, handleLook<3>, handleLook<4>, handleLook<5>};
+      for (int n = 0; n < JSON_INDEX; n++) server.on(JSON_URI[n], HTTP_GET, LOOK[n]);
       server.onNotFound(handleNotFound);
+      server.collectHeaders(HEADERS, 1);
       server.begin();
       DEBUG.println("HTTP server started");
       serverInit = true;
     }
   
     serverWake = true;
+    Supervisor::cause(tag);
   }
   static void loop(void) {
     if (serverWake) server.handleClient();
@@ -253,10 +488,18 @@ public:
       LOOK_INDEX++;
     }
   }
+  static void lookJson(const char *uri, size_t (*func)(Print&), const char *type = "application/json") {
+    if (JSON_INDEX < JSON_MAX) {
+      JSON_URI[JSON_INDEX] = uri;
+      JSON_TYPE[JSON_INDEX] = type;
+      JSON_FUNC[JSON_INDEX] = func;
+      JSON_INDEX++;
+    }
+  }
   //
 };
 //
-const char SERVER::_SSID_[] = "m5atom";
+const char* SERVER::_SSID_ = Board::SSID;
 WebServer SERVER::server(80);
 bool SERVER::serverInit = false;
 bool SERVER::serverWake = false;
@@ -265,177 +508,13 @@ int SERVER::LOOK_INDEX = 0;
 char* SERVER::LOOK_KEY[LOOK_MAX];
 float* SERVER::LOOK_PTR[LOOK_MAX];
 //
-CONFIG SERVER::CONF;
-char SERVER::CHAR_BUFF[5000];
-//
-const char SERVER::HTML_INIT[] = R"(
-<!DOCTYPE HTML>
-<html>
-<head>
-<meta name='viewport' content='width=device-width,initial-scale=1' />
-<title>GyroM5Atom</title>
-</head>
-<body>
-<p id='ajax_link'><b> GyroM5Atom Parameters </b></p>
-<form action='save' method='get' name='setting'>
-<table>
-<thead><tr><th>select</th><th>name</th><th>value</th><th>slider</th><th>unit</th></tr></thead>
-<tbody></tbody>
-</table>
-<br>
-<input type='hidden' name='JST' value='20220630103030' />
-<input type='button' value='MIN/MAX/MEAN <- CH1' onclick='onMinMax()' />
-<input type='button' value='ROLL <- IMU' onclick='onRoll()' />
-<br>
-<input type='submit' value='M5Atom <- Parameters' onclick='onSubmit()' />
-</form>
-</body>
-<script>
-const CONFIG = %s;
-//
-function onLoad() {
- //for (let key in CONFIG){ document.getElementsByName(key)[0].value = document.getElementById(key).textContent  = CONFIG[key]; } 
- let tbody = document.getElementsByTagName('tbody')[0];
- for (let key in CONFIG) {
-  let spec = CONFIG[key];
-  let row = document.createElement('tr');
-  // radio
-  let c0 = document.createElement('td');
-  let i0 = document.createElement('input'); i0.type = 'radio'; i0.name = 'select'; i0.value = key; i0.checked = false;
-  if (!spec[5]) i0.onchange = function() { onChange(i0); }; else i0.disabled = true;
-  c0.appendChild(i0);
-  // name
-  let c1 = document.createElement('td');
-  c1.appendChild(document.createTextNode(key));
-  // value
-  let c2 = document.createElement('td');
-  let s2 = document.createElement('span'); s2.id = key; s2.textContent = spec[3];
-  c2.appendChild(s2);
-  // range
-  let c3 = document.createElement('td');
-  let i3 = document.createElement('input'); i3.type = 'range'; i3.name = key; i3.min = spec[0]; i3.max = spec[1]; i3.step = spec[2]; i3.value = spec[3]; i3.disabled = true;
-  if (!spec[5]) i3.oninput = function(){ onInput(i3); };
-  c3.appendChild(i3);
-  // description
-  let c4 = document.createElement('td');
-  c4.appendChild(document.createTextNode(spec[4]));
-  //
-  row.appendChild(c0); row.appendChild(c1); row.appendChild(c2); row.appendChild(c3); row.appendChild(c4);
-  tbody.appendChild(row);
- }
-}
-//
-function onInput(range) {
- if (range.name in CONFIG) document.getElementById(range.name).textContent = range.value;
-}
-//
-function doAssign(key,val) {
- if (key in CONFIG) document.getElementsByName(key)[0].value = document.getElementById(key).textContent  = val; 
-}
-//
-function setAjaxLink(col) {
-  document.getElementById('ajax_link').style.backgroundColor = col;
-}
-//
-function onChange(radio) {
- for (let key in CONFIG) {
-  let range = document.getElementsByName(key)[0];
-  let spec = CONFIG[key];
-  if (key == radio.value & !spec[5]) { 
-   range.disabled = false;
-  } else {
-   range.disabled = true;
-  }
- }
-}
-//
-function onMinMax() {
-  let usec = document.getElementById('CH1_USEC').textContent;
-  if (usec <= 0) return;
-  else if (usec < 1500-250) doAssign('MIN',usec);
-  else if (usec > 1500+250) doAssign('MAX',usec);
-  else doAssign('MEAN',usec);
-}
-//
-function onRoll() {
-  let roll = document.getElementById('IMU_ROLL').textContent;
-  if (Math.abs(roll) < 30) return;
-  else doAssign('ROLL',Math.abs(roll));
-}
-//
-function onSubmit() {
- const D2 = function(s) { return ('0'+s).slice(-2); };
- let now = new Date();
- document.getElementsByName('JST')[0].value = now.getFullYear() + D2(now.getMonth()+1) + D2(now.getDate()) + D2(now.getHours()) + D2(now.getMinutes()) + D2(now.getSeconds());
- for (let key in CONFIG) document.getElementsByName(key)[0].disabled = false;
-}
-//
-const SECOND = 1000;
-//
-function startAjax() {
- var xhr = new XMLHttpRequest();
- xhr.open('GET','/json');
- xhr.setRequestHeader('Content-Type','application/json');
- xhr.onload = function() {
-  let json = JSON.parse(xhr.response);
-  for (let key in json) doAssign(key,json[key]);
-  setTimeout(startAjax,SECOND/2);
-  setAjaxLink('lime');
- }
- xhr.ontimeout = function() {
-   setTimeout(startAjax,2*SECOND);
-   setAjaxLink('red');
- }
- xhr.onerror = function() {
-   setTimeout(startAjax,2*SECOND);
-   setAjaxLink('red');
- }
- xhr.timeout = SECOND;
- xhr.send();
-}
-//
-window.onload = onLoad();
-startAjax();
-</script>
-</html>
-)";
-
-
-const char SERVER::HTML_SAVE[] = R"(
-<!DOCTYPE HTML>
-<html>
-<head>
-<meta name='viewport' content='width=device-width,initial-scale=1' />
-<title>GyroM5Atom</title>
-</head>
-<body>
-<h1>GyroM5Atom</h1>
-parameters:
-<ul>
-</ul>
-successfully saved!
-</body>
-<script>
-const CONFIG = %s;
-//
-function onLoad() {
- let ul = document.getElementsByTagName('ul')[0];
- for (let key in CONFIG) {
-  let spec = CONFIG[key];
-  if (spec[5] < 2) {
-   // list
-   let li = document.createElement('li');
-   li.innerHTML = key + ' = ' + spec[3] + ' ( ' + spec[4] + ' )';
-   ul.appendChild(li);
-  }
- }
-}
+int SERVER::JSON_INDEX = 0;
+const char* SERVER::JSON_URI[JSON_MAX];
+const char* SERVER::JSON_TYPE[JSON_MAX];
+size_t (*SERVER::JSON_FUNC[JSON_MAX])(Print&);
 //
-window.onload = onLoad();
-</script>
-</html>
-)";
-
+CONFIG SERVER::CONF;
+const char* SERVER::HEADERS[] = {"If-None-Match"};
 
 
 
@@ -518,31 +597,30 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 // class PulsePort{}: PWM信号の入出力ライブラリ
 //  setupIn(): 入力ピンの初期化
+//  setWindow(): 正常な入力パルス幅の範囲[usec]（外は雑音として捨てる）
 //  getUsec(): 入力パルス幅[usec]
 //  getFreq(): 入力パルス周波数[Hz]
+//  getLink(): 入力のリンク品質（雑音、途絶、フレーム間隔）
 //  setupMean(): 入力パルス平均
 //  getUsecMean(): 入力パスル平均[usec]
 //  attach(): 割り込み処理の再開
 //  detach(): 割り込み処理の中止
 //  setupOut(): 出力ピンの初期化
-//  putUsec(): 出力パルス幅[usec]
-//  putFreq(): 出力パルス周波数[Hz]
+//  setShape(): 出力の曲線（エンド、中立、サブトリム、エキスポ、速度制限、引数なしは素通し）
+//  putUsec(): 出力パルス幅[usec]（曲線の表からデューティ、制御と縮退出力で排他）
+//  putFreq(): 出力パルス周波数[Hz]（曲線の表も作り直し）
+//  getDuty(): 最後に出力したデューティ
+//  notify(): 立下りエッジでのタスク通知
+//  getFall(): 入力パルス立下り時刻[usec]
+//  getPhase(): 入力立下りから出力立上りまでの遅れ[usec]
+//  lockPhase(): 出力周期の位相合わせ（直後に出力立上り）
 ////////////////////////////////////////////////////////////////////////////////
 // PWM watch dog timer
 #include <Ticker.h>
+#include <driver/ledc.h>
 
-// PWM pulse in
-typedef struct {
-  int pin;
-  int tout;
-  // for pulse
-  int dstUsec;
-  int prev;
-  unsigned long last;
-  // for freq
-  int dstFreq;
-  unsigned long lastFreq;
-} InPulse;
+// PWM pulse in (edge handling in GyroM5Core.hpp)
+typedef PulseCapture InPulse;
 
 // PWM pulse out
 typedef struct {
@@ -552,10 +630,14 @@ typedef struct {
   int duty;
   int usec;
   int dstUsec;
+  unsigned long origin;
+  OutputShaper shape; // usec to duty (GyroM5Core.hpp)
 } OutPulse;
 
 class PulsePort {
+  friend class GyroM5Bench; // tools/bench_atom.hpp
   static const int MAX = 4; // max of channels 
+  static const int CHECK_MS = 5; // timeouts of channels checked by WDT
 
   static int InCH;   // number of in-channels
   static int OutCH;   // number of out-channels
@@ -566,39 +648,31 @@ class PulsePort {
   static Ticker WDT;      // watch dog timer
   static bool WATCHING;
   static float MEAN[MAX]; // mean of pwm in-pulse
+
+  static TaskHandle_t NOTIFY; // task notified at down edge
+  static int NOTIFY_CH;
+
+  static portMUX_TYPE OUT_MUX; // control and Supervisor fallback write the same shaper
   
   static void ISR(void *arg) {
     unsigned long tnow = micros();
-    int ch = (int)arg;
+    int ch = (int)(intptr_t)arg;
     InPulse* pwm = &IN[ch];
     int vnow = digitalRead(pwm->pin);
     
-    if (pwm->prev==0 && vnow==1) {
-      // at up edge
-      pwm->prev = 1;
-      pwm->last = tnow;
-      // for freq
-      pwm->dstFreq = (tnow > pwm->lastFreq? 1000000/(tnow - pwm->lastFreq): 0);
-      pwm->lastFreq = tnow;
-    }
-    else
-    if (pwm->prev==1 && vnow==0) {
-      // at down edge
-      pwm->dstUsec = tnow - pwm->last;
-      pwm->prev = 0;
-      pwm->last = tnow;
+    if (pwm->edge(vnow, tnow)) {
+      // for event-driven control
+      if (ch == NOTIFY_CH && NOTIFY) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(NOTIFY,&woken);
+        if (woken) portYIELD_FROM_ISR();
+      }
     }
   }
 
   static void TSR(void) {
     unsigned long tnow = micros();
-    for (int ch=0; ch<InCH; ch++) {
-      InPulse* pwm = &IN[ch];
-      if (pwm->last + pwm->tout < tnow) {
-        pwm->dstUsec = 0;
-        pwm->dstFreq = 0;
-      }
-    }
+    for (int ch=0; ch<InCH; ch++) IN[ch].expire(tnow);
   }
 
 public: 
@@ -610,20 +684,11 @@ public:
     if (InCH < MAX) {
       ch = InCH++;
       InPulse* pwm = &IN[ch];
-      //
-      pwm->pin = pin;
-      pwm->tout = toutUs;
-      // for pulse
-      pwm->dstUsec = 0;
-      pwm->prev = 0;
-      pwm->last = micros();
-      // for freq
-      pwm->dstFreq = 0;
-      pwm->lastFreq = micros();
+      pwm->init(pin, toutUs, micros());
       //
       pinMode(pin,INPUT);
-      attachInterruptArg(pin,&ISR,(void*)ch,CHANGE);
-      if (ch == 0) WDT.attach_ms(pwm->tout/1000,&TSR);
+      attachInterruptArg(pin,&ISR,(void*)(intptr_t)ch,CHANGE);
+      if (ch == 0) WDT.attach_ms(CHECK_MS,&TSR);
       WATCHING = true;
     }
     return ch;
@@ -638,10 +703,28 @@ public:
   static int getFreq(int ch) {
     if (ch >= 0 && ch < InCH) {
       InPulse* pwm = &IN[ch];
-      return pwm->dstFreq;
+      return pwm->getFreq();
     }
     return -1;
   }
+  static void setWindow(int ch, int minUs, int maxUs) {
+    if (ch >= 0 && ch < InCH) IN[ch].setWindow(minUs, maxUs);
+  }
+  static LinkHealth& getLink(int ch) {
+    return IN[(ch >= 0 && ch < InCH)? ch: 0].link;
+  }
+  static unsigned long getFall(int ch) {
+    if (ch >= 0 && ch < InCH) {
+      InPulse* pwm = &IN[ch];
+      return pwm->lastFall;
+    }
+    return 0;
+  }
+  static void notify(int ch, TaskHandle_t task) {
+    NOTIFY = NULL;
+    NOTIFY_CH = ch;
+    NOTIFY = task;
+  }
   
   static void detach(void) {
     if (InCH == 0) return;
@@ -656,8 +739,8 @@ public:
     if (InCH == 0 || WATCHING) return;
     for (int ch=0; ch<InCH; ch++) {
       InPulse *pwm = &IN[ch];
-      attachInterruptArg(pwm->pin,&ISR,(void*)ch,CHANGE);
-      if (ch == 0) WDT.attach_ms(pwm->tout/1000,&TSR);
+      attachInterruptArg(pwm->pin,&ISR,(void*)(intptr_t)ch,CHANGE);
+      if (ch == 0) WDT.attach_ms(CHECK_MS,&TSR);
     }
     WATCHING = true;
   };
@@ -675,9 +758,11 @@ public:
       out->bits = bits;
       out->duty = (1 << bits);
       out->usec = 1000000/freq;
+      out->shape.build(out->usec,out->bits);
       //
       pinMode(out->pin,OUTPUT);
       ledcSetup(CH2PWM(ch),out->freq,out->bits);
+      out->origin = micros();
       ledcWrite(CH2PWM(ch),0);
       ledcAttachPin(out->pin,CH2PWM(ch));
       //DEBUG.printf("setupOut: ch=%d freq=%d bits=%d usec=%d\n",ch,out->freq,out->bits,out->usec);
@@ -687,25 +772,57 @@ public:
   static float mapFloat(float x, float in_min, float in_max, float out_min, float out_max) {
     return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
   }
+  static bool setShape(int ch, int minUs, int midUs, int maxUs, int trimUs = 0, int expo = 0, int slew = 0) {
+    if (ch >= 0 && ch < OutCH) {
+      OutPulse* out = &OUT[ch];
+      portENTER_CRITICAL(&OUT_MUX);
+      out->shape.setup(minUs, midUs, maxUs, trimUs, expo, slew);
+      out->shape.build(out->usec,out->bits);
+      portEXIT_CRITICAL(&OUT_MUX);
+      return true;
+    }
+    return false;
+  }
+  static bool setShape(int ch) {
+    if (ch >= 0 && ch < OutCH) {
+      OutPulse* out = &OUT[ch];
+      portENTER_CRITICAL(&OUT_MUX);
+      out->shape.open();
+      out->shape.build(out->usec,out->bits);
+      portEXIT_CRITICAL(&OUT_MUX);
+      return true;
+    }
+    return false;
+  }
   static bool putUsec(int ch, float usec) {
     if (ch >= 0 && ch < OutCH) {
       OutPulse* out = &OUT[ch];
-      int duty = mapFloat(usec, 0,out->usec, 0,out->duty);
-      ledcWrite(CH2PWM(ch), duty);
-      out->dstUsec = usec;
+      // the only writer of the out-pulse (control and Supervisor fallback)
+      portENTER_CRITICAL(&OUT_MUX);
+      ledcWrite(CH2PWM(ch), out->shape.duty(usec, micros()));
+      out->dstUsec = out->shape.getUsec();
+      portEXIT_CRITICAL(&OUT_MUX);
       return true;
     }
     return false;
   }
+  static int getDuty(int ch) {
+    if (ch >= 0 && ch < OutCH) return OUT[ch].shape.lastDuty;
+    return -1;
+  }
   static bool putFreq(int ch, int freq) {
     if (ch >= 0 && ch < OutCH) {
       OutPulse* out = &OUT[ch];
       out->freq = freq;
       out->usec = 1000000/freq;
+      portENTER_CRITICAL(&OUT_MUX);
+      out->shape.build(out->usec,out->bits);
+      portEXIT_CRITICAL(&OUT_MUX);
       //
       ledcWrite(CH2PWM(ch),0);
       ledcDetachPin(out->pin);
       ledcSetup(CH2PWM(ch),out->freq,out->bits);
+      out->origin = micros();
       ledcWrite(CH2PWM(ch),0);
       ledcAttachPin(out->pin,CH2PWM(ch));
       //DEBUG.printf("putFreq: ch=%d freq=%d bits=%d usec=%d\n",ch,out->freq,out->bits,out->usec);
@@ -713,6 +830,34 @@ public:
     }
     return false;
   }
+  // LEDC timer starts at ledcSetup(), so out-pulse rises at origin + n*usec.
+  // A duty written now is applied from the next rising edge.
+  static int getPhaseAt(int out, unsigned long tfall) {
+    if (out >= 0 && out < OutCH) {
+      OutPulse* pwm = &OUT[out];
+      unsigned long t = tfall - pwm->origin;
+      return pwm->usec - (int)(t % pwm->usec);
+    }
+    return -1;
+  }
+  static int getPhase(int in, int out) {
+    if (in >= 0 && in < InCH) return getPhaseAt(out, IN[in].lastFall);
+    return -1;
+  }
+  // Restart LEDC timer so that out-pulse rises now with the duty just written.
+  // Skipped while out-pulse is high (it would be stretched) or already aligned.
+  static bool lockPhase(int ch, int tolUs = 200) {
+    if (ch >= 0 && ch < OutCH) {
+      OutPulse* out = &OUT[ch];
+      int since = (int)((micros() - out->origin) % out->usec);
+      if (since <= out->dstUsec + tolUs || out->usec - since <= tolUs) return false;
+      int pwm = CH2PWM(ch);
+      ledc_timer_rst((ledc_mode_t)(pwm/8), (ledc_timer_t)((pwm/2)%4));
+      out->origin = micros();
+      return true;
+    }
+    return false;
+  }
 
   static void setupMean(bool first = false, int msec = 1000) {
     if (first) {
@@ -741,7 +886,7 @@ public:
   static void dump(void) {
     for (int ch=0; ch<InCH; ch++) {
       InPulse* pwm = &IN[ch];
-      DEBUG.printf(" in(%d): pin=%2d pulse=%6d (usec) freq=%4d (Hz)\n", ch,pwm->pin,pwm->dstUsec,pwm->dstFreq);
+      DEBUG.printf(" in(%d): pin=%2d pulse=%6d (usec) freq=%4d (Hz)\n", ch,pwm->pin,pwm->dstUsec,pwm->getFreq());
     }
     for (int ch=0; ch<OutCH; ch++) {
       OutPulse* out = &OUT[ch];
@@ -762,80 +907,421 @@ Ticker PulsePort::WDT;
 bool PulsePort::WATCHING = false;
 float PulsePort::MEAN[PulsePort::MAX];
 
+TaskHandle_t PulsePort::NOTIFY = NULL;
+int PulsePort::NOTIFY_CH = -1;
+portMUX_TYPE PulsePort::OUT_MUX = portMUX_INITIALIZER_UNLOCKED;
+
 
 
 ////////////////////////////////////////////////////////////////////////////////
-// class ServoPID{}: PID（比例、積分、微分）制御アルゴリズム（QuickPIDのラッパ）
-//  setup(): PID制御のパラメータ変更
-//  loop(): PID制御の出力計算
+// class SerialRx{}: シリアル受信機（SBUS/iBUS/CRSF）の入力ライブラリ
+//  PulsePortと同じ要領で全チャネルを参照できる（1ピンで最大16チャネル）
+//  setup(): UARTの初期化（無通信検出でフレームを区切る）
+//  getUsec(): 入力パルス幅[usec]
+//  getFreq(): 入力フレーム周波数[Hz]
+//  getFall(): 入力フレーム完成時刻[usec]
+//  getLink(): 入力のリンク品質（受信機のフェイルセーフとタイムアウトを途絶とする）
+//  notify(): フレーム完成でのタスク通知
+//  dump(): 受信状態の表示
 ////////////////////////////////////////////////////////////////////////////////
-#include <QuickPID.h>
+#include "RxDecoder.hpp"
 
-class ServoPID {
-public:
+class SerialRx {
+  static HardwareSerial* PORT;
+  static RxDecoder DEC;
+  static portMUX_TYPE MUX;
   
-  float Setpoint, Input, Output;
+  static int USEC[RxDecoder::MAX]; // channels of the last frame
+  static int FREQ;
+  static unsigned long lastFall;
+  static int tout;
+
+  static TaskHandle_t NOTIFY; // task notified at each frame
+  static Ticker WDT;          // watch dog timer
+  static LinkHealth LINK;
+  static const int CHECK_MS = 5;
+
+  // called from UART event task when RX line goes idle
+  static void onReceive(void) {
+    uint8_t buf[RxDecoder::SIZE];
+    int n;
+    while ((n = PORT->available()) > 0) {
+      n = PORT->readBytes(buf, min(n,(int)sizeof(buf)));
+      for (int i=0; i<n; i++) {
+        if (DEC.put(buf[i])) frame();
+      }
+    }
+    DEC.idle();
+  }
+  static void frame(void) {
+    unsigned long tnow = micros();
+    portENTER_CRITICAL(&MUX);
+    for (int ch=0; ch<RxDecoder::MAX; ch++) USEC[ch] = (DEC.isFailsafe()? 0: DEC.getUsec(ch));
+    unsigned long gap = tnow - lastFall;
+    FREQ = (gap > 0? 1000000/gap: 0);
+    if (DEC.isFailsafe()) LINK.drop(tnow);
+    else LINK.frame(gap, tnow);
+    lastFall = tnow;
+    portEXIT_CRITICAL(&MUX);
+    if (NOTIFY) xTaskNotifyGive(NOTIFY);
+  }
+  static void TSR(void) {
+    unsigned long tnow = micros();
+    if ((long)(tnow - lastFall) > tout) {
+      portENTER_CRITICAL(&MUX);
+      for (int ch=0; ch<RxDecoder::MAX; ch++) USEC[ch] = 0;
+      FREQ = 0;
+      LINK.drop(tnow);
+      portEXIT_CRITICAL(&MUX);
+    }
+  }
+
+public:
+  static bool setup(int proto, int pin, HardwareSerial* port=&Serial2, int toutUs=21*1000) {
+    long baud = RxDecoder::getBaud(proto);
+    if (baud <= 0) return false;
+    PORT = port;
+    DEC.setup(proto);
+    tout = toutUs;
+    lastFall = micros();
+    LINK.init();
+    // SBUS is 8E2 and inverted, others are 8N1
+    if (proto == RxDecoder::SBUS)
+      PORT->begin(baud, SERIAL_8E2, pin, -1, true);
+    else
+      PORT->begin(baud, SERIAL_8N1, pin, -1, false);
+    // RX idle for 2 symbols closes a frame
+    PORT->setRxTimeout(2);
+    PORT->onReceive(&onReceive, true);
+    WDT.attach_ms(CHECK_MS,&TSR);
+    return true;
+  }
+  static int getUsec(int ch) {
+    return (ch >= 0 && ch < RxDecoder::MAX)? USEC[ch]: -1;
+  }
+  static int getFreq(int ch) {
+    return (ch >= 0 && ch < RxDecoder::MAX)? FREQ: -1;
+  }
+  // ch of the same interface as PulsePort (one frame for all channels)
+  static unsigned long getFall(int ch) {
+    (void)ch;
+    return lastFall;
+  }
+  static void notify(int ch, TaskHandle_t task) {
+    (void)ch;
+    NOTIFY = task;
+  }
+  static LinkHealth& getLink(int ch) {
+    (void)ch;
+    return LINK;
+  }
+  static void dump(void) {
+    DEBUG.printf("rx: proto=%d frames=%lu errors=%lu freq=%4d (Hz)\n", DEC.getProtocol(),DEC.getFrames(),DEC.getErrors(),FREQ);
+    for (int ch=0; ch<DEC.getChannels(); ch++) DEBUG.printf(" ch(%d)=%6d (usec)\n", ch,USEC[ch]);
+  }
+};
+
+HardwareSerial* SerialRx::PORT = NULL;
+RxDecoder SerialRx::DEC;
+portMUX_TYPE SerialRx::MUX = portMUX_INITIALIZER_UNLOCKED;
+int SerialRx::USEC[RxDecoder::MAX];
+int SerialRx::FREQ = 0;
+unsigned long SerialRx::lastFall = 0;
+int SerialRx::tout = 21*1000;
+TaskHandle_t SerialRx::NOTIFY = NULL;
+Ticker SerialRx::WDT;
+LinkHealth SerialRx::LINK;
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// class ControlTask{}: 入力パルス同期の制御タスク（立下りエッジで起動）
+//  setup(): タスクの生成
+//  start(): 入力チャネルへの同期開始（PulsePort/SerialRx）
+//  stop(): 同期の停止（実行中の制御完了を待つ）
+//  isActive(): 同期の有無
+//  getDelay(): 立下りから出力書込みまでの遅れ[usec]
+//  getMissed(): タイムアウト回数（入力パルスなし）
+//  setDivider(): 入力周期のdiv等分で制御（立下りに位相同期）
+//  getPeriod(): 同期中の制御周期[usec]（入力周期のdiv等分、入力周期が未知なら1フレーム）
+//  getTask(): 制御タスクのハンドル（ResourceMonitor の監視用）
+////////////////////////////////////////////////////////////////////////////////
+#include <esp_timer.h>
+
+class ControlTask {
+  static TaskHandle_t TASK;
+  static esp_timer_handle_t TIMER;
+  static void (*FUNC)(void);
+  static volatile bool ACTIVE;
+  static volatile bool BUSY;
+  static int CH;
+  static void (*NOTIFY)(int, TaskHandle_t);
+  static unsigned long (*FALL)(int);
+  static int TOUT;
+  static int DELAY;
+  static int MISSED;
+  static int DIV;
+  static int PERIOD;
+  static int SUB;
+  static unsigned long LAST;
+
+  static void onTimer(void *arg) {
+    (void)arg;
+    xTaskNotifyGive(TASK);
+  }
+  static void run(void *arg) {
+    (void)arg;
+    for (;;) {
+      bool woke = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TOUT)) > 0;
+      if (!ACTIVE) continue;
+      unsigned long fall = FALL(CH);
+      bool edge = woke && fall != LAST;
+      if (edge) {
+        esp_timer_stop(TIMER);
+        LAST = fall;
+        SUB = 0;
+      }
+      BUSY = true;
+      FUNC();
+      if (edge) DELAY = micros() - fall;
+      else if (!woke) MISSED++;
+      // sub ticks at fall + n*PERIOD/DIV until the next frame
+      if (woke && DIV > 1 && SUB < DIV-1) {
+        SUB++;
+        long wait = (long)(LAST + (long)SUB*PERIOD/DIV - micros());
+        esp_timer_start_once(TIMER, wait > 50? wait: 50);
+      }
+      BUSY = false;
+    }
+  }
+
+public:
+  static bool setup(void (*func)(void), int toutMs=25, int core=1) {
+    if (TASK) return true;
+    FUNC = func;
+    TOUT = toutMs;
+    esp_timer_create_args_t args = {};
+    args.callback = &onTimer;
+    args.name = "ControlTask";
+    esp_timer_create(&args, &TIMER);
+    return xTaskCreatePinnedToCore(&run,"ControlTask",4096,NULL,configMAX_PRIORITIES-1,&TASK,core) == pdPASS;
+  }
+  // PORT: PulsePort or SerialRx
+  template <class PORT = PulsePort>
+  static void start(int ch = 0) {
+    if (!TASK) return;
+    CH = ch;
+    NOTIFY = &PORT::notify;
+    FALL = &PORT::getFall;
+    MISSED = 0;
+    ACTIVE = true;
+    NOTIFY(CH,TASK);
+  }
+  static void stop(void) {
+    if (NOTIFY) NOTIFY(-1,NULL);
+    ACTIVE = false;
+    while (BUSY) delay(1);
+    if (TIMER) esp_timer_stop(TIMER);
+  }
+  static void setDivider(int div, int periodUs) {
+    DIV = (div > 1? div: 1);
+    PERIOD = periodUs;
+  }
+  static int getPeriod(int frameUs) {
+    return (frameUs > 0? frameUs: 20000)/DIV;
+  }
+  static bool isActive(void) { return ACTIVE; }
+  static int getDelay(void) { return DELAY; }
+  static int getMissed(void) { return MISSED; }
+  static TaskHandle_t const* getTask(void) { return &TASK; }
+};
+
+TaskHandle_t ControlTask::TASK = NULL;
+void (*ControlTask::FUNC)(void) = NULL;
+volatile bool ControlTask::ACTIVE = false;
+volatile bool ControlTask::BUSY = false;
+int ControlTask::CH = 0;
+void (*ControlTask::NOTIFY)(int, TaskHandle_t) = NULL;
+unsigned long (*ControlTask::FALL)(int) = NULL;
+int ControlTask::TOUT = 25;
+int ControlTask::DELAY = 0;
+int ControlTask::MISSED = 0;
+esp_timer_handle_t ControlTask::TIMER = NULL;
+int ControlTask::DIV = 1;
+int ControlTask::PERIOD = 20000;
+int ControlTask::SUB = 0;
+unsigned long ControlTask::LAST = 0;
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// class RateLock{}: 受信機フレーム周期の計測と出力周波数の選択
+//  put(): 入力フレーム時刻の登録[usec]（同じ時刻は無視）
+//  isStable(): 周期が安定しているか
+//  getPeriod(): 入力周期の平均[usec]
+//  getJitter(): 入力周期のばらつき[usec]
+//  getMult(): サーボ上限maxHzとパルス幅maxUsecに収まる最大の倍率
+//  getHz(): 倍率に対応する出力周波数[Hz]
+////////////////////////////////////////////////////////////////////////////////
+class RateLock {
+  float period;
+  float jitter;
+  unsigned long last;
+  int count;
+public:
+  RateLock() {
+    setup();
+  }
+  void setup(void) {
+    period = 0.0F;
+    jitter = 0.0F;
+    last = 0;
+    count = 0;
+  }
+  void put(unsigned long tfall) {
+    if (tfall == last) return;
+    float dt = tfall - last;
+    last = tfall;
+    if (dt < 2000 || dt > 40000) {
+      // no receiver
+      count = 0;
+      return;
+    }
+    if (count == 0) {
+      period = dt;
+      jitter = 0.0F;
+    } else {
+      // skip lost or glitched frames
+      if (dt > 1.5F*period || dt < 0.5F*period) return;
+      float e = dt - period;
+      period += e/16;
+      jitter += (fabs(e) - jitter)/16;
+    }
+    if (count < 1000) count++;
+  }
+  bool isStable(void) { return count >= 50 && jitter < 0.05F*period; }
+  int getPeriod(void) { return count > 0? int(period): 0; }
+  int getJitter(void) { return count > 0? int(jitter): 0; }
+  int getMult(int maxHz, int maxUsec = 2000) {
+    if (!isStable()) return 0;
+    int k = int(period * maxHz / 1000000.0F);
+    while (k > 1 && period/k < maxUsec + 500) k--;
+    return k > 1? k: 1;
+  }
+  int getHz(int mult) {
+    return (mult > 0 && period > 0)? int(1000000.0F*mult/period + 0.5F): 0;
+  }
+};
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// class RollCascade{}: スタント（MODE=1）用のロール角カスケード制御（ウィリー、片輪走行の保持）
+//  外側: 角度ループ（ロール角の偏差 → 目標角速度、PI、サーボのフレーム周期で計算）
+//  内側: 角速度ループ（ジャイロの角速度の偏差 → サーボ、PID、呼び出しごと＝IMUの周期で計算）
+//  setup(): ゲインと出力範囲の変更（Hz: 外側の周期＝サーボのフレーム周波数、FREQかRATEのロック後の周波数）
+//  setHold(): 保持するロール角[deg]と操舵の向き
+//  loop(): 1周期の計算（スティック、ロール角、角速度 → サーボ出力[usec]）
+//  isActive(): 姿勢保持中か（ENGAGE度を越えて入り、RELEASE度を下回って抜ける）
+//  getRate(): 内側ループの目標角速度[deg/sec]（保持中以外は0）
+//
+//  入るときも抜けるときも、切り替えた時点の補正量から FADE_US かけて移る（出力が跳ばない）
+//  入るときの積分は内側が今の補正量、外側が0から（外側の積分に偏差を溜めない）
+////////////////////////////////////////////////////////////////////////////////
+class RollCascade {
+  static const int ENGAGE = 30;         // [deg]
+  static const int RELEASE = 25;        // [deg]
+  static const long FADE_US = 150000;
+  static constexpr float RATE_MAX = 360.0F;  // rate setpoint [deg/sec]
+  static constexpr float DT_MIN = 0.0002F;
+  static constexpr float DT_MAX = 0.025F;
+  PIDEngine<float,PID_AW_CLAMP,PID_D_MEAS> ANGLE;
+  PIDEngine<float,PID_AW_CLAMP,PID_D_MEAS> RATE;
+  float Ka, Kai, Kp, Ki, Kd;
   float Min, Mean, Max;
-  QuickPID* QPID;
-  
-  ServoPID(void) {
-    //
-    Setpoint = 0.0F;
-    Input = 0.0F;
-    Output = 0.0F;
-    //
-    Mean = 1500;
-    Min = 1000 - Mean;
-    Max = 2000 - Mean;
-    //
-    QPID = new QuickPID(&Input, &Output, &Setpoint, 1.0,0.0,0.0, QuickPID::Action::direct);
-    QPID->SetAntiWindupMode(QuickPID::iAwMode::iAwClamp);
-    QPID->SetMode(QuickPID::Control::automatic);
-    QPID->SetOutputLimits(Min,Max);
-    QPID->SetSampleTimeUs(1000000/50);
+  float hold, sign;
+  float target, rateSp, u;
+  float corr, held;      // correction to stick [usec]: output, and at the last switch
+  float period, tuned;   // inner loop period [sec]: measured, and of RATE gains
+  unsigned long outerUs, lastOuter, lastInner, switched;
+  bool active;
+
+  void tune(float dt) {
+    tuned = dt;
+    RATE.setTunings(Kp, Ki, Kd, dt, 2.0F*dt);
   }
-  
-  // PID setup
-  void setup(float Kp, float Ki, float Kd, int MIN=1000, int MEAN=1500, int MAX=2000, int Hz=50) {
+
+public:
+  RollCascade(void) {
+    Ka = 4.0F; Kai = 0.0F;
+    Kp = 1.0F; Ki = 0.0F; Kd = 0.0F;
+    Min = -500; Mean = 1500; Max = 500;
+    hold = 45; sign = 1;
+    target = rateSp = u = 0.0F;
+    corr = held = 0.0F;
+    period = tuned = 1.0F/400;
+    outerUs = 1000000/400;
+    lastOuter = lastInner = switched = 0;
+    active = false;
+  }
+
+  void setup(float Ka_, float Kai_, float Kp_, float Ki_, float Kd_, int MIN=1000, int MEAN=1500, int MAX=2000, int Hz=50) {
+    Ka = Ka_; Kai = Kai_;
+    Kp = Kp_; Ki = Ki_; Kd = Kd_;
     Min = MIN - MEAN;
     Mean = MEAN;
     Max = MAX - MEAN;
-  
-    QPID->SetTunings(Kp,Ki,Kd);
-    QPID->SetOutputLimits(Min,Max);
-    QPID->SetSampleTimeUs(Hz>=50? 1000000/Hz: 1000000/50);
-  }
-  void setupT(float Kp, float Ti, float Td, int MIN=1000, int MEAN=1500, int MAX=2000, int Hz=50) {
-    if (Ti <= 0.0) Ti = 1.0;
-    float Ki = Kp/Ti;
-    float Kd = Kp*Td;
-    setup(Kp,Ki,Kd, MIN,MEAN,MAX,Hz);
-  }
-  void setupU(float Ku, float Tu, int MIN=1000, int MEAN=1500, int MAX=2000, int Hz=50) {
-    if (Tu <= 0.0) Tu = 1.0;
-    // Ziegler–Nichols method
-    float Ti = 0.50*Tu;
-    float Td = 0.125*Tu;
-    float Kp = 0.60*Ku;
-    float Ki = Kp/Ti;
-    float Kd = Kp*Td;
-    setup(Kp,Ki,Kd, MIN,MEAN,MAX,Hz);
+    outerUs = (Hz>=50? 1000000/Hz: 1000000/50);
+    ANGLE.setLimits(-RATE_MAX, RATE_MAX);
+    ANGLE.setTunings(Ka, Kai, 0.0F, outerUs/1000000.0F);
+    RATE.setLimits(Min - Max, Max - Min);
+    tune(period);
   }
-  
-  // PID loop
-  float loop(float SP, float PV) {
-    // Compute PID
-    Setpoint = (SP > 0? SP - Mean: 0.0);
-    Input = PV;
-    QPID->Compute();
-    return SP > 0? Mean + constrain(Output,Min,Max): 0;
+  void setHold(int deg, bool rev) {
+    hold = deg;
+    sign = (rev? -1.0F: 1.0F);
   }
 
-  // debug print
-  void debug(void) {
-    DEBUG.printf("%.2f %.2f %.2f\n", Setpoint,Input,Output);
+  // SP: stick [usec] (0: no input), roll [deg], rate: d(roll)/dt [deg/sec]
+  float loop(float SP, float roll, float rate) {
+    unsigned long now = micros();
+    float dt = constrain((now - lastInner)/1000000.0F, DT_MIN, DT_MAX);
+    lastInner = now;
+    period += 0.0625F*(dt - period);
+    float stick = (SP > 0? SP - Mean: 0.0F);
+    // engage and release with hysteresis
+    if (!active && fabsf(roll) > ENGAGE) {
+      active = true;
+      switched = now;
+      held = corr;
+      target = (roll > 0? hold: -hold);
+      ANGLE.reset(roll, Ka*(target - roll), target);
+      RATE.reset(rate, sign*held, rate);
+      lastOuter = now - outerUs;
+    } else
+    if (active && fabsf(roll) < RELEASE) {
+      active = false;
+      switched = now;
+      held = corr;
+      rateSp = 0.0F;
+    }
+    float fade = (now - switched < FADE_US? (now - switched)/float(FADE_US): 1.0F);
+    if (active) {
+      // gains follow the measured IMU rate (>10% change)
+      if (fabsf(period - tuned) > 0.1F*tuned) tune(period);
+      if (now - lastOuter >= outerUs) {
+        rateSp = ANGLE.compute(target, roll);
+        lastOuter = now;
+      }
+      u = RATE.compute(rateSp, rate);
+      corr = fade*sign*u + (1.0F - fade)*held;
+    } else {
+      corr = (1.0F - fade)*held;
+    }
+    return SP > 0? Mean + constrain(stick + corr, Min, Max): 0;
   }
-
+  bool isActive(void) { return active; }
+  float getRate(void) { return rateSp; }
 };
 
 
@@ -847,8 +1333,11 @@ public:
 //  loop(): AHRSの更新
 //  initAXIS(): 座標軸の変更（シャーシ固定系の変更）
 //  initMEAN(): バイアスの更新（センサのキャリブレーション）
+//  initFAST(): 保存したバイアスを短時間の静止で確認して再利用（失敗でfalse）
+//  isFAST(): 前回のsetup()で保存値を再利用したか
 ////////////////////////////////////////////////////////////////////////////////
 class M5StackAHRS {
+  friend class GyroM5Bench; // tools/bench_atom.hpp
   /* AHRS */
   //#include <utility/MahonyAHRS.h>
   //---------------------------------------------------------------------------------------------------
@@ -964,7 +1453,7 @@ class M5StackAHRS {
     float halfx = 0.5f * x;
     float y = x;
   #pragma GCC diagnostic ignored "-Wstrict-aliasing"
-    long i = *(long*)&y;
+    int32_t i = *(int32_t*)&y;
     i = 0x5f3759df - (i>>1);
     y = *(float*)&i;
   #pragma GCC diagnostic warning "-Wstrict-aliasing"
@@ -998,6 +1487,13 @@ class M5StackAHRS {
 
   /* LPF */
   //FilterLP LPF[6];
+
+  /* Calibration cache */
+  #define CALIB_NAME  "GyroM5Calib"
+  #define CALIB_KEY   "AHRS"
+  #define CALIB_MAGIC 23456
+  struct { float GYRO[3]; float ACCL[3]; float TEMP; int MAGIC; } CALIB;
+  bool fast = false;
   
   /* Vetor Operations */
   float dot(float* a,float* b) { return a[0]*b[0]+a[1]*b[1]+a[2]*b[2]; }
@@ -1061,6 +1557,66 @@ public:
     }
   }
   
+  void saveCALIB(void) {
+    for (int i=0; i<3; i++) {
+      CALIB.GYRO[i] = GYRO[i];
+      CALIB.ACCL[i] = ACCL[i];
+    }
+    M5.IMU.getTempData(&CALIB.TEMP);
+    CALIB.MAGIC = CALIB_MAGIC;
+    if (CONFIG_PREF.begin(CALIB_NAME)) {
+      CONFIG_PREF.putBytes(CALIB_KEY,(uint8_t*)&CALIB,sizeof(CALIB));
+      CONFIG_PREF.end();
+    }
+  }
+  
+  bool initFAST(int msec = 100) {
+    CALIB.MAGIC = 0;
+    if (CONFIG_PREF.begin(CALIB_NAME,true)) {
+      CONFIG_PREF.getBytes(CALIB_KEY,(uint8_t*)&CALIB,sizeof(CALIB));
+      CONFIG_PREF.end();
+    }
+    if (CALIB.MAGIC != CALIB_MAGIC) return false;
+  
+    // short mean and variance
+    float gm[3] = {0.0,0.0,0.0}, gv[3] = {0.0,0.0,0.0}, am[3] = {0.0,0.0,0.0};
+    int N = 0;
+    unsigned long int timeout = millis() + msec;
+    while (millis() < timeout) {
+      M5.IMU.getGyroData(&gyro[0],&gyro[1],&gyro[2]);
+      M5.IMU.getAccelData(&accl[0],&accl[1],&accl[2]);
+      for (int i=0; i<3; i++) {
+        gm[i] += gyro[i];
+        gv[i] += gyro[i]*gyro[i];
+        am[i] += accl[i];
+      }
+      N++;
+      delay(1);
+    }
+    if (N < 10) return false;
+    M5.IMU.getTempData(&temp);
+  
+    // still, same bias, same gravity axis, same temperature
+    for (int i=0; i<3; i++) {
+      gm[i] /= N;
+      am[i] /= N;
+      gv[i] = gv[i]/N - gm[i]*gm[i];
+      if (gv[i] > 0.5*0.5) return false;                  // noise < 0.5 deg/s
+      if (abs(gm[i] - CALIB.GYRO[i]) > 0.5) return false; // bias < 0.5 deg/s
+    }
+    float na = norm(am), nc = norm(CALIB.ACCL);
+    if (abs(na - 1.0) > 0.05 || nc < 0.5) return false;   // |g| = 1 +/- 0.05
+    if (dot(am,CALIB.ACCL) < 0.9986*na*nc) return false;  // tilt < 3 deg
+    if (abs(temp - CALIB.TEMP) > 8.0) return false;       // temp < 8 deg C
+  
+    for (int i=0; i<3; i++) {
+      GYRO[i] = CALIB.GYRO[i];
+      ACCL[i] = CALIB.ACCL[i];
+    }
+    return true;
+  }
+  bool isFAST(void) { return fast; }
+  
   void initAXIS(int xdir = 1) {
     // initial X0
     int xabs = abs(xdir);
@@ -1086,9 +1642,13 @@ public:
     normalize(Y);
   }
   
-  void setup(int msec = 2000, int xdir = 1) {
+  void setup(int msec = 2000, int xdir = 1, bool cache = false) {
     M5.IMU.Init();
-    initMEAN(msec);
+    fast = cache && initFAST();
+    if (!fast) {
+      initMEAN(msec);
+      if (cache) saveCALIB();
+    }
     initAXIS(xdir);
   }
   
@@ -1167,19 +1727,548 @@ public:
 
 
 ////////////////////////////////////////////////////////////////////////////////
-// class M5AtomLED{}: LED制御ライブラリ（M5Atom標準ライブラリのバグ回避）
+// class YawEKF{}: ヨーレート推定用の拡張カルマンフィルタ（固定サイズ、ヒープ不使用）
+//  状態: ヨーレートr[deg/s], ジャイロバイアスb[deg/s], 横滑り角速度s[deg/s], 速度v[m/s]
+//  観測: ジャイロZ = r + b, 横加速度[G] = v*(r + s)
+//  入力: 舵角指令u[-1,1]（定常ヨーレート v*u*KS に一次遅れで追従、カウンター時は無効）
 //  setup(): 初期化
+//  loop(): 更新（ジャイロZ[deg/s], 横加速度[G], 舵角指令[-1,1]）
+//  getRate(): ヨーレート推定[deg/s]
+//  getBias(): ジャイロバイアス推定[deg/s]
+//  getSlipRate(): 横滑り角速度推定[deg/s]
+//  getSlip(): 横滑り角（ドリフト角）推定[deg]
+//  getSpeed(): 速度推定[m/s]
+//  getUsec(): 1回の更新時間[usec]
+////////////////////////////////////////////////////////////////////////////////
+class YawEKF {
+  static const int N = 4; // number of states
+  enum { R = 0, B, S, V };
+
+  // model parameters
+  const float KS = 2.3F * RAD_TO_DEG; // steady yaw rate per speed at full steering [deg/s / (m/s)]
+  const float TAU_R = 0.10F;          // yaw rate response [sec]
+  const float TAU_S = 0.50F;          // sideslip rate decay [sec]
+  const float TAU_SLIP = 2.0F;        // drift angle washout [sec]
+  const float G_PER_DEG = DEG_TO_RAD / 9.80665F; // (m/s)*(deg/s) to G
+  // noise parameters (per second for process, per sample for measurement)
+  const float Q_R = 100.0F*100.0F;
+  const float Q_B = 0.1F*0.1F;
+  const float Q_S = 20.0F*20.0F;
+  const float Q_V = 0.3F*0.3F;
+  const float R_GYRO = 2.0F*2.0F;
+  const float R_ACCL = 0.05F*0.05F;
+
+  float x[N];
+  float P[N][N];
+  float slip;
+  unsigned long last;
+  int usec;
+
+  void predict(float u, float dt) {
+    float F[N][N] = {};
+    float FP[N][N];
+    // no steering model while counter-steering (drifting)
+    if (u * x[R] < 0.0F) u = 0.0F;
+    // x := f(x,u)
+    float rss = x[V] * u * KS;
+    x[R] += dt * (rss - x[R]) / TAU_R;
+    x[S] -= dt * x[S] / TAU_S;
+    // F := df/dx
+    F[R][R] = 1.0F - dt / TAU_R;
+    F[R][V] = dt * u * KS / TAU_R;
+    F[B][B] = 1.0F;
+    F[S][S] = 1.0F - dt / TAU_S;
+    F[V][V] = 1.0F;
+    // P := F P F' + Q
+    for (int i=0; i<N; i++)
+      for (int j=0; j<N; j++) {
+        float sum = 0.0F;
+        for (int k=0; k<N; k++) sum += F[i][k] * P[k][j];
+        FP[i][j] = sum;
+      }
+    for (int i=0; i<N; i++)
+      for (int j=0; j<N; j++) {
+        float sum = 0.0F;
+        for (int k=0; k<N; k++) sum += FP[i][k] * F[j][k];
+        P[i][j] = sum;
+      }
+    P[R][R] += Q_R * dt;
+    P[B][B] += Q_B * dt;
+    P[S][S] += Q_S * dt;
+    P[V][V] += Q_V * dt;
+  }
+
+  // scalar measurement update: z = h(x) + noise, H = dh/dx
+  void correct(float z, float hx, const float* H, float Rm) {
+    float PH[N];
+    for (int i=0; i<N; i++) {
+      float sum = 0.0F;
+      for (int k=0; k<N; k++) sum += P[i][k] * H[k];
+      PH[i] = sum;
+    }
+    float cov = Rm;
+    for (int k=0; k<N; k++) cov += H[k] * PH[k];
+    if (cov <= 0.0F) return;
+    float e = z - hx;
+    for (int i=0; i<N; i++) {
+      float K = PH[i] / cov;
+      x[i] += K * e;
+      for (int j=0; j<N; j++) P[i][j] -= K * PH[j];
+    }
+  }
+
+public:
+  YawEKF() {
+    setup();
+  }
+  void setup(float v0 = 3.0F) {
+    for (int i=0; i<N; i++) {
+      x[i] = 0.0F;
+      for (int j=0; j<N; j++) P[i][j] = 0.0F;
+    }
+    x[V] = v0;
+    P[R][R] = 100.0F;
+    P[B][B] = 1.0F;
+    P[S][S] = 100.0F;
+    P[V][V] = 4.0F;
+    slip = 0.0F;
+    last = micros();
+    usec = 0;
+  }
+  void loop(float gyroZ, float acclY, float steer) {
+    unsigned long tnow = micros();
+    float dt = (tnow - last) / 1000000.0F;
+    last = tnow;
+    if (dt <= 0.0F || dt > 0.1F) return;
+    steer = constrain(steer, -1.0F, 1.0F);
+    //
+    predict(steer, dt);
+    // gyro
+    float H1[N] = {1.0F, 1.0F, 0.0F, 0.0F};
+    correct(gyroZ, x[R] + x[B], H1, R_GYRO);
+    // lateral accel
+    float k = G_PER_DEG;
+    float H2[N] = {x[V]*k, 0.0F, x[V]*k, (x[R] + x[S])*k};
+    correct(acclY, x[V]*(x[R] + x[S])*k, H2, R_ACCL);
+    // keep speed positive and P symmetric
+    if (x[V] < 1.0F) x[V] = 1.0F;
+    for (int i=0; i<N; i++)
+      for (int j=0; j<i; j++) P[i][j] = P[j][i] = 0.5F * (P[i][j] + P[j][i]);
+    // drift angle := washed-out integral of sideslip rate
+    slip += dt * (x[S] - slip / TAU_SLIP);
+    usec = micros() - tnow;
+  }
+  float getRate(void) { return x[R]; }
+  float getBias(void) { return x[B]; }
+  float getSlipRate(void) { return x[S]; }
+  float getSlip(void) { return slip; }
+  float getSpeed(void) { return x[V]; }
+  int getUsec(void) { return usec; }
+  void debug(void) {
+    DEBUG.println("YawEKF:");
+    DEBUG.printf(" x=(%.2f,%.2f,%.2f,%.2f)\n",x[R],x[B],x[S],x[V]);
+    DEBUG.printf(" P=(%.2f,%.2f,%.2f,%.2f)\n",P[R][R],P[B][B],P[S][S],P[V][V]);
+    DEBUG.printf(" slip=%.2f usec=%d\n",slip,usec);
+  }
+};
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// class VibrationFFT{}: ジャイロの振動スペクトル解析と自動ノッチ（コア0の低優先度タスク）
+//  制御側の loop() は生の値をリングに写してノッチ2段を通すだけ（解析はタスク）
+//  タスクは100msecごとに直近 N 点（ハン窓、半分ずつ重ねる）をFFTして振幅を平均
+//  MIN_HZ 以上で床（中央値）の FLOOR 倍を越える山を大きい順に2つ選び、
+//  mode 2 ではその周波数にノッチを置く（中心は徐々に追従、山が消えたら外す）
+//  サンプル周波数は窓の時刻から求める（制御周期が変わっても追従）
+//  setup(): 開始（mode 0:なし、1:解析だけ、2:解析と自動ノッチ）
+//  loop(): 1周期分の登録とノッチの適用（制御周期で呼ぶ）
+//  analyze(): 窓が溜まっていれば解析（タスクなしなら呼び出し側で）
+//  printJSON(): スペクトルと山とノッチのJSON出力
+//  getPeak(): 山の周波数[Hz]（0:なし）
+//  getAmp(): 最大の山の振幅[deg/sec]
+//  getNotch(): ノッチの中心周波数[Hz]（0:なし）
+//  getUsec(): 解析1回の時間[usec]
+//  getTask(): 解析タスクのハンドル（ResourceMonitor の監視用）
+////////////////////////////////////////////////////////////////////////////////
+// biquad notch (RBJ), direct form I (coefficient change without state jump)
+typedef struct {
+  float b0, b1, b2, a1, a2;
+} NotchCoef;
+
+class VibrationFFT {
+  friend class GyroM5Bench; // tools/bench_atom.hpp
+public:
+  static const int N = 256;         // FFT points (0.64 sec at 400Hz)
+  static const int PEAKS = 2;       // peaks and notches
+private:
+  static const int RING = 2*N;
+  static const int HOP = N/2;       // 50% overlap
+  const float MIN_HZ = 25.0F;       // below: driving (steering and yaw response)
+  const float FLOOR = 4.0F;         // peak / median amplitude
+  const float MIN_AMP = 1.0F;       // [deg/sec]
+  const float NOTCH_Q = 3.0F;
+  const float AVG = 0.3F;           // spectrum averaging
+  const int HOLD = 10;              // analyses to keep a lost notch
+  //
+  float RAW[RING];                  // by loop()
+  uint32_t TIME[RING];
+  volatile uint32_t head = 0;       // samples written (free running)
+  uint32_t last = 0;                // head at the last analysis
+  // analysis (task)
+  float re[N], im[N];
+  float WIN[N];                     // Hann window
+  float COS[N/2], SIN[N/2];         // twiddles
+  float AMP[N/2];                   // averaged amplitude [deg/sec]
+  float fs = 0.0F;                  // sample rate of the last window [Hz]
+  float peak[PEAKS] = {0.0F, 0.0F};
+  float peakAmp[PEAKS] = {0.0F, 0.0F};
+  float center[PEAKS] = {0.0F, 0.0F};
+  int lost[PEAKS] = {0, 0};
+  int windows = 0;
+  int usec = 0;
+  // notch (coefficients by task, state by loop())
+  portMUX_TYPE MUX = portMUX_INITIALIZER_UNLOCKED;
+  NotchCoef NEXT[PEAKS];
+  volatile uint32_t version = 0;
+  uint32_t seen = 0;
+  NotchCoef COEF[PEAKS];
+  bool on[PEAKS] = {false, false};
+  float x1[PEAKS], x2[PEAKS], y1[PEAKS], y2[PEAKS];
+  //
+  TaskHandle_t TASK = NULL;
+  volatile int mode = 0;
+
+  static void run(void *arg) {
+    VibrationFFT* vib = (VibrationFFT*)arg;
+    for (;;) {
+      vTaskDelay(pdMS_TO_TICKS(100));
+      vib->analyze();
+    }
+  }
+  // in-place radix-2 complex FFT of re/im
+  void fft(void) {
+    for (int i=1, j=0; i<N; i++) {
+      int bit = N >> 1;
+      for (; j & bit; bit >>= 1) j ^= bit;
+      j ^= bit;
+      if (i < j) {
+        float t = re[i]; re[i] = re[j]; re[j] = t;
+        t = im[i]; im[i] = im[j]; im[j] = t;
+      }
+    }
+    for (int len=2; len<=N; len<<=1) {
+      int step = N/len;
+      for (int i=0; i<N; i+=len) {
+        for (int k=0; k<len/2; k++) {
+          float wr = COS[k*step], wi = -SIN[k*step];
+          int a = i + k, b = i + k + len/2;
+          float tr = re[b]*wr - im[b]*wi;
+          float ti = re[b]*wi + im[b]*wr;
+          re[b] = re[a] - tr; im[b] = im[a] - ti;
+          re[a] += tr; im[a] += ti;
+        }
+      }
+    }
+  }
+  static float median(const float* v, int n) {
+    float s[N/2];
+    for (int i=0; i<n; i++) s[i] = v[i];
+    // insertion sort (n <= 128, once per analysis)
+    for (int i=1; i<n; i++) {
+      float t = s[i];
+      int j = i - 1;
+      for (; j >= 0 && s[j] > t; j--) s[j+1] = s[j];
+      s[j+1] = t;
+    }
+    return n > 0? s[n/2]: 0.0F;
+  }
+  // largest local maxima above floor, frequency by parabolic interpolation
+  void findPeaks(void) {
+    float df = fs/N;
+    int k0 = max(2, (int)ceilf(MIN_HZ/df));
+    float floor = median(AMP + k0, N/2 - 1 - k0);
+    float limit = max(FLOOR*floor, MIN_AMP);
+    bool used[N/2] = {false};
+    for (int p=0; p<PEAKS; p++) {
+      int best = 0;
+      for (int k=k0; k<N/2-1; k++) {
+        if (used[k] || AMP[k] < limit || AMP[k] < AMP[k-1] || AMP[k] < AMP[k+1]) continue;
+        if (!best || AMP[k] > AMP[best]) best = k;
+      }
+      peak[p] = peakAmp[p] = 0.0F;
+      if (!best) continue;
+      float a = AMP[best-1], b = AMP[best], c = AMP[best+1];
+      float d = (a - 2*b + c) != 0.0F? 0.5F*(a - c)/(a - 2*b + c): 0.0F;
+      peak[p] = (best + constrain(d, -0.5F, 0.5F))*df;
+      peakAmp[p] = b;
+      for (int k=max(0,best-3); k<=min(N/2-1,best+3); k++) used[k] = true;
+    }
+  }
+  // notch centers follow the peaks (nearest first), dropped after HOLD misses
+  void placeNotches(void) {
+    NotchCoef next[PEAKS];
+    bool taken[PEAKS] = {false, false};
+    for (int n=0; n<PEAKS; n++) {
+      int best = -1;
+      for (int p=0; p<PEAKS; p++) {
+        if (taken[p] || peak[p] <= 0.0F) continue;
+        if (best < 0 || fabs(peak[p] - center[n]) < fabs(peak[best] - center[n])) best = p;
+      }
+      if (best >= 0 && (center[n] <= 0.0F || fabs(peak[best] - center[n]) < 0.2F*center[n])) {
+        center[n] = (center[n] > 0.0F? center[n] + 0.5F*(peak[best] - center[n]): peak[best]);
+        taken[best] = true;
+        lost[n] = 0;
+      } else if (center[n] > 0.0F && ++lost[n] > HOLD) {
+        center[n] = 0.0F;
+      }
+    }
+    // free slots take the remaining peaks
+    for (int n=0; n<PEAKS; n++) {
+      if (center[n] > 0.0F) continue;
+      for (int p=0; p<PEAKS; p++) {
+        if (taken[p] || peak[p] <= 0.0F) continue;
+        center[n] = peak[p];
+        taken[p] = true;
+        lost[n] = 0;
+        break;
+      }
+    }
+    for (int n=0; n<PEAKS; n++) {
+      float f = (mode == 2 && center[n] < 0.45F*fs)? center[n]: 0.0F;
+      next[n] = design(f, fs);
+    }
+    portENTER_CRITICAL(&MUX);
+    for (int n=0; n<PEAKS; n++) NEXT[n] = next[n];
+    version++;
+    portEXIT_CRITICAL(&MUX);
+  }
+  // b0=0: pass through
+  NotchCoef design(float f0, float rate) {
+    NotchCoef c = {0.0F, 0.0F, 0.0F, 0.0F, 0.0F};
+    if (f0 <= 0.0F || rate <= 0.0F) return c;
+    float w = 2.0F*PI*f0/rate;
+    float alpha = sinf(w)/(2.0F*NOTCH_Q);
+    float a0 = 1.0F + alpha;
+    c.b0 = 1.0F/a0;
+    c.b1 = -2.0F*cosf(w)/a0;
+    c.b2 = 1.0F/a0;
+    c.a1 = -2.0F*cosf(w)/a0;
+    c.a2 = (1.0F - alpha)/a0;
+    return c;
+  }
+
+public:
+  VibrationFFT() {
+    for (int i=0; i<N; i++) WIN[i] = 0.5F - 0.5F*cosf(2.0F*PI*i/N);
+    for (int k=0; k<N/2; k++) { COS[k] = cosf(2.0F*PI*k/N); SIN[k] = sinf(2.0F*PI*k/N); }
+    for (int n=0; n<PEAKS; n++) COEF[n] = NEXT[n] = design(0.0F, 0.0F);
+    reset();
+  }
+  void setup(int mode_) {
+    mode = constrain(mode_, 0, 2);
+    reset();
+    if (mode > 0 && !TASK) xTaskCreatePinnedToCore(&run,"VibrationFFT",4096,this,1,&TASK,0);
+  }
+  void reset(void) {
+    head = last = 0;
+    windows = 0;
+    for (int k=0; k<N/2; k++) AMP[k] = 0.0F;
+    for (int n=0; n<PEAKS; n++) {
+      peak[n] = peakAmp[n] = center[n] = 0.0F;
+      lost[n] = 0;
+      on[n] = false;
+      x1[n] = x2[n] = y1[n] = y2[n] = 0.0F;
+    }
+    version++;
+  }
+  // control path: raw gyro in, notched gyro out
+  float loop(float v) {
+    if (mode == 0) return v;
+    uint32_t h = head;
+    RAW[h % RING] = v;
+    TIME[h % RING] = micros();
+    __sync_synchronize();
+    head = h + 1;
+    if (version != seen) {
+      portENTER_CRITICAL(&MUX);
+      for (int n=0; n<PEAKS; n++) COEF[n] = NEXT[n];
+      seen = version;
+      portEXIT_CRITICAL(&MUX);
+      for (int n=0; n<PEAKS; n++) {
+        // (re)start from the current value as steady state
+        if (!on[n] && COEF[n].b0 != 0.0F) { x1[n] = x2[n] = y1[n] = y2[n] = v; }
+        on[n] = (COEF[n].b0 != 0.0F);
+      }
+    }
+    for (int n=0; n<PEAKS; n++) {
+      if (!on[n]) continue;
+      const NotchCoef& c = COEF[n];
+      float y = c.b0*v + c.b1*x1[n] + c.b2*x2[n] - c.a1*y1[n] - c.a2*y2[n];
+      x2[n] = x1[n]; x1[n] = v;
+      y2[n] = y1[n]; y1[n] = y;
+      v = y;
+    }
+    return v;
+  }
+  void analyze(void) {
+    uint32_t h = head;
+    if (mode == 0 || h < (uint32_t)N || h - last < (uint32_t)HOP) return;
+    unsigned long t0 = micros();
+    last = h;
+    // the N latest samples (the writer is RING-N samples away)
+    uint32_t s = h - N;
+    float mean = 0.0F;
+    for (int i=0; i<N; i++) mean += RAW[(s + i) % RING];
+    mean /= N;
+    for (int i=0; i<N; i++) {
+      re[i] = (RAW[(s + i) % RING] - mean)*WIN[i];
+      im[i] = 0.0F;
+    }
+    uint32_t span = TIME[(h - 1) % RING] - TIME[s % RING];
+    if (span == 0) return;
+    fs = (N - 1)*1000000.0F/span;
+    fft();
+    // single sided amplitude of a sine (Hann gain 0.5)
+    float a = (windows == 0? 1.0F: AVG);
+    for (int k=0; k<N/2; k++) {
+      float m = 4.0F*sqrtf(re[k]*re[k] + im[k]*im[k])/N;
+      AMP[k] += a*(m - AMP[k]);
+    }
+    windows++;
+    findPeaks();
+    placeNotches();
+    usec = micros() - t0;
+  }
+  size_t printJSON(Print& out) {
+    size_t n = out.printf("{\"fs\":%.1f,\"df\":%.3f,\"windows\":%d,\"mode\":%d,\"amp\":[", fs, fs/N, windows, (int)mode);
+    for (int k=0; k<N/2; k++) n += out.printf("%s%.2f", (k? ",": ""), AMP[k]);
+    n += out.print("],\"peaks\":[");
+    for (int p=0; p<PEAKS; p++) n += out.printf("%s[%.1f,%.2f]", (p? ",": ""), peak[p], peakAmp[p]);
+    n += out.print("],\"notch\":[");
+    for (int p=0; p<PEAKS; p++) n += out.printf("%s%.1f", (p? ",": ""), getNotch(p));
+    n += out.print("]}");
+    return n;
+  }
+  float getPeak(int p) { return peak[p % PEAKS]; }
+  float getAmp(void) { return peakAmp[0]; }
+  float getNotch(int n) { return (mode == 2 && center[n % PEAKS] < 0.45F*fs)? center[n % PEAKS]: 0.0F; }
+  int getUsec(void) { return usec; }
+  TaskHandle_t const* getTask(void) const { return &TASK; }
+};
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// class M5AtomLED{}: LED制御ライブラリ（M5Atom標準ライブラリのバグ回避）
+//  FastLED.show() はコア0の低優先度タスクで実行（制御ループを止めない）
+//  描画は DRAW に書いて show() で SHOW にコピー（ダブルバッファ）
+//  setup(): 初期化（表示タスクの生成）
 //  blink(): 点滅
 //  fill(): 全面塗り
 //  setPixcel(): 一点塗り
+//  setMode(): 表示モード（0:点滅、1:補正舵角バー、2:制御周期の健全性、3:ドリフト角）
+//  put(): テレメトリの登録（モード1-3はタスクがこの写しから20Hzで描画）
+//  getTask(): 表示タスクのハンドル（ResourceMonitor の監視用）
 ////////////////////////////////////////////////////////////////////////////////
 #include <FastLED.h>
 
+// telemetry snapshot for LED modes
+typedef struct {
+  float steer;    // correction of output to input [-1,1]
+  float stick;    // input stick [-1,1]
+  float loopHz;   // control loop rate [Hz]
+  float targetHz; // PID rate [Hz]
+  int missed;     // missed control steps (count, Supervisor)
+  float slip;     // drift angle [deg]
+} LEDTelemetry;
+
 class M5AtomLED {
-  CRGB LEDs[25];
+  CRGB LEDs[25];  // FastLED (task only)
+  CRGB DRAW[25];  // drawn by caller
+  CRGB SHOW[25];  // next frame to show
   bool MASK[3][25];
   TimerMS TIME;
+  TimerMS LIVE;
   int state = 0;
+  //
+  TaskHandle_t TASK = NULL;
+  portMUX_TYPE MUX = portMUX_INITIALIZER_UNLOCKED;
+  volatile bool ready = false;
+  volatile int mode = 0;
+  LEDTelemetry TELE = {};
+  int lastMissed = 0;
+  int flash = 0;
+
+  static void run(void *arg) {
+    M5AtomLED* led = (M5AtomLED*)arg;
+    for (;;) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(50));
+      led->render();
+    }
+  }
+  // in task (or caller without task)
+  void render(void) {
+    if (mode > 0) {
+      LEDTelemetry T;
+      portENTER_CRITICAL(&MUX);
+      T = TELE;
+      portEXIT_CRITICAL(&MUX);
+      draw(T);
+    } else {
+      if (!ready) return;
+      portENTER_CRITICAL(&MUX);
+      for (int p=0; p<25; p++) LEDs[p] = SHOW[p];
+      ready = false;
+      portEXIT_CRITICAL(&MUX);
+    }
+    FastLED.show();
+  }
+  // scale color by level [0,1]
+  static CRGB dim(CRGB c, float v) {
+    int k = constrain(int(v*255), 0, 255);
+    return CRGB(c.r*k/255, c.g*k/255, c.b*k/255);
+  }
+  // bar from center column of row y (v in [-1,1], 2.5 columns each side)
+  void bar(int y, float v, CRGB c) {
+    float n = constrain(v, -1.0F, 1.0F)*2.5F;
+    for (int x=0; x<5; x++) {
+      float d = (n >= 0? x - 2: 2 - x);
+      float on = (d < 0? 0.0F: constrain(fabs(n) - d + 0.5F, 0.0F, 1.0F));
+      LEDs[x+y*5] = dim(c, on);
+    }
+  }
+  void draw(const LEDTelemetry& T) {
+    for (int p=0; p<25; p++) LEDs[p] = CRGB::Black;
+    switch (mode) {
+      case 1: { // steering correction (rows 0-2) and stick (row 4)
+        float a = fabs(T.steer);
+        CRGB c = (a < 0.2F? CRGB(CRGB::Green): (a < 0.5F? CRGB(CRGB::Yellow): CRGB(CRGB::Red)));
+        for (int y=0; y<3; y++) bar(y, T.steer, c);
+        bar(4, T.stick, CRGB::Blue);
+        break;
+      }
+      case 2: { // loop rate to PID rate as gauge, red flash by missed control steps
+        float r = (T.targetHz > 0? T.loopHz/T.targetHz: 0.0F);
+        CRGB c = (r >= 0.95F? CRGB(CRGB::Green): (r >= 0.8F? CRGB(CRGB::Yellow): CRGB(CRGB::Red)));
+        int n = constrain(int(r*25 + 0.5F), 0, 25);
+        for (int p=0; p<n; p++) LEDs[24-p] = c;
+        if (T.missed != lastMissed) flash = 4;
+        lastMissed = T.missed;
+        if (flash > 0) { LEDs[12] = CRGB::Red; flash--; }
+        break;
+      }
+      case 3: { // drift angle as column (15deg per column)
+        float a = fabs(T.slip);
+        CRGB c = (a < 10? CRGB(CRGB::Blue): (a < 30? CRGB(CRGB::Orange): CRGB(CRGB::Red)));
+        int x = constrain(int(2.5F + T.slip/15.0F), 0, 4);
+        for (int y=0; y<5; y++) LEDs[x+y*5] = c;
+        LEDs[12] = (x == 2? c: CRGB(CRGB::White));
+        break;
+      }
+    }
+  }
+
 public:
   void setup(void) {
     FastLED.addLeds<WS2812,27,GRB>(LEDs,25);
@@ -1188,42 +2277,202 @@ public:
     for (int p=0; p<25; p++) {
       int x = p%5;
       int y = p/5;
-      LEDs[p] = CRGB::Black;
+      DRAW[p] = CRGB::Black;
       MASK[0][p] = (x==2) && (y==2);
       MASK[2][p] = (x==0) || (x==4) || (y==0) || (y==4);
       MASK[1][p] = !(MASK[0][p] || MASK[2][p]);
     }
     state = 0;
+    // the first show() on core 0 (RMT interrupt on core 0)
+    if (!TASK) xTaskCreatePinnedToCore(&run,"M5AtomLED",3072,this,1,&TASK,0);
     //
     for (int p=0; p<25; p++) {
       int h = (p*360)/25;
-      LEDs[p] = CHSV(h,255,255);
+      DRAW[p] = CHSV(h,255,255);
     }
-    FastLED.show();
+    show();
+  }
+  void show(void) {
+    portENTER_CRITICAL(&MUX);
+    for (int p=0; p<25; p++) SHOW[p] = DRAW[p];
+    ready = true;
+    portEXIT_CRITICAL(&MUX);
+    if (TASK) xTaskNotifyGive(TASK);
+    else render();
   }
   void blink(CRGB c, int msec) {
     if (TIME.isUp(msec)) {
-      for (int p=0; p<25; p++) LEDs[p] = MASK[state][p]? c: CRGB::Black;
-      FastLED.show();
+      for (int p=0; p<25; p++) DRAW[p] = MASK[state][p]? c: CRGB::Black;
+      show();
       state = (state + 1) % 3;
     }
   }
-  void fill(CRGB c, bool show=true) {
-    for (int p=0; p<25; p++) LEDs[p] = c;
-    if (show) FastLED.show();
+  void fill(CRGB c, bool show_=true) {
+    for (int p=0; p<25; p++) DRAW[p] = c;
+    if (show_) show();
   }
-  void setPixel(int p, CRGB c, bool show=true) {
-    LEDs[p%25] = c;
-    if (show) FastLED.show();
+  void setPixel(int p, CRGB c, bool show_=true) {
+    DRAW[p%25] = c;
+    if (show_) show();
   }
-  void setPixel(int x, int y, CRGB c, bool show=true) {
-    setPixel(x+y*5,c,show);
+  void setPixel(int x, int y, CRGB c, bool show_=true) {
+    setPixel(x+y*5,c,show_);
   }
+  void setMode(int m) {
+    mode = constrain(m, 0, 3);
+    if (mode == 0) show();
+  }
+  int getMode(void) { return mode; }
+  void put(const LEDTelemetry& T) {
+    portENTER_CRITICAL(&MUX);
+    TELE = T;
+    portEXIT_CRITICAL(&MUX);
+    if (!TASK && LIVE.isUp(50)) render();
+  }
+  TaskHandle_t const* getTask(void) const { return &TASK; }
   
 };
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+// class TelemetryTx{}: 走行データのUDP送信（Telemetry.hpp の形式、コア0の低優先度タスク）
+//  制御側の put() はリングバッファへの写しだけ（満杯なら捨てて数える、待たない）
+//  タスクが10msecごとに BATCH 個ずつ（古ければ端数も）パケットにしてブロードキャスト
+//  setup(): 開始（mode 0:なし、1:TELEMETRY_SSID にSTA接続して送信）
+//  stop(): 停止（WiFi設定画面の前）
+//  put(): 1周期分のサンプル登録（制御周期で呼ぶ）
+//  flush(): パケットの組立てと送信（タスクなしなら呼び出し側で）
+//  isActive(): 送信中か
+//  getPackets(): 送信パケット数[1/sec]
+//  getDropped(): 捨てたサンプルの累計（満杯、未接続、送信失敗）
+//  getUsec(): 送信1回の最大時間[usec]（1秒ごと）
+//  getTask(): 送信タスクのハンドル（ResourceMonitor の監視用）
+////////////////////////////////////////////////////////////////////////////////
+#include <WiFiUdp.h>
+#include "Telemetry.hpp"
+
+#ifndef TELEMETRY_SSID
+#define TELEMETRY_SSID  "GyroM5-TLM"
+#define TELEMETRY_PASS  "gyrom5tlm"
+#endif
+
+class TelemetryTx {
+  friend class GyroM5Bench;
+  static const int RING = 256;    // 0.64 sec at 400Hz
+  static const int BATCH = 16;    // samples per packet at least
+  static const int AGE_MS = 50;   // max wait of a partial packet
+  //
+  TelemetrySample BUFF[RING];
+  volatile uint16_t head = 0;     // by put()
+  volatile uint16_t tail = 0;     // by flush()
+  TelemetryPacker PACK;
+  WiFiUDP UDP;
+  IPAddress dst;
+  uint16_t port = TELEMETRY_PORT;
+  TaskHandle_t TASK = NULL;
+  volatile int mode = 0;
+  volatile bool busy = false;
+  bool local = false;             // fixed destination (no WiFi join)
+  unsigned long window = 0;
+  int packets = 0, lastPackets = 0;
+  int worst = 0, lastWorst = 0;
+  volatile uint32_t dropped = 0;
+
+  static void run(void *arg) {
+    TelemetryTx* tx = (TelemetryTx*)arg;
+    for (;;) {
+      vTaskDelay(pdMS_TO_TICKS(10));
+      tx->flush();
+    }
+  }
+  bool isLinked(void) {
+    return local || WiFi.status() == WL_CONNECTED;
+  }
+  void send(void) {
+    unsigned long t0 = micros();
+    IPAddress to = (local? dst: WiFi.broadcastIP());
+    int count = PACK.size();
+    int n = PACK.finish(t0);
+    if (UDP.beginPacket(to, port) && UDP.write(PACK.data(), n) == (size_t)n && UDP.endPacket()) packets++;
+    else dropped += count;
+    int usec = micros() - t0;
+    if (usec > worst) worst = usec;
+  }
+
+public:
+  void setup(int mode_, IPAddress dst_ = IPAddress(0,0,0,0), uint32_t car = 0, uint16_t port_ = TELEMETRY_PORT) {
+    stop();
+    mode = mode_;
+    if (mode == 0) return;
+    dst = dst_;
+    port = port_;
+    local = ((uint32_t)dst != 0);
+    PACK.setup(car? car: (uint32_t)ESP.getEfuseMac());
+    head = tail = 0;
+    window = millis();
+    if (!local) {
+      WiFi.mode(WIFI_STA);
+      WiFi.setSleep(false);
+      WiFi.begin(TELEMETRY_SSID, TELEMETRY_PASS);
+    }
+    if (!TASK) xTaskCreatePinnedToCore(&run,"TelemetryTx",4096,this,1,&TASK,0);
+  }
+  void stop(void) {
+    if (mode == 0) return;
+    mode = 0;
+    while (busy) delay(1);
+    UDP.stop();
+    if (!local) {
+      WiFi.disconnect();
+      WiFi.mode(WIFI_OFF);
+    }
+  }
+  void put(const TelemetrySample& s) {
+    if (mode == 0) return;
+    uint16_t next = (head + 1) % RING;
+    if (next == tail) { dropped++; return; }
+    BUFF[head] = s;
+    __sync_synchronize();
+    head = next;
+  }
+  void flush(bool all = false) {
+    busy = true;
+    if (mode == 0) { busy = false; return; }
+    int ready = (head - tail + RING) % RING;
+    bool old = ready > 0 && (int32_t)((uint32_t)micros() - BUFF[tail].time) > AGE_MS*1000L;
+    while (ready >= BATCH || (ready > 0 && (all || old))) {
+      if (!isLinked()) {
+        dropped += ready;
+        tail = (tail + ready) % RING;
+        break;
+      }
+      int n = min(ready, (int)TelemetryPacker::MAX);
+      for (int k=0; k<n; k++) {
+        PACK.add(BUFF[tail]);
+        tail = (tail + 1) % RING;
+      }
+      send();
+      ready -= n;
+      old = false;
+    }
+    if (millis() - window >= 1000) {
+      lastPackets = packets;
+      lastWorst = worst;
+      packets = worst = 0;
+      window = millis();
+    }
+    busy = false;
+  }
+  bool isActive(void) { return mode > 0; }
+  int getPackets(void) { return lastPackets; }
+  uint32_t getDropped(void) { return dropped; }
+  int getUsec(void) { return lastWorst; }
+  TaskHandle_t const* getTask(void) const { return &TASK; }
+};
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // EOF
 ////////////////////////////////////////////////////////////////////////////////
@@ -4,21 +4,35 @@
 // https://github.com/hshin-git/GyroM5
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <M5Atom.h>
+#define GYROM5_BOARD BOARD_ATOM
 #include "GyroM5Atom.hpp"
 
 
-// GPIO of M5Atom
+// GPIO of M5Atom (Grove by board traits)
 const int BTM_PIN[] = {22,19,23,33};
-const int GRV_PIN[] = {26,32};
+const int GRV_PIN[] = {Board::CH1_IN,Board::CH1_OUT};
 
 
 // PWM I/O Ports
 PulsePort PWM_IO;
 
 
+// Serial receiver (SBUS/iBUS/CRSF) instead of PWM input
+SerialRx SRX_IO;
+int RX_PROTO = 0;
+//
+int rx_getUsec(int ch) { return RX_PROTO? SRX_IO.getUsec(ch): PWM_IO.getUsec(ch); }
+int rx_getFreq(int ch) { return RX_PROTO? SRX_IO.getFreq(ch): PWM_IO.getFreq(ch); }
+unsigned long rx_getFall(int ch) { return RX_PROTO? SRX_IO.getFall(ch): PWM_IO.getFall(ch); }
+LinkHealth& rx_getLink(int ch) { return RX_PROTO? SRX_IO.getLink(ch): PWM_IO.getLink(ch); }
+
+
 // PID Controller
 ServoPID PID_CH1;
+RollCascade STUNT;
+ControlTask PID_TASK;
+RateLock RX_RATE;
+TimerMS RATE_CHECK;
 
 
 // FREQ Counter
@@ -35,6 +49,41 @@ float GYRO[3] = {0.0,0.0,0.0};
 float AHRS[3] = {0.0,0.0,0.0};
 
 
+// Yaw rate estimator (EST=1)
+YawEKF YAW_EKF;
+
+
+// Vibration spectrum and auto notch on yaw gyro (NOTCH=1,2)
+VibrationFFT VIB;
+
+
+// Power manager (POW=0:240MHz fixed, 1:auto clock, 2:auto and sleep; idle between steps in any)
+PowerManager POWER;
+
+
+// Deadline supervisor (SAFE=0,1,2)
+Supervisor WATCH;
+TimerMS WATCH_CHECK;
+
+
+// UDP telemetry to tools/collector (TLM=1)
+TelemetryTx TLM;
+
+
+// Receiver link health and failsafe of CH1 (FAIL=0,1,2)
+bool RX_LIVE = true;
+TimerMS LINK_CHECK;
+
+
+// Heap, stack and CPU load (ResourceMonitor in GyroM5Core.hpp)
+TimerMS SYS_CHECK;
+
+
+// Flight recorder of samples at REC_HZ around triggers (RYAW/RSLIP/RCNT, at /api/rec)
+#define REC_HZ  400
+FlightRecorder<> REC;
+
+
 // CONFIG SERVER
 SERVER WWW;
 
@@ -52,6 +101,32 @@ SERVER WWW;
 #define CNF_ROLL  (WWW.CONF.ROLL)
 #define CNF_FREQ  (WWW.CONF.FREQ)
 #define CNF_AXIS  (WWW.CONF.AXIS%2? (1+(WWW.CONF.AXIS-1)/2): -(1+(WWW.CONF.AXIS-1)/2))
+#define CNF_SYNC  (WWW.CONF.SYNC)
+#define CNF_RX  (WWW.CONF.RX)
+#define CNF_RATE  (WWW.CONF.RATE)
+#define CNF_EST  (WWW.CONF.EST)
+#define CNF_POW  (WWW.CONF.POW)
+#define CNF_LED  (WWW.CONF.LED)
+#define CNF_SAFE  (WWW.CONF.SAFE)
+#define CNF_TLM  (WWW.CONF.TLM)
+#define CNF_NOTCH  (WWW.CONF.NOTCH)
+#define CNF_AKP  (WWW.CONF.AKP/10.0)
+#define CNF_AKI  (WWW.CONF.AKI/10.0)
+#define CNF_RKP  (WWW.CONF.RKP/5.0)
+#define CNF_RKI  (WWW.CONF.RKI/5.0)
+#define CNF_RKD  (WWW.CONF.RKD/1000.0)
+#define CNF_SPD  (WWW.CONF.SPD)
+#define CNF_SPS  (WWW.CONF.SPS)
+#define CNF_SPT  (WWW.CONF.SPT)
+#define CNF_SPG  (CNF_KG * WWW.CONF.SPG/100.0)
+#define CNF_FF  (WWW.CONF.FF/100.0)
+#define CNF_FAIL  (WWW.CONF.FAIL)
+#define CNF_EXPO  (WWW.CONF.EXPO)
+#define CNF_TRIM  (WWW.CONF.TRIM)
+#define CNF_SLEW  (WWW.CONF.SLEW)
+#define CNF_RYAW  (WWW.CONF.RYAW)
+#define CNF_RSLIP  (WWW.CONF.RSLIP)
+#define CNF_RCNT  (WWW.CONF.RCNT)
 
 #define COL_MODE (CNF_MODE==0? CRGB::Green : CRGB::Blue)
 
@@ -64,6 +139,307 @@ float PID_USEC = 1500;
 float IMU_PITCH = 0;
 float IMU_ROLL = 0;
 float IMU_RATE = 0;
+float PID_PHASE = 0;
+float PID_DELAY = 0;
+float CH1_JITTER = 0;
+float PWM_FREQ = 50;
+float IMU_SLIP = 0;
+float EST_USEC = 0;
+float POW_MHZ = 240;
+float POW_LOAD = 0;
+float POW_MARGIN = 0;
+float POW_MA = 0;
+float WDG_MISS = 0;
+float WDG_WORST = 0;
+float TLM_PKTS = 0;
+float TLM_DROP = 0;
+float TLM_USEC = 0;
+float VIB_HZ = 0;
+float VIB_AMP = 0;
+float NOTCH_HZ1 = 0;
+float NOTCH_HZ2 = 0;
+float FFT_USEC = 0;
+float ROLL_RATE = 0;
+float LINK_GLITCH = 0;
+float LINK_DROP = 0;
+float LINK_GAP = 0;
+float SYS_HEAP = 0;
+float SYS_BLOCK = 0;
+float SYS_DRIFT = 0;
+float SYS_STACK = 0;
+float CPU0_LOAD = 0;
+float CPU1_LOAD = 0;
+float REC_CAPS = 0;
+
+
+// TLM: one sample per control step (copy to the ring, sent by the TLM task)
+void tlm_put(bool edge, bool fallback)
+{
+  if (!TLM.isActive()) return;
+  TelemetrySample S;
+  S.time = micros();
+  S.ch1 = CH1_USEC;
+  S.out = (CH1_USEC>0? PID_USEC: CH1_USEC);
+  S.rate = constrain(10*IMU_RATE, -32767, 32767);
+  S.roll = 100*IMU_ROLL;
+  S.pitch = 100*IMU_PITCH;
+  S.slip = 100*IMU_SLIP;
+  S.loop = PID_LOOP;
+  S.flags = (edge? TELEMETRY_EDGE: 0) | (fallback? TELEMETRY_FALLBACK: 0) | (RX_LIVE? 0: TELEMETRY_NOINPUT);
+  TLM.put(S);
+}
+
+// REC: offered each control step (sampled at REC_HZ by time), triggers by deadline and dropout
+//  deadline: steps missed by the supervisor while the link is up (not the no-input timeouts of PID_TASK)
+void rec_put(bool edge, bool fallback)
+{
+  static int lastMissed = 0;
+  static bool lastLive = true;
+  int missed = WATCH.getMissed();
+  if (missed != lastMissed && lastLive && RX_LIVE) REC.trigger(REC_DEADLINE);
+  if (lastLive && !RX_LIVE) REC.trigger(REC_DROPOUT);
+  lastMissed = missed;
+  lastLive = RX_LIVE;
+  //
+  FlightSample S;
+  S.time = micros();
+  S.ch1 = CH1_USEC;
+  S.ch3 = 0;
+  for (int i=0; i<3; i++) {
+    S.gyro[i] = constrain(10*GYRO[i], -32767, 32767);
+    S.accl[i] = constrain(1000*ACCL[i], -32767, 32767);
+  }
+  S.rate = constrain(10*IMU_RATE, -32767, 32767);
+  S.slip = 100*IMU_SLIP;
+  S.roll = 100*IMU_ROLL;
+  S.pitch = 100*IMU_PITCH;
+  S.p = constrain(10*PID_CH1.PID.getP(), -32767, 32767);
+  S.i = constrain(10*PID_CH1.PID.getI(), -32767, 32767);
+  S.d = constrain(10*PID_CH1.PID.getD(), -32767, 32767);
+  S.out = (CH1_USEC>0? PID_USEC: CH1_USEC);
+  S.duty = PWM_IO.getDuty(0);
+  S.flags = (edge? TELEMETRY_EDGE: 0) | (fallback? TELEMETRY_FALLBACK: 0) | (RX_LIVE? 0: TELEMETRY_NOINPUT);
+  REC.put(S);
+  REC_CAPS = REC.getCount();
+}
+size_t rec_csv(Print& out) { return REC.printCSV(out); }
+
+// REC: fixed sample rate whatever the control rate (750msec before and 500msec after the trigger)
+void rec_setup()
+{
+  REC.setup(REC_HZ,750,500);
+  REC.setLimits(CNF_RYAW,(CNF_EST? CNF_RSLIP: 0),CNF_RCNT,CNF_MEAN,CNF_REV);
+}
+
+// FAIL: CH1 while the link is lost (0:hold last, 1:pass no pulse, 2:neutral)
+float link_failsafe(float ch1)
+{
+  static float lastUsec = 0;
+  RX_LIVE = (ch1 > 0);
+  if (RX_LIVE) return (lastUsec = ch1);
+  switch (CNF_FAIL) {
+    case 0: return lastUsec;
+    case 2: return CNF_MEAN;
+    default: return 0;
+  }
+}
+
+// PID: the period control() runs at (SYNC: input frame /divider of RATE=1, without: hz by loop())
+//  ServoPID takes 50Hz or more, so a longer frame is computed as 20msec
+int pid_period(int hz)
+{
+  int period = CNF_SYNC? PID_TASK.getPeriod(RX_RATE.getPeriod()): 1000000/hz;
+  return min(period, 20000);
+}
+// PID: gains, predictor and timing by that period
+void pid_setup(int hz)
+{
+  PID_CH1.setup(CNF_KP,CNF_KI,CNF_KD,CNF_MIN,CNF_MEAN,CNF_MAX,1000000/pid_period(hz));
+  PID_CH1.setTimer(CNF_SYNC);
+  PID_CH1.setPredictor(CNF_SPD,CNF_SPS,CNF_SPT,CNF_SPG,CNF_FF);
+}
+
+// CONTROL STEP: IMU -> PID -> PWM (from loop() or PID_TASK)
+void control()
+{
+  static unsigned long lastFall = 0;
+  POWER.begin();
+  unsigned long fall = rx_getFall(0);
+  bool edge = (fall != lastFall);
+  lastFall = fall;
+  if (edge) RX_RATE.put(fall);
+  // the period control() runs at: input frame (/divider of RATE=1) with SYNC, PID rate without
+  int period = PID_TASK.isActive()? PID_TASK.getPeriod(RX_RATE.getPeriod()): PID_CH1.SampleTimeUs;
+  // SYNC: PID follows the measured frame (>10% change, as RollCascade does)
+  if (PID_TASK.isActive() && RX_LIVE && abs(pid_period(PWM_FREQ) - (int)PID_CH1.SampleTimeUs) > (int)PID_CH1.SampleTimeUs/10) pid_setup(PWM_FREQ);
+  //
+  M5_AHRS.loop(GYRO,ACCL,AHRS);
+  LOOP_HZ.touch();
+  //
+  IMU_PITCH = AHRS[0];
+  IMU_ROLL = AHRS[1];
+  IMU_RATE = VIB.loop(GYRO[2]);
+  CH1_FREQ = rx_getFreq(0);
+  CH1_USEC = link_failsafe(rx_getUsec(0));
+  PID_LOOP = LOOP_HZ.getFreq();
+  //
+  if (CNF_EST) {
+    // steering command of the last output, signed as yaw rate
+    float steer = (PID_USEC > 0 && CNF_MAX > CNF_MEAN)? (PID_USEC - CNF_MEAN)/float(CNF_MAX - CNF_MEAN): 0.0;
+    YAW_EKF.loop(IMU_RATE, ACCL[1], (CNF_REV? -steer: steer));
+    IMU_RATE = YAW_EKF.getRate();
+    IMU_SLIP = YAW_EKF.getSlip();
+    EST_USEC = YAW_EKF.getUsec();
+  }
+  //
+  if (CNF_MODE == 0) {
+    PID_USEC = PID_CH1.loop(CH1_USEC, CNF_KG*(CNF_REV? -IMU_RATE: IMU_RATE));
+  } else
+  if (CNF_MODE == 1) {
+    // roll angle -> roll rate setpoint -> servo (inner loop at every IMU sample)
+    PID_USEC = STUNT.loop(CH1_USEC, IMU_ROLL, GYRO[1]);
+    ROLL_RATE = STUNT.getRate();
+  } else 
+  {
+    PID_USEC = CH1_USEC;
+  }
+  //
+  PWM_IO.putUsec(0, (CH1_USEC>0? PID_USEC: CH1_USEC));
+  if (edge && CNF_RATE) PWM_IO.lockPhase(0);
+  PID_PHASE = PWM_IO.getPhaseAt(0, fall);
+  PID_DELAY = PID_TASK.getDelay();
+  POWER.end(period);
+  // no input: ControlTask wakes by its 25msec timeout
+  bool fallback = WATCH.isFallback();
+  WATCH.tick(RX_LIVE? period: 25000);
+  tlm_put(edge, fallback);
+  rec_put(edge, fallback);
+}
+
+// SYNC: run control() at each CH1 falling edge or serial frame
+void sync_start()
+{
+  if (!CNF_SYNC) {
+    // wake loop() from POWER.idle() at each CH1 edge or frame
+    if (RX_PROTO) SRX_IO.notify(0,xTaskGetCurrentTaskHandle());
+    else PWM_IO.notify(0,xTaskGetCurrentTaskHandle());
+    return;
+  }
+  if (RX_PROTO) PID_TASK.start<SerialRx>(0);
+  else PID_TASK.start<PulsePort>(0);
+}
+
+// RATE: PWM/PID frequency by hand (FREQ) or by receiver frame rate
+void rate_setup(int freq, int mult)
+{
+  PID_TASK.stop();
+  PWM_IO.putFreq(0,freq);
+  PID_TASK.setDivider(mult,RX_RATE.getPeriod());
+  pid_setup(freq);
+  // outer roll loop at the servo frame rate (FREQ until RATE locks, not the PID rate)
+  STUNT.setup(CNF_AKP,CNF_AKI,CNF_RKP,CNF_RKI,CNF_RKD,CNF_MIN,CNF_MEAN,CNF_MAX,freq);
+  PWM_FREQ = freq;
+  rec_setup();
+  sync_start();
+}
+// POWER: clock by deadline margin, sleep without CH1, wait for the next step
+void power_loop()
+{
+  // no light sleep or slow clock while sending telemetry (WiFi)
+  bool radio = WWW.isWake() || TLM.isActive();
+  POWER.loop(radio);
+  POW_MHZ = POWER.getMhz();
+  POW_LOAD = POWER.getLoad();
+  POW_MARGIN = POWER.getMargin();
+  POW_MA = POWER.getMilliAmps();
+  // no sleep with serial receiver (idle line level)
+  if (!RX_PROTO && POWER.isLost(RX_LIVE, radio)) {
+    WATCH.stop();
+    PWM_IO.detach();
+    POWER.sleep(GRV_PIN[0]);
+    PWM_IO.attach();
+    WATCH.start();
+  }
+  // SYNC: control() runs in PID_TASK, loop() sleeps a tick
+  if (PID_TASK.isActive()) POWER.idle(micros() + 2000);
+  else POWER.idle(PID_CH1.lastTime + PID_CH1.SampleTimeUs);
+}
+
+// WATCH: timing violations to the serial log (tagged by cause) in every 1sec
+void watch_loop()
+{
+  WDG_MISS = WATCH.getMissed();
+  if (!WATCH_CHECK.isUp(1000)) return;
+  WDG_WORST = WATCH.getWorst();
+  WATCH.report(DEBUG);
+  TLM_PKTS = TLM.getPackets();
+  TLM_DROP = TLM.getDropped();
+  TLM_USEC = TLM.getUsec();
+}
+
+// VIB: vibration peaks and notch centers to monitor (spectrum at /api/spectrum)
+void vib_loop()
+{
+  VIB_HZ = VIB.getPeak(0);
+  VIB_AMP = VIB.getAmp();
+  NOTCH_HZ1 = VIB.getNotch(0);
+  NOTCH_HZ2 = VIB.getNotch(1);
+  FFT_USEC = VIB.getUsec();
+}
+size_t vib_json(Print& out) { return VIB.printJSON(out); }
+
+// LINK: glitches, dropouts and frame interval histogram of CH1 in every 1sec (at /api/link)
+void link_loop()
+{
+  if (!LINK_CHECK.isUp(1000)) return;
+  LinkHealth& link = rx_getLink(0);
+  link.roll();
+  LINK_GLITCH = link.glitches;
+  LINK_DROP = link.dropouts;
+  LINK_GAP = link.worstUs;
+}
+size_t link_json(Print& out) { return rx_getLink(0).printJSON(out); }
+
+// SYS: heap, least free stack of tasks and CPU load per core in every 1sec (at /api/sys)
+void sys_loop()
+{
+  if (!SYS_CHECK.isUp(1000)) return;
+  ResourceMonitor::sample();
+  SYS_HEAP = ResourceMonitor::heapFree;
+  SYS_BLOCK = ResourceMonitor::heapBlock;
+  SYS_DRIFT = ResourceMonitor::getDrift();
+  SYS_STACK = ResourceMonitor::getStack();
+  CPU0_LOAD = ResourceMonitor::load[0];
+  CPU1_LOAD = ResourceMonitor::load[1];
+}
+size_t sys_json(Print& out) { return ResourceMonitor::printJSON(out); }
+
+// FACE: blink (LED=0) or telemetry snapshot drawn by the LED task (LED=1-3)
+void face_loop()
+{
+  if (M5_FACE.getMode() == 0) {
+    if (rx_getLink(0).isDown()) M5_FACE.blink(CRGB::Red, 100);
+    else M5_FACE.blink(COL_MODE, (abs(IMU_ROLL) > 30? 200: 500));
+    return;
+  }
+  LEDTelemetry T;
+  float span = CNF_MAX - CNF_MEAN;
+  T.steer = (CH1_USEC > 0 && span > 0)? (PID_USEC - CH1_USEC)/span: 0.0;
+  T.stick = (CH1_USEC > 0 && span > 0)? (CH1_USEC - CNF_MEAN)/span: 0.0;
+  T.loopHz = PID_LOOP;
+  T.targetHz = 1000000.0/PID_CH1.SampleTimeUs;
+  T.missed = WATCH.getMissed();
+  T.slip = IMU_SLIP;
+  M5_FACE.put(T);
+}
+
+// auto: highest multiple of frame rate within FREQ (max of servo) and MAX pulse
+void rate_update()
+{
+  int mult = RX_RATE.getMult(CNF_FREQ,CNF_MAX);
+  int freq = RX_RATE.getHz(mult);
+  if (freq >= 50 && abs(freq - PWM_FREQ) > 1) rate_setup(freq,mult);
+}
 
 
 void setup()
@@ -85,21 +461,96 @@ void setup()
   WWW.lookFloat("IMU_RATE",&IMU_RATE);
   WWW.lookFloat("PID_LOOP",&PID_LOOP);  
   WWW.lookFloat("PID_USEC",&PID_USEC);
+  WWW.lookFloat("PID_PHASE",&PID_PHASE);
+  WWW.lookFloat("PID_DELAY",&PID_DELAY);
+  WWW.lookFloat("CH1_JITTER",&CH1_JITTER);
+  WWW.lookFloat("PWM_FREQ",&PWM_FREQ);
+  WWW.lookFloat("IMU_SLIP",&IMU_SLIP);
+  WWW.lookFloat("EST_USEC",&EST_USEC);
+  WWW.lookFloat("POW_MHZ",&POW_MHZ);
+  WWW.lookFloat("POW_LOAD",&POW_LOAD);
+  WWW.lookFloat("POW_MARGIN",&POW_MARGIN);
+  WWW.lookFloat("POW_MA",&POW_MA);
+  WWW.lookFloat("WDG_MISS",&WDG_MISS);
+  WWW.lookFloat("WDG_WORST",&WDG_WORST);
+  WWW.lookFloat("TLM_PKTS",&TLM_PKTS);
+  WWW.lookFloat("TLM_DROP",&TLM_DROP);
+  WWW.lookFloat("TLM_USEC",&TLM_USEC);
+  WWW.lookFloat("VIB_HZ",&VIB_HZ);
+  WWW.lookFloat("VIB_AMP",&VIB_AMP);
+  WWW.lookFloat("NOTCH_HZ1",&NOTCH_HZ1);
+  WWW.lookFloat("NOTCH_HZ2",&NOTCH_HZ2);
+  WWW.lookFloat("FFT_USEC",&FFT_USEC);
+  WWW.lookFloat("ROLL_RATE",&ROLL_RATE);
+  WWW.lookFloat("LINK_GLITCH",&LINK_GLITCH);
+  WWW.lookFloat("LINK_DROP",&LINK_DROP);
+  WWW.lookFloat("LINK_GAP",&LINK_GAP);
+  WWW.lookJson("/api/spectrum",vib_json);
+  WWW.lookFloat("SYS_HEAP",&SYS_HEAP);
+  WWW.lookFloat("SYS_BLOCK",&SYS_BLOCK);
+  WWW.lookFloat("SYS_DRIFT",&SYS_DRIFT);
+  WWW.lookFloat("SYS_STACK",&SYS_STACK);
+  WWW.lookFloat("CPU0_LOAD",&CPU0_LOAD);
+  WWW.lookFloat("CPU1_LOAD",&CPU1_LOAD);
+  WWW.lookJson("/api/link",link_json);
+  WWW.lookJson("/api/sys",sys_json);
+  WWW.lookFloat("REC_CAPS",&REC_CAPS);
+  WWW.lookJson("/api/rec",rec_csv,"text/csv");
+  POWER.setup(CNF_POW);
+  M5_FACE.setMode(CNF_LED);
 
-  // AHRS
-  M5_AHRS.setup(1000,CNF_AXIS);
+  // AHRS (cached bias if still, or full calibration)
+  M5_AHRS.setup(1000,CNF_AXIS,true);
   
-  // PID
-  PID_CH1.setup(CNF_KP,CNF_KI,CNF_KD,CNF_MIN,CNF_MEAN,CNF_MAX,400);
+  // PID (400Hz by loop(), or by the input frame with SYNC)
+  pid_setup(400);
+  STUNT.setup(CNF_AKP,CNF_AKI,CNF_RKP,CNF_RKI,CNF_RKD,CNF_MIN,CNF_MEAN,CNF_MAX,CNF_FREQ);
+  STUNT.setHold(CNF_ROLL,CNF_REV);
+  VIB.setup(CNF_NOTCH);
 
   // GPIO
+  RX_PROTO = CNF_RX;
 #if 1
-  PWM_IO.setupIn(GRV_PIN[0]);
+  if (!RX_PROTO || !SRX_IO.setup(RX_PROTO,GRV_PIN[0])) {
+    RX_PROTO = 0;
+    PWM_IO.setupIn(GRV_PIN[0]);
+    PWM_IO.setWindow(0,CNF_MIN-200,CNF_MAX+200);
+  }
   PWM_IO.setupOut(GRV_PIN[1],CNF_FREQ);
+  PWM_FREQ = CNF_FREQ;
 #else
-  PWM_IO.setupIn(BTM_PIN[0]);
+  if (!RX_PROTO || !SRX_IO.setup(RX_PROTO,BTM_PIN[0])) {
+    RX_PROTO = 0;
+    PWM_IO.setupIn(BTM_PIN[0]);
+    PWM_IO.setWindow(0,CNF_MIN-200,CNF_MAX+200);
+  }
   PWM_IO.setupOut(BTM_PIN[1],CNF_FREQ);
+  PWM_FREQ = CNF_FREQ;
 #endif
+  // output curve: end points, neutral, subtrim, expo and speed
+  PWM_IO.setShape(0,CNF_MIN,CNF_MEAN,CNF_MAX,CNF_TRIM,CNF_EXPO,CNF_SLEW);
+
+  // WATCH (fallback output while control stalls)
+  WATCH.setMode(CNF_SAFE,CNF_MEAN);
+  WATCH.setup(rx_getUsec,PulsePort::putUsec);
+
+  // TLM (WiFi STA, shares the radio with the config AP)
+  TLM.setup(CNF_TLM);
+
+  // REC
+  rec_setup();
+
+  // SYNC
+  PID_TASK.setup(control);
+  sync_start();
+
+  // SYS (tasks by their handles, created on demand)
+  ResourceMonitor::setup();
+  ResourceMonitor::watch("control",PID_TASK.getTask());
+  ResourceMonitor::watch("fft",VIB.getTask());
+  ResourceMonitor::watch("led",M5_FACE.getTask());
+  ResourceMonitor::watch("tlm",TLM.getTask());
+  ResourceMonitor::watch("timer",xTaskGetHandle("esp_timer"));
 
 }
 
@@ -107,58 +558,77 @@ void loop()
 {
 
   // put your main code here, to run repeatedly:
-  M5_AHRS.loop(GYRO,ACCL,AHRS);
-  LOOP_HZ.touch();
-  //
-  IMU_PITCH = AHRS[0];
-  IMU_ROLL = AHRS[1];
-  IMU_RATE = GYRO[2];
-  CH1_FREQ = PWM_IO.getFreq(0);
-  CH1_USEC = PWM_IO.getUsec(0);
-  PID_LOOP = LOOP_HZ.getFreq();
-  //
-  if (CNF_MODE == 0) {
-    PID_USEC = PID_CH1.loop(CH1_USEC, CNF_KG*(CNF_REV? -IMU_RATE: IMU_RATE));
-  } else
-  if (CNF_MODE == 1 && abs(IMU_ROLL) > 30) {
-    float DEL_ROLL = (IMU_ROLL>0? IMU_ROLL-CNF_ROLL: IMU_ROLL+CNF_ROLL);
-    PID_USEC = PID_CH1.loop(CH1_USEC, 10*CNF_KG*(CNF_REV? -DEL_ROLL: DEL_ROLL)); 
-  } else 
-  {
-    PID_USEC = CH1_USEC;
-  }
-  //
-  PWM_IO.putUsec(0, (CH1_USEC>0? PID_USEC: CH1_USEC));
-  M5_FACE.blink(COL_MODE, (abs(IMU_ROLL) > 30? 200: 500));
+  if (!PID_TASK.isActive()) control();
+  CH1_JITTER = RX_RATE.getJitter();
+  if (CNF_RATE && RATE_CHECK.isUp(1000)) rate_update();
+  face_loop();
+  vib_loop();
+  link_loop();
+  sys_loop();
+  watch_loop();
+  power_loop();
 
   // config
   M5.update();
   if (M5.Btn.wasPressed() & !WWW.isWake()) {
+    PID_TASK.stop();
+    // the last moments before the press (download at /api/rec)
+    REC.freeze(REC_BUTTON);
+    POWER.loop(true);
+    M5_FACE.setMode(0);
+    TLM.stop();
+    PWM_IO.setShape(0);
+    // PID preview in the config loop by its sample time (pid_setup() at the end)
+    PID_CH1.setTimer(false);
     WWW.start();
     while (WWW.isWake()) {
+      const char* tag = WATCH.cause("www");
       WWW.loop();
+      WATCH.cause(tag);
       //
       M5_AHRS.loop(GYRO,ACCL,AHRS);
       LOOP_HZ.touch();
       //
       IMU_PITCH = AHRS[0];
       IMU_ROLL = AHRS[1];
-      IMU_RATE = GYRO[2];
-      CH1_FREQ = PWM_IO.getFreq(0);
-      CH1_USEC = PWM_IO.getUsec(0);
+      IMU_RATE = VIB.loop(GYRO[2]);
+      vib_loop();
+      CH1_FREQ = rx_getFreq(0);
+      CH1_USEC = rx_getUsec(0);
       //PID_LOOP = LOOP_HZ.getFreq();
       PID_USEC = PID_CH1.loop(CH1_USEC,(CNF_REV? -CNF_KG*IMU_RATE: CNF_KG*IMU_RATE));
       //
       PWM_IO.putUsec(0, CH1_USEC);
+      WATCH.tick(1000000/CNF_FREQ);
       M5_FACE.blink(CRGB::Yellow,500);
       //
       M5.update();
       if (M5.Btn.wasPressed()) WWW.stop();
     };
-    PID_CH1.setup(CNF_KP,CNF_KI,CNF_KD,CNF_MIN,CNF_MEAN,CNF_MAX,400);
+    PID_TASK.setDivider(1,0);
+    pid_setup(400);
+    STUNT.setup(CNF_AKP,CNF_AKI,CNF_RKP,CNF_RKI,CNF_RKD,CNF_MIN,CNF_MEAN,CNF_MAX,CNF_FREQ);
+    STUNT.setHold(CNF_ROLL,CNF_REV);
     PWM_IO.putFreq(0,CNF_FREQ);
-    M5_AHRS.setup(1000,CNF_AXIS);
+    PWM_IO.setShape(0,CNF_MIN,CNF_MEAN,CNF_MAX,CNF_TRIM,CNF_EXPO,CNF_SLEW);
+    PWM_FREQ = CNF_FREQ;
+    WATCH.cause("calib");
+    M5_AHRS.setup(1000,CNF_AXIS,true);
+    WATCH.cause(NULL);
+    YAW_EKF.setup();
+    VIB.setup(CNF_NOTCH);
+    WATCH.setMode(CNF_SAFE,CNF_MEAN);
+    POWER.setup(CNF_POW);
+    M5_FACE.setMode(CNF_LED);
+    TLM.setup(CNF_TLM);
+    rec_setup();
     DEBUG.print("AXIS = "); DEBUG.println(CNF_AXIS);
+    DEBUG.print("CALIB = "); DEBUG.println(M5_AHRS.isFAST()? "cache": "full");
+    // receiver input pin is switched only by reboot
+    if (CNF_RX != RX_PROTO) ESP.restart();
+    sync_start();
+    // heap after WiFi AP off as the new base of SYS_DRIFT
+    ResourceMonitor::rebase();
   }
 
 }
@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5Atom
+// GyroM5Atom system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+#ifndef RXDECODER_HPP
+#define RXDECODER_HPP
+
+#include <stdint.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+// class RxDecoder{}: シリアル受信機プロトコルの復号（SBUS/iBUS/CRSF）
+//  Arduinoに依存しないのでホストでも記録データで確認できる
+//  setup(): プロトコルの選択
+//  put(): 1バイト入力（フレーム完成でtrue）
+//  idle(): 無通信区間の検出（フレーム境界）
+//  getUsec(): チャネルのパルス幅[usec]
+//  getChannels(): チャネル数
+//  isFailsafe(): 受信機フェイルセーフの有無
+//  getFrames(): 正常フレーム数
+//  getErrors(): 異常フレーム数
+////////////////////////////////////////////////////////////////////////////////
+class RxDecoder {
+public:
+  enum { NONE = 0, SBUS = 1, IBUS = 2, CRSF = 3 };
+  static const int MAX = 16;  // max of channels
+  static const int SIZE = 64; // max of frame bytes
+
+  // baud rate of protocol
+  static long getBaud(int proto) {
+    switch (proto) {
+      case SBUS: return 100000;
+      case IBUS: return 115200;
+      case CRSF: return 420000;
+      default: return 0;
+    }
+  }
+
+private:
+  int proto;
+  int pos;
+  uint8_t buf[SIZE];
+  uint16_t usec[MAX];
+  int channels;
+  bool failsafe;
+  unsigned long frames;
+  unsigned long errors;
+
+  // 11bit value of SBUS/CRSF (172-1811) to usec (988-2012)
+  static uint16_t toUsec11(uint16_t v) { return (5*v)/8 + 880; }
+
+  // 16 channels packed in 22 bytes by 11bit LSB first
+  void unpack11(const uint8_t* p) {
+    uint32_t bits = 0;
+    int nbit = 0;
+    int ch = 0;
+    for (int i=0; i<22 && ch<MAX; i++) {
+      bits |= ((uint32_t)p[i]) << nbit;
+      nbit += 8;
+      if (nbit >= 11) {
+        usec[ch++] = toUsec11(bits & 0x07FF);
+        bits >>= 11;
+        nbit -= 11;
+      }
+    }
+    channels = MAX;
+  }
+
+  static uint8_t crc8(const uint8_t* p, int n) {
+    uint8_t crc = 0;
+    for (int i=0; i<n; i++) {
+      crc ^= p[i];
+      for (int b=0; b<8; b++) crc = (crc & 0x80)? (crc << 1) ^ 0xD5: (crc << 1);
+    }
+    return crc;
+  }
+
+  bool error(void) {
+    errors++;
+    pos = 0;
+    return false;
+  }
+
+  // SBUS: 0x0F, 22 bytes of channels, flags, 0x00 (or SBUS2 0x?4)
+  bool putSBUS(uint8_t b) {
+    if (pos == 0 && b != 0x0F) return false;
+    buf[pos++] = b;
+    if (pos < 25) return false;
+    pos = 0;
+    if (b != 0x00 && (b & 0x0F) != 0x04) return error();
+    unpack11(&buf[1]);
+    failsafe = (buf[23] & 0x08) != 0;
+    frames++;
+    return true;
+  }
+
+  // iBUS: 0x20, 0x40, 14 channels in uint16 LE, checksum = 0xFFFF - sum
+  bool putIBUS(uint8_t b) {
+    if (pos == 0 && b != 0x20) return false;
+    if (pos == 1 && b != 0x40) return error();
+    buf[pos++] = b;
+    if (pos < 32) return false;
+    pos = 0;
+    uint16_t sum = 0xFFFF;
+    for (int i=0; i<30; i++) sum -= buf[i];
+    if (sum != (buf[30] | (buf[31] << 8))) return error();
+    for (int ch=0; ch<14; ch++) usec[ch] = (buf[2+2*ch] | (buf[3+2*ch] << 8)) & 0x0FFF;
+    channels = 14;
+    failsafe = false;
+    frames++;
+    return true;
+  }
+
+  // CRSF: address, length, type, payload, crc8 (type and payload)
+  bool putCRSF(uint8_t b) {
+    if (pos == 0 && b != 0xC8 && b != 0xEE && b != 0xEA && b != 0xEC) return false;
+    if (pos == 1 && (b < 2 || b > SIZE-2)) return error();
+    buf[pos++] = b;
+    if (pos < 2 || pos < buf[1] + 2) return false;
+    pos = 0;
+    if (crc8(&buf[2], buf[1]-1) != b) return error();
+    if (buf[2] != 0x16 || buf[1] != 24) return false; // not RC channels
+    unpack11(&buf[3]);
+    failsafe = false;
+    frames++;
+    return true;
+  }
+
+public:
+  RxDecoder() {
+    setup(NONE);
+  }
+  void setup(int p) {
+    proto = p;
+    pos = 0;
+    channels = 0;
+    failsafe = false;
+    frames = 0;
+    errors = 0;
+    for (int ch=0; ch<MAX; ch++) usec[ch] = 0;
+  }
+  bool put(uint8_t b) {
+    switch (proto) {
+      case SBUS: return putSBUS(b);
+      case IBUS: return putIBUS(b);
+      case CRSF: return putCRSF(b);
+      default: return false;
+    }
+  }
+  void idle(void) {
+    if (pos > 0) error();
+  }
+  int getUsec(int ch) const { return (ch >= 0 && ch < channels)? usec[ch]: -1; }
+  int getChannels(void) const { return channels; }
+  int getProtocol(void) const { return proto; }
+  bool isFailsafe(void) const { return failsafe; }
+  unsigned long getFrames(void) const { return frames; }
+  unsigned long getErrors(void) const { return errors; }
+};
+
+#endif
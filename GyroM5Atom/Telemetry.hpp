@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5Atom
+// GyroM5Atom system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+#ifndef TELEMETRY_HPP
+#define TELEMETRY_HPP
+
+#include <stdint.h>
+#include <string.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Telemetry: 走行データのUDPパケット形式（車載の送信とホストの受信で共通）
+//  Arduinoに依存しないのでホストの collector/simcar でもそのまま使う
+//  1パケット = ヘッダ16バイト + サンプル20バイト x 1-32（リトルエンディアン）
+//  seq はパケットごとに1増える（欠落と順序の確認）、sent は送信時の車載時計
+//
+// class TelemetryPacker{}: パケットの組立て
+//  setup(): 車両IDと番号の初期化
+//  add(): サンプルの追加（満杯でfalse）
+//  finish(): ヘッダを書いてパケット長を返す（次のパケットへ）
+//  data(): パケットの先頭
+// telemetryParse(): 受信パケットの検査と分解（不正ならfalse）
+////////////////////////////////////////////////////////////////////////////////
+#define TELEMETRY_MAGIC   0x3547  // "G5"
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_PORT    5005
+
+// sample flags
+#define TELEMETRY_EDGE      0x01  // input edge (or serial frame) at this step
+#define TELEMETRY_FALLBACK  0x02  // Supervisor fallback output before this step
+#define TELEMETRY_NOINPUT   0x04  // no input pulse
+
+typedef struct __attribute__((packed)) {
+  uint16_t magic;
+  uint8_t version;
+  uint8_t count;    // number of samples
+  uint32_t car;     // car id (lower 32bit of MAC)
+  uint32_t seq;     // packet number
+  uint32_t sent;    // car clock at send [usec]
+} TelemetryHeader;
+
+typedef struct __attribute__((packed)) {
+  uint32_t time;    // car clock [usec]
+  int16_t ch1;      // input pulse [usec]
+  int16_t out;      // output pulse [usec]
+  int16_t rate;     // yaw rate [0.1 deg/sec]
+  int16_t roll;     // [0.01 deg]
+  int16_t pitch;    // [0.01 deg]
+  int16_t slip;     // drift angle [0.01 deg]
+  uint16_t loop;    // control rate [Hz]
+  uint16_t flags;   // TELEMETRY_*
+} TelemetrySample;
+
+class TelemetryPacker {
+public:
+  static const int MAX = 32;  // samples per packet (656 bytes)
+  static const int SIZE = sizeof(TelemetryHeader) + MAX*sizeof(TelemetrySample);
+
+private:
+  uint8_t buf[SIZE];
+  int count;
+  uint32_t car;
+  uint32_t seq;
+
+public:
+  TelemetryPacker() { setup(0); }
+  void setup(uint32_t car_) {
+    car = car_;
+    seq = 0;
+    count = 0;
+  }
+  bool add(const TelemetrySample& s) {
+    if (count >= MAX) return false;
+    memcpy(buf + sizeof(TelemetryHeader) + count*sizeof(TelemetrySample), &s, sizeof(s));
+    count++;
+    return true;
+  }
+  int size(void) const { return count; }
+  int finish(uint32_t now) {
+    TelemetryHeader h;
+    h.magic = TELEMETRY_MAGIC;
+    h.version = TELEMETRY_VERSION;
+    h.count = count;
+    h.car = car;
+    h.seq = seq++;
+    h.sent = now;
+    memcpy(buf, &h, sizeof(h));
+    int n = sizeof(TelemetryHeader) + count*sizeof(TelemetrySample);
+    count = 0;
+    return n;
+  }
+  const uint8_t* data(void) const { return buf; }
+};
+
+// samples point into the packet (copy before reuse of the buffer)
+inline bool telemetryParse(const uint8_t* p, int n, TelemetryHeader& h, const TelemetrySample*& s) {
+  if (n < (int)sizeof(TelemetryHeader)) return false;
+  memcpy(&h, p, sizeof(h));
+  if (h.magic != TELEMETRY_MAGIC || h.version != TELEMETRY_VERSION) return false;
+  if (h.count > TelemetryPacker::MAX) return false;
+  if (n != (int)(sizeof(TelemetryHeader) + h.count*sizeof(TelemetrySample))) return false;
+  s = (const TelemetrySample*)(p + sizeof(TelemetryHeader));
+  return true;
+}
+
+#endif
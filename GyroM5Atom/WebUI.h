@@ -0,0 +1,168 @@
+////////////////////////////////////////////////////////////////////////////////
+// WebUI.h: 設定画面（gzip圧縮済み）
+//  tools/webgz で html/*.html から生成（直接編集しない）
+////////////////////////////////////////////////////////////////////////////////
+#ifndef WEBUI_H
+#define WEBUI_H
+
+// index.html: 5378 -> 1949 bytes
+const char WEBUI_INDEX_ETAG[] = "\"0c42a750\"";
+const size_t WEBUI_INDEX_LEN = 1949;
+const uint8_t WEBUI_INDEX[] PROGMEM = {
+ 0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0x9d,0x58,0x7b,0x6f,0xdb,0x36,
+ 0x10,0xff,0xdf,0x9f,0x82,0xc3,0x80,0x52,0x6a,0x6c,0x4b,0x96,0xd3,0xa1,0x98,0x1f,
+ 0x40,0x96,0xa6,0x4d,0x86,0x38,0x2d,0x1a,0x6f,0xe8,0x50,0x14,0x05,0x2d,0xd1,0x16,
+ 0x6b,0x59,0xd2,0x44,0x3a,0x8e,0xdb,0xe5,0xbb,0xef,0x8e,0x94,0x64,0x49,0x76,0x9c,
+ 0x6c,0x28,0x5a,0x97,0xc7,0x7b,0x3f,0x7e,0x3a,0x69,0xf8,0xd3,0x9b,0xf7,0xe7,0xd3,
+ 0xbf,0x3e,0x5c,0x90,0xcb,0xe9,0xe4,0x7a,0xdc,0x1a,0x86,0x6a,0x15,0xe1,0x0f,0x67,
+ 0x01,0xfc,0xac,0xb8,0x62,0x24,0x66,0x2b,0x3e,0xa2,0x77,0x82,0x6f,0xd2,0x24,0x53,
+ 0x94,0xf8,0x49,0xac,0x78,0xac,0x46,0x74,0x23,0x02,0x15,0x8e,0x02,0x7e,0x27,0x7c,
+ 0xde,0xd1,0x87,0xb6,0x88,0x85,0x12,0x2c,0xea,0x48,0x9f,0x45,0x7c,0xd4,0xa3,0xc4,
+ 0x01,0x2d,0x4a,0xa8,0x88,0x8f,0xdf,0x6d,0xb3,0x64,0xf2,0xea,0x4c,0x25,0xab,0xa1,
+ 0x63,0x28,0xad,0xa1,0x93,0xdb,0x99,0x25,0xc1,0x16,0x7e,0x52,0x22,0x82,0x11,0x65,
+ 0xdf,0xd8,0xfd,0xd7,0x48,0xc4,0x4b,0x3a,0x1e,0xce,0xc6,0x64,0x27,0x47,0x3e,0xb0,
+ 0x0c,0x7c,0x51,0x3c,0x93,0x64,0xe8,0xcc,0xc6,0x43,0x27,0x05,0xa1,0x79,0x92,0xad,
+ 0x08,0xf3,0x95,0x48,0xe2,0x11,0x95,0xec,0x8e,0x53,0x02,0x3c,0x61,0x02,0x9a,0x16,
+ 0x1c,0xdc,0x35,0xee,0x4b,0xae,0x94,0x88,0x17,0x14,0xdd,0x61,0x33,0x6d,0x5c,0x69,
+ 0xe3,0x43,0x95,0xc1,0xdf,0x70,0x2c,0x79,0xc4,0x7d,0x05,0xae,0x85,0xfa,0x88,0x52,
+ 0xe5,0xe1,0x8e,0x45,0xeb,0xdd,0x49,0x46,0x22,0xe0,0x59,0x79,0x5c,0x43,0xc8,0xe6,
+ 0xe0,0xa0,0x2a,0x47,0xe5,0x31,0x29,0x1d,0x14,0x9c,0xf3,0xe0,0x9c,0xc2,0xee,0x2c,
+ 0x83,0x7f,0x44,0x9c,0xae,0x15,0x51,0xdb,0x14,0x7c,0x0b,0x45,0x10,0xf0,0xb8,0xf0,
+ 0xf4,0xf7,0xdb,0x29,0x25,0xda,0xe2,0x88,0x7a,0xae,0xe7,0xb9,0xbf,0xf4,0xdd,0x9e,
+ 0xdb,0x87,0x3f,0x26,0x9b,0x55,0xc9,0xd9,0x5a,0xa9,0x24,0x2e,0xd9,0x27,0x57,0x37,
+ 0xce,0xe4,0xec,0x93,0x33,0xb9,0x38,0xbb,0x21,0xc3,0x0e,0x39,0xbf,0x84,0x0a,0x24,
+ 0xb1,0x1f,0x09,0x7f,0x39,0xa2,0x49,0x3c,0x11,0xf1,0x84,0xdd,0x5b,0xf6,0x93,0x8a,
+ 0x3e,0xbe,0xbf,0xbe,0x46,0x05,0x57,0x93,0x3f,0x6a,0x0a,0x3e,0x26,0x51,0x54,0x88,
+ 0xef,0x85,0x21,0xd7,0xb3,0x95,0x50,0x3b,0x67,0x4c,0xcd,0x40,0xcb,0xae,0x6c,0x35,
+ 0x65,0xb7,0x9a,0xbf,0x50,0xe7,0x60,0x1d,0xb1,0x07,0xca,0xa2,0x93,0x3f,0xc5,0x2c,
+ 0x63,0x58,0x57,0x72,0x9b,0x42,0x6d,0xb2,0xf5,0xca,0x94,0x5d,0xa6,0x2c,0xd6,0x9d,
+ 0x22,0x73,0xf2,0x57,0x11,0xcf,0x13,0xe8,0x16,0x07,0x6f,0xf2,0xb6,0xf0,0x59,0x7c,
+ 0xc7,0x64,0x8d,0x8d,0x12,0xd3,0xb1,0xb4,0xff,0xfa,0x94,0x92,0x90,0x8b,0x45,0x08,
+ 0x5d,0xdc,0xf3,0x5e,0x53,0x22,0xd5,0x36,0xc2,0x34,0x24,0x19,0x94,0xf6,0xd7,0x5e,
+ 0x7a,0x4f,0x64,0x02,0x65,0x26,0x3f,0xfb,0xbe,0x8f,0x8a,0x8d,0x36,0x74,0x33,0xaf,
+ 0xa6,0xf4,0x33,0x91,0xaa,0x71,0x2b,0xe2,0x8a,0x9c,0xbf,0xbf,0x79,0x7b,0xf5,0x8e,
+ 0x8c,0xc8,0x8f,0x87,0x41,0xcb,0x71,0x5a,0xf3,0x75,0xac,0xdb,0x11,0x82,0xbd,0x4e,
+ 0x58,0x60,0xd9,0xe4,0x47,0xeb,0x8e,0x65,0xe4,0x3e,0xcc,0x80,0x29,0xe6,0x1b,0xf2,
+ 0x69,0x72,0x7d,0xa9,0x54,0xfa,0x91,0xff,0xbd,0xe6,0x12,0x52,0x30,0x68,0xc1,0x5d,
+ 0x37,0x49,0x79,0x6c,0xd1,0x77,0x17,0x53,0xda,0xa6,0x0e,0x4b,0x85,0x03,0x93,0x36,
+ 0x17,0x0b,0x5a,0x5c,0xc7,0x11,0x68,0x03,0x0d,0x85,0x7e,0xad,0xb8,0x34,0xfe,0xfb,
+ 0xed,0xfb,0x9b,0x6e,0xca,0x32,0xc9,0x2d,0xe4,0xce,0xb8,0x4c,0x93,0x58,0x72,0x10,
+ 0x5e,0xb1,0x25,0x9f,0x62,0xf3,0xa1,0x21,0xa9,0x58,0xa6,0xce,0xbe,0x61,0x1b,0xe4,
+ 0x87,0x22,0xb9,0x48,0x78,0xc8,0x2d,0xf1,0x2c,0x4b,0xb2,0xa6,0x29,0x98,0xa1,0xa9,
+ 0x58,0xf1,0x64,0xad,0x2c,0x13,0x59,0xfb,0xf6,0x02,0xcc,0xbf,0x29,0xe5,0x24,0x8f,
+ 0x03,0xa3,0xa5,0x9a,0x85,0x8a,0x79,0x50,0x82,0x09,0xd3,0x23,0x01,0xda,0x83,0xc4,
+ 0x5f,0xaf,0x00,0x4a,0xba,0x30,0xa8,0x17,0x11,0xc7,0xff,0xca,0xdf,0xb6,0x53,0xb6,
+ 0xb8,0x81,0x7e,0xb1,0xa8,0x66,0xa3,0xf6,0x67,0xf7,0xcb,0xa0,0x05,0xdd,0x41,0x2c,
+ 0x94,0x5d,0xf2,0x2d,0x11,0x71,0x9e,0xf3,0x42,0x21,0x56,0x18,0xf4,0x19,0xe2,0x67,
+ 0x60,0x01,0x09,0xa4,0x67,0xc9,0xa6,0x6a,0xc6,0xcf,0x38,0x53,0x3c,0xb7,0x04,0xfa,
+ 0x33,0x4c,0xad,0xe3,0x90,0x8c,0x05,0x22,0xd1,0x02,0xbe,0x7b,0x8c,0x3f,0x40,0x7e,
+ 0x64,0x13,0xc7,0xd8,0xf4,0x4c,0x00,0x27,0x70,0x75,0x71,0x32,0x80,0x95,0x6a,0x0b,
+ 0x54,0x93,0x70,0xca,0x91,0x64,0x00,0xc7,0xd0,0xf4,0xc8,0x00,0x11,0x3c,0xd7,0x67,
+ 0x3f,0xe4,0xfe,0x92,0xeb,0x5a,0xb3,0x48,0xf2,0x41,0x4b,0xcc,0x89,0xf5,0x13,0x46,
+ 0xf9,0xf9,0xd5,0x17,0x1b,0x39,0x60,0x8e,0x42,0x16,0x2f,0x78,0xa3,0x46,0xd0,0x72,
+ 0xe7,0x9a,0x6e,0x09,0x17,0x3c,0x78,0x18,0x10,0x0e,0xf2,0x28,0x10,0x08,0x89,0x35,
+ 0x40,0x9d,0x50,0x6c,0x50,0xe9,0xbb,0x5d,0x96,0x42,0xc7,0x05,0xe7,0xa1,0x88,0x02,
+ 0xcd,0x8f,0xb9,0x40,0xf7,0x4c,0x2a,0x7a,0x4f,0xa6,0xc2,0xef,0xd5,0x54,0x34,0x98,
+ 0xa7,0xfc,0x5e,0xdd,0x24,0x01,0xb7,0x20,0x2a,0xdb,0x28,0xd7,0x71,0x1a,0xed,0xde,
+ 0xb3,0x12,0x2d,0x8f,0xb1,0xe1,0xb4,0x63,0x9e,0xa5,0xd7,0x15,0x41,0x91,0x3d,0x38,
+ 0x28,0x30,0x7c,0x6e,0x1e,0x52,0x40,0xd5,0x59,0xeb,0x43,0x43,0xf8,0x5e,0xcd,0x5b,
+ 0xe9,0x15,0xc5,0x87,0x74,0x19,0x9f,0xfa,0xcf,0x2b,0x7e,0xff,0x59,0xc5,0xef,0x57,
+ 0x8a,0x0f,0x16,0xa8,0x26,0xe5,0xc5,0x37,0x75,0xee,0x77,0x57,0xd0,0xc9,0xb9,0x87,
+ 0xd0,0xe4,0x9a,0xc2,0xee,0x0b,0x4a,0xcf,0x50,0xa4,0xe2,0x69,0x41,0xf2,0x0c,0xa9,
+ 0x68,0x97,0x22,0x34,0xa4,0xed,0xd5,0xb7,0xd1,0x32,0x7d,0x68,0x19,0x83,0xd6,0xd5,
+ 0x8e,0xc1,0x86,0xb9,0x42,0xaa,0x25,0xfa,0xba,0x5f,0x5a,0x7e,0xbf,0xde,0x16,0x7d,
+ 0x93,0xa5,0x80,0x1b,0xc4,0x03,0x29,0x93,0xab,0xd3,0xa7,0xbb,0xe3,0xf4,0x59,0xdd,
+ 0xa1,0x5d,0x3c,0xfd,0x62,0x3a,0xa4,0x05,0x13,0x5b,0x93,0xf2,0xb1,0x8d,0xf7,0x88,
+ 0xbd,0x43,0x44,0xef,0x10,0xb1,0x7f,0x88,0x78,0x0a,0xb6,0x34,0xb8,0xd4,0xc8,0xc0,
+ 0xa6,0xb1,0xeb,0xa1,0x81,0xe1,0x26,0x3f,0xba,0x88,0x88,0x37,0x98,0x57,0x7d,0x30,
+ 0xc5,0xac,0x60,0xd1,0x01,0x38,0xfb,0x6d,0x7b,0x15,0x54,0xb8,0xed,0x46,0x6f,0x9a,
+ 0x1b,0x5d,0xce,0x26,0x6a,0x06,0xc9,0x99,0x94,0x62,0x11,0xe3,0xf4,0xb4,0x81,0xa3,
+ 0x30,0xdd,0xc0,0xbf,0xc3,0x10,0xaa,0xf1,0x13,0xc7,0x0e,0xda,0xaa,0xec,0x96,0xc7,
+ 0xdc,0x43,0xbe,0x9a,0x5f,0xc0,0x0b,0x32,0x4d,0x87,0x00,0xfd,0xf1,0xb1,0x71,0x0d,
+ 0x8b,0x99,0xe5,0x27,0xda,0x9f,0xc7,0x34,0x56,0x56,0x38,0xbb,0xab,0x1f,0xad,0xdd,
+ 0x19,0xf3,0x97,0x8b,0x2c,0x59,0x43,0xb2,0x93,0x48,0x3f,0x5a,0x40,0xc7,0x60,0x2f,
+ 0xd7,0x39,0x78,0x69,0xb8,0x44,0x0b,0xc7,0x61,0x3f,0xcb,0x11,0xf0,0xe9,0x24,0x0c,
+ 0x1e,0x7d,0x4c,0x14,0x39,0x1d,0x8d,0xcc,0x63,0x20,0x4f,0xd7,0x0b,0xb2,0x9b,0x9d,
+ 0x1f,0x2d,0x53,0xa7,0xca,0x88,0xe5,0xb0,0xfc,0x60,0xe0,0xf5,0x00,0x83,0x99,0xc1,
+ 0x87,0x03,0xed,0x54,0x2c,0x61,0x79,0x0c,0x6b,0xa9,0x7d,0x7a,0x34,0x95,0xb0,0xc3,
+ 0x7d,0xfd,0x03,0x9e,0xb3,0xb4,0x56,0x23,0xe3,0xb7,0x96,0x1d,0x8e,0x88,0x6b,0x93,
+ 0x8c,0xab,0x75,0x16,0x0f,0x5a,0x06,0xee,0xcb,0x3b,0xd2,0x7b,0xe5,0xba,0x1d,0xef,
+ 0x95,0x6b,0xef,0x1a,0x0a,0xd7,0x44,0xda,0xc6,0x7b,0xbb,0xc9,0x3f,0xd6,0xfc,0x27,
+ 0x4d,0xfe,0xb3,0x4f,0x75,0xfe,0xca,0x15,0x6c,0x9a,0xe5,0x5d,0x33,0x52,0xb3,0x2d,
+ 0x16,0xb5,0x82,0xc3,0xb1,0x38,0x61,0xd5,0xfc,0x8a,0x6b,0xe7,0xa1,0x38,0x27,0x4c,
+ 0x85,0x5d,0x36,0x93,0x16,0x2a,0xb1,0x21,0xaa,0x7e,0x33,0xe2,0x9d,0x47,0x5a,0x47,
+ 0xbb,0x2e,0x71,0xc0,0xb7,0x62,0xf9,0x04,0xef,0x60,0xcb,0x92,0x8a,0xbc,0xf1,0xaa,
+ 0xc0,0x28,0xf1,0x59,0x6a,0x2c,0x10,0x8b,0xba,0xf4,0x44,0x42,0x23,0xc3,0xe2,0xca,
+ 0xad,0x8e,0x67,0x70,0x12,0x63,0x8a,0xf5,0x7a,0x81,0x0b,0xdd,0x1b,0x40,0x34,0xdc,
+ 0x7c,0x8e,0x74,0xa2,0x5e,0xec,0x6b,0x03,0x09,0xe2,0xc8,0xf7,0x76,0x1d,0x45,0x7f,
+ 0x71,0x96,0x81,0x33,0x27,0xe0,0x86,0x95,0x93,0x27,0x90,0x81,0xd0,0xb2,0x4f,0x7a,
+ 0x75,0xb2,0xb1,0x54,0xa7,0x5d,0x26,0xeb,0x4c,0x36,0x89,0xd0,0x67,0x6b,0xc5,0xf7,
+ 0xc8,0xb7,0x1c,0xe2,0x0d,0x90,0xfc,0xf8,0x52,0x85,0x39,0xaf,0x0c,0x09,0x0c,0x01,
+ 0xe4,0xdc,0x7b,0x16,0xd8,0x1c,0x98,0x11,0xcc,0xbc,0xc9,0xb1,0x59,0x17,0xe1,0xaa,
+ 0xe7,0xba,0x6e,0x7d,0x55,0xae,0xac,0xa5,0xff,0x67,0x5b,0xfe,0x26,0x93,0xb8,0xd8,
+ 0x93,0x01,0xa8,0x72,0xd6,0x4b,0x78,0x13,0xe3,0x19,0xcc,0x90,0x69,0xa6,0xce,0x14,
+ 0x1e,0xc8,0xc0,0x0d,0xa0,0x0f,0xa5,0xd4,0x6f,0x16,0x35,0xc1,0xc3,0x0b,0x36,0xe6,
+ 0x07,0xb9,0x8e,0xae,0xd8,0xcd,0x4c,0xa2,0x80,0x5d,0xc7,0x70,0x24,0xe9,0x74,0xe2,
+ 0xde,0xbd,0xdb,0xa4,0xcb,0xc0,0xf3,0x65,0xda,0xf1,0xcc,0x7d,0x89,0xb5,0x34,0x02,
+ 0x4e,0x5a,0xd9,0xcd,0x95,0x91,0x3c,0xb2,0x9d,0xef,0x74,0x7a,0x2f,0xcb,0x15,0xbd,
+ 0xa6,0x33,0xe3,0x01,0xfd,0x0f,0xeb,0xfe,0x7f,0x54,0xb8,0xf3,0xd0,0x30,0x0f,0x8e,
+ 0xbc,0x1d,0x04,0x19,0xdb,0x94,0x6f,0x20,0x08,0xb9,0x45,0xce,0xf3,0x17,0xb8,0x23,
+ 0x90,0x51,0xbe,0xd7,0xe5,0x8b,0x99,0xaf,0x70,0x77,0x32,0x72,0xc8,0xac,0xcb,0x7e,
+ 0x0f,0xfb,0x88,0x57,0xee,0x6e,0x9b,0x1d,0x83,0xf9,0x60,0x41,0xc2,0x1d,0xc5,0xbc,
+ 0x11,0xb6,0x49,0xb1,0x93,0x75,0xd9,0x2a,0xed,0x46,0x3c,0x5e,0xa8,0xd0,0x48,0xab,
+ 0x04,0x37,0x31,0x8d,0x2d,0xb0,0xa7,0x59,0xbd,0x76,0xf9,0x7f,0x5c,0x24,0xa2,0xad,
+ 0x15,0xc3,0x28,0xb7,0x4b,0x59,0x1c,0x31,0xf0,0xa9,0xeb,0x47,0x30,0xdd,0x1f,0xc1,
+ 0x57,0xcb,0x6d,0xbb,0xed,0x4d,0x3b,0xcc,0xe9,0x73,0x11,0x45,0xb7,0xf8,0x74,0xd4,
+ 0xaf,0x03,0x8a,0xf3,0x68,0x06,0xc0,0x40,0xab,0xdd,0x04,0x37,0xee,0x00,0x7e,0x86,
+ 0x24,0x86,0x9f,0x93,0x93,0x22,0x39,0xf8,0xf6,0x14,0xbe,0x2c,0x0c,0x7d,0x5e,0x7e,
+ 0x71,0xc0,0xb7,0x9d,0x56,0x6d,0x6c,0xf9,0x72,0xe3,0xc4,0x10,0x60,0x67,0xdb,0xae,
+ 0xfa,0x0c,0xc4,0x4e,0xcf,0x6e,0x93,0xad,0x2e,0xc5,0x9e,0x1f,0x58,0xc8,0x8a,0x07,
+ 0xe1,0x77,0x92,0xcc,0x4d,0x44,0x71,0xa2,0xfc,0xd0,0x80,0x03,0x50,0xc7,0xc4,0x25,
+ 0x2f,0x5e,0x98,0x9b,0x60,0x8e,0x47,0x9b,0xd4,0xcc,0x87,0xdf,0x9d,0xfc,0xd2,0xf8,
+ 0xe1,0xb6,0x89,0x07,0xde,0xe4,0x85,0x48,0x39,0x5b,0xca,0x22,0xcf,0xfa,0x80,0x92,
+ 0x0a,0xa6,0xb5,0xec,0xc1,0xb4,0x82,0xc1,0x29,0x60,0x0b,0xda,0x00,0xe8,0xb5,0x21,
+ 0x8e,0xf4,0x08,0xd7,0x09,0xa1,0x97,0xdf,0x29,0x32,0x0e,0x5a,0x4f,0xb6,0x8e,0xf9,
+ 0x72,0xd0,0x5c,0xcb,0x28,0x71,0x3b,0x14,0x14,0xe9,0x7e,0xec,0xce,0x25,0xcc,0x64,
+ 0x57,0x25,0x6f,0xc5,0x3d,0x0f,0x2c,0xd7,0x36,0x16,0xda,0x04,0x57,0x75,0xe4,0x82,
+ 0xcc,0x97,0xb7,0x1a,0xac,0x69,0xc0,0x17,0x0e,0x3c,0x12,0xdb,0x79,0x94,0x5a,0x95,
+ 0x89,0xf1,0x5b,0x22,0x00,0xb4,0x08,0xb5,0xc9,0x3f,0xff,0x10,0xda,0xa1,0x7b,0xe3,
+ 0xd0,0x78,0x23,0xff,0xbf,0x5f,0x0e,0xaa,0xa3,0x71,0x1c,0xda,0xf2,0x9d,0xe8,0x71,
+ 0x68,0xc3,0x7a,0xeb,0x3c,0xac,0x60,0x5b,0x37,0x75,0xde,0x9f,0xd9,0x7d,0x48,0x2b,
+ 0xee,0x9b,0xdf,0x08,0x9e,0x09,0x36,0xa5,0x78,0x05,0x70,0x9e,0x0d,0x2e,0x1b,0x11,
+ 0x07,0xf0,0xb4,0x2b,0x83,0x2e,0xbe,0xc3,0x0c,0x5a,0x43,0xa7,0xf8,0x70,0x33,0x74,
+ 0xcc,0xa7,0xce,0x7f,0x01,0x9a,0x08,0x59,0xf7,0x02,0x15,0x00,0x00,
+};
+
+// save.html: 580 -> 405 bytes
+const char WEBUI_SAVE_ETAG[] = "\"52d568f5\"";
+const size_t WEBUI_SAVE_LEN = 405;
+const uint8_t WEBUI_SAVE[] PROGMEM = {
+ 0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0x55,0x52,0xc1,0x6e,0xd4,0x30,
+ 0x10,0xbd,0xe7,0x2b,0xa6,0x27,0x67,0x45,0x9b,0xd0,0x03,0x17,0x92,0xac,0x04,0x4b,
+ 0x05,0x42,0x5b,0xa8,0xe8,0x72,0x40,0x55,0x0f,0xc6,0x9e,0xec,0x5a,0x4c,0xec,0x28,
+ 0x9e,0x6c,0x88,0x68,0xff,0x9d,0x71,0xba,0x2b,0x81,0x2c,0x79,0x3c,0xb6,0xdf,0xbc,
+ 0x37,0xcf,0xae,0x2f,0x3e,0x7c,0xdd,0xec,0x7e,0xdc,0xdd,0xc0,0xa7,0xdd,0xed,0x76,
+ 0x9d,0xd5,0x07,0xee,0x28,0x05,0xd4,0x56,0x42,0x87,0xac,0xc1,0xeb,0x0e,0x1b,0x75,
+ 0x74,0x38,0xf5,0x61,0x60,0x05,0x26,0x78,0x46,0xcf,0x8d,0x9a,0x9c,0xe5,0x43,0x63,
+ 0xf1,0xe8,0x0c,0x5e,0x2d,0xc9,0xa5,0xf3,0x8e,0x9d,0xa6,0xab,0x68,0x34,0x61,0x73,
+ 0xad,0xa0,0x94,0x2a,0xec,0x98,0x70,0xfd,0x71,0x1e,0xc2,0xed,0x9b,0x77,0x1c,0xba,
+ 0xba,0x7c,0xd9,0xc9,0xea,0xf2,0xc4,0xf3,0x33,0xd8,0x39,0xb1,0x5e,0xff,0x77,0x4b,
+ 0xd2,0xac,0xd7,0x83,0xd0,0x33,0x0e,0xf1,0x6d,0x56,0x8f,0x49,0x5a,0x99,0xe6,0x38,
+ 0x1a,0x83,0x31,0xb6,0x23,0xd1,0x0c,0x51,0x1f,0xd1,0x5e,0xc8,0xc9,0xa9,0x4c,0x34,
+ 0x83,0xeb,0x79,0x9d,0x95,0x65,0xd6,0x8e,0xde,0xb0,0x0b,0x1e,0x82,0xdf,0x06,0x6d,
+ 0xf3,0x15,0xfc,0xc9,0x08,0x19,0x46,0x82,0x06,0x6c,0x30,0x63,0x27,0x9d,0x14,0x7b,
+ 0xe4,0x1b,0xc2,0xb4,0x8c,0xef,0xe7,0x9d,0xde,0x7f,0x11,0xca,0x5c,0x8d,0xa4,0x56,
+ 0x0f,0xaf,0x1f,0xab,0x05,0xa0,0x87,0x7d,0x14,0x88,0xc7,0x09,0xbe,0x7f,0xdb,0xde,
+ 0xa3,0x1e,0xcc,0xe1,0x2e,0x69,0x8b,0xf9,0xe4,0xbc,0x0d,0x53,0x41,0xc1,0xe8,0x44,
+ 0x55,0xc4,0xe5,0x70,0x55,0x65,0x6d,0x18,0x20,0x4f,0xe0,0x87,0x5f,0x38,0x5f,0x1e,
+ 0x35,0x3d,0x42,0x68,0x97,0x4a,0x49,0x86,0x6b,0x21,0x97,0x7d,0x68,0x1a,0x50,0x9f,
+ 0xef,0x77,0x0a,0x9e,0x9e,0xe0,0x9c,0x47,0x24,0x34,0xac,0x56,0x8b,0xd7,0xce,0x8f,
+ 0x58,0x49,0x33,0x40,0x2e,0xf2,0x22,0x86,0xdc,0xbf,0xea,0xcd,0x80,0x9a,0xf1,0xd4,
+ 0x40,0xae,0xc8,0x29,0xe1,0x26,0x57,0x30,0xfe,0xe6,0xcd,0xcb,0x5b,0xc9,0xf5,0x54,
+ 0xfa,0x15,0x28,0x59,0x29,0x89,0x22,0xa6,0xca,0x46,0x2a,0x74,0xdf,0xa3,0xb7,0x9b,
+ 0x83,0x23,0x9b,0x93,0x13,0xdc,0xb3,0x0c,0xf1,0xed,0xd4,0x53,0xf0,0x24,0xae,0x09,
+ 0xe6,0x6c,0x5f,0x25,0x2e,0x9f,0xed,0x95,0x07,0x5a,0x3e,0xcb,0x5f,0x91,0xe4,0x0c,
+ 0x06,0x44,0x02,0x00,0x00,
+};
+
+#endif
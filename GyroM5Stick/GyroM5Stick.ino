@@ -9,29 +9,33 @@
 // URL:
 //   https://github.com/hshin-git/GyroM5
 //////////////////////////////////////////////////
-#include <M5StickC.h>
+// M5StickC Plus: BOARD_STICKPLUS here, or -DGYROM5_BOARD=BOARD_STICKPLUS by the build
+#ifndef GYROM5_BOARD
+#define GYROM5_BOARD BOARD_STICK
+#endif
+#include <GyroM5Core.hpp>
 #include <WiFi.h>
 #include <WiFiAP.h>
 #include <WiFiClient.h>
 #include <Preferences.h>
 #include <Ticker.h>
-#include <QuickPID.h>
+#include "WebUI.h"
 
 
 //////////////////////////////////////////////////
 // Global constants
 //////////////////////////////////////////////////
 // WiFi parameters
-const char *WIFI_SSID = "GyroM5v2";
+const char *WIFI_SSID = Board::SSID;
 const char *WIFI_PASS = NULL; // (8 char or more for WPA2, NULL for open use)
 const IPAddress WIFI_IP(192,168,5,1);
 const IPAddress WIFI_SUBNET(255,255,255,0);
 WiFiServer WIFI_SERVER(80);
 
-// GPIO parameters
-const int CH1_IN = 26;
-const int CH3_IN = 36;
-const int CH1_OUT = 0;  // G0 must be HIGH while booting, so shoud be output pin
+// GPIO parameters (by board traits in GyroM5Core.hpp)
+const int CH1_IN = Board::CH1_IN;
+const int CH3_IN = Board::CH3_IN;
+const int CH1_OUT = Board::CH1_OUT;
 
 // PWM channel
 const int PWM_CH1 = 0;
@@ -51,6 +55,8 @@ const int PULSE_AMP = (PULSE_MAX-PULSE_MIN)/2;
 const int GAIN_MIN = 0;
 const int GAIN_MAX = 100;
 const int GAIN_AMP = 120;
+const int GAIN_TAU = 80;        // smoothing time constant in msec
+const float GAIN_HYST = 0.75;   // hysteresis in gain steps (over 0.5)
 
 // LCD parameters
 const int LCD_BACK = 8;   // brightness 7-15
@@ -74,12 +80,17 @@ RTC_TimeTypeDef RTC_TIME;
 // Variable PWM frequency
 int PWM_FREQ = 50;
 int PWM_USEC = 1000000/PWM_FREQ;
+OutputShaper CH1_SHAPE;  // usec to duty by the curve of EXP/TRM/SLW (GyroM5Core.hpp)
+portMUX_TYPE CH1_MUX = portMUX_INITIALIZER_UNLOCKED;  // PID loop and watch fallback share CH1_SHAPE
 //
 void ch1_setFreq(int freq) {
   static bool firstTime = true;
   if (freq<50 || freq>400) return;
   PWM_FREQ = freq;
   PWM_USEC = 1000000/PWM_FREQ;
+  portENTER_CRITICAL(&CH1_MUX);
+  CH1_SHAPE.build(PWM_USEC,PWM_BITS);
+  portEXIT_CRITICAL(&CH1_MUX);
   //
   if (!firstTime) ledcDetachPin(CH1_OUT);
   ledcSetup(PWM_CH1,PWM_FREQ,PWM_BITS);
@@ -87,64 +98,56 @@ void ch1_setFreq(int freq) {
   ledcAttachPin(CH1_OUT,PWM_CH1);
   firstTime = false;
 }
+// the only writer of CH1 (PID loop and watch fallback)
 void ch1_setUsec(int usec) {
-  int duty = map(usec, 0,PWM_USEC, 0,PWM_DUTY);
-  ledcWrite(PWM_CH1,(usec>0? duty: 0));
+  portENTER_CRITICAL(&CH1_MUX);
+  ledcWrite(PWM_CH1,CH1_SHAPE.duty(usec,micros()));
+  portEXIT_CRITICAL(&CH1_MUX);
 }
 
 
+//////////////////////////////////////////////////
+// Flight recorder (GyroM5Core.hpp)
+//////////////////////////////////////////////////
+// samples at REC_HZ around triggers (RYW/RCS, deadline, dropout, button A), at /api/rec
+// 128 samples at 100Hz (1.28sec) for the DRAM left beside DATA[]
+#define REC_HZ  100
+FlightRecorder<128> REC;
+
+
 
 //////////////////////////////////////////////////
 // PWM reading without blocking
 //////////////////////////////////////////////////
-// PWM watch dog timer
+// PWM watch dog timer (timeouts of each channel checked in every 5msec)
 Ticker PWMIN_WDT;
+const int PWMIN_CHECK_MS = 5;
 //
 const int PWMIN_MAX = 4;
 int PWMIN_IDS = 0;
-typedef struct {
-  int pin;
-  int tout;
-  // for pulse
-  int *dst;
-  int prev;
-  unsigned long last;
-  // for freq
-  int *dstFreq;
-  unsigned long lastFreq;
-} _PWMIN;
+bool PWMIN_ON = false;
+// edge handling, glitch rejection and link health by PulseCapture (GyroM5Core.hpp),
+// copied to the variables (frequency by the timer, no division in ISR)
+struct _PWMIN : PulseCapture {
+  int *usec;
+  int *freq;
+};
 _PWMIN PWMIN[PWMIN_MAX];
 // PWM interrupt handler
 void _pwmin_isr(void *arg) {
   unsigned long tnow = micros();
-  int id = (int)arg;
+  int id = (int)(intptr_t)arg;
   _PWMIN *pwm = &PWMIN[id];
-  int vnow = digitalRead(pwm->pin);
-  if (pwm->prev==0 && vnow==1) {
-    // at up edge
-    pwm->prev = 1;
-    pwm->last = tnow;
-    // for freq
-    *(pwm->dstFreq) = (tnow > pwm->lastFreq? 1000000/(tnow - pwm->lastFreq): 0);
-    pwm->lastFreq = tnow;
-  }
-  else
-  if (pwm->prev==1 && vnow==0) {
-    // at down edge
-    *(pwm->dst) = tnow - pwm->last;
-    pwm->prev = 0;
-    pwm->last = tnow;
-  }
+  pwm->edge(digitalRead(pwm->pin), tnow);
+  *(pwm->usec) = pwm->dstUsec;
 }
 // PWM timer handler
 void _pwmin_tsr(void) {
   unsigned long tnow = micros();
   for (int id=0; id<PWMIN_IDS; id++) {
     _PWMIN *pwm = &PWMIN[id];
-    if (pwm->last + pwm->tout < tnow) {
-      *(pwm->dst) = 0;
-      *(pwm->dstFreq) = 0;
-    }
+    if (pwm->expire(tnow)) *(pwm->usec) = 0;
+    *(pwm->freq) = pwm->getFreq();
   }
 }
 //
@@ -153,25 +156,24 @@ bool pwmin_init(int pin, int *usec, int *freq, int toutUs=21*1000) {
     int id = PWMIN_IDS;
     _PWMIN *pwm = &PWMIN[id];
     //
-    pwm->pin = pin;
-    pwm->tout = toutUs;
-    // for pulse
-    pwm->dst = usec;
-    pwm->prev = 0;
-    pwm->last = micros();
-    // for freq
-    pwm->dstFreq = freq;
-    pwm->lastFreq = micros();
+    pwm->init(pin, toutUs, micros());
+    pwm->usec = usec;
+    pwm->freq = freq;
     //
     pinMode(pin,INPUT);
-    attachInterruptArg(pin,_pwmin_isr,(void*)id,CHANGE);
-    if (id==0) PWMIN_WDT.attach_ms(pwm->tout/1000,_pwmin_tsr);
+    attachInterruptArg(pin,_pwmin_isr,(void*)(intptr_t)id,CHANGE);
+    if (id==0) PWMIN_WDT.attach_ms(PWMIN_CHECK_MS,_pwmin_tsr);
     //
     PWMIN_IDS = id + 1;
+    PWMIN_ON = true;
     return true;
   }
   return false;
 }
+// link health of channel (LinkHealth in GyroM5Core.hpp)
+LinkHealth& pwmin_link(int id) {
+  return PWMIN[id].link;
+}
 //
 void pwmin_disable(void) {
   if (PWMIN_IDS <= 0) return;
@@ -180,15 +182,45 @@ void pwmin_disable(void) {
     _PWMIN *pwm = &PWMIN[id];
     detachInterrupt(pwm->pin);
   }
+  PWMIN_ON = false;
   delay(GUI_MSEC);
 }
 void pwmin_enable(void) {
   if (PWMIN_IDS <= 0) return;
   for (int id=0; id<PWMIN_IDS; id++) {
     _PWMIN *pwm = &PWMIN[id];
-    attachInterruptArg(pwm->pin,_pwmin_isr,(void*)id,CHANGE);
-    if (id==0) PWMIN_WDT.attach_ms(pwm->tout/1000,_pwmin_tsr);
+    attachInterruptArg(pwm->pin,_pwmin_isr,(void*)(intptr_t)id,CHANGE);
+    if (id==0) PWMIN_WDT.attach_ms(PWMIN_CHECK_MS,_pwmin_tsr);
   }
+  PWMIN_ON = true;
+}
+
+
+
+//////////////////////////////////////////////////
+// Deadline watch: fallback output while PID loop stalls (Supervisor of GyroM5Core)
+//////////////////////////////////////////////////
+Supervisor WATCH;
+
+// values of the input and calibration
+extern int CH1_USEC;
+extern float CH1US_MEAN;
+
+// fallback input: CH1 (neutral while pwmin is disabled, no reading)
+int watch_in(int ch) {
+  return (PWMIN_ON || CH1US_MEAN <= 0)? CH1_USEC: int(CH1US_MEAN);
+}
+// fallback output by the watch timer
+bool watch_out(int ch, float usec) {
+  ch1_setUsec(int(usec));
+  return true;
+}
+// in every 1sec: timing violations to Serial
+void watch_report(void) {
+  static unsigned long lastTime = 0;
+  if (millis() - lastTime < 1000) return;
+  lastTime = millis();
+  WATCH.report(Serial);
 }
 
 
@@ -272,7 +304,7 @@ void data_put(int id, int val) {
   A[p] = val;
   RING[id].head = (p+1)%N;
 }
-void data_draw(int lastData, int lastLine=8, int top=80, int left=0, int width=80, int height=80) {
+void data_draw(int lastData, int lastLine=8, int top=Board::PLOT, int left=0, int width=Board::PLOT, int height=Board::PLOT) {
   int N = DATA_SIZE;
   int LAST = (lastData>0? min(N,lastData): N);
     
@@ -304,7 +336,7 @@ void data_draw(int lastData, int lastLine=8, int top=80, int left=0, int width=8
     }
   }
 }
-void data_grid(int v, int top=80, int left=0, int width=80, int height=80) {
+void data_grid(int v, int top=Board::PLOT, int left=0, int width=Board::PLOT, int height=Board::PLOT) {
   int y = map(v, -PULSE_AMP,PULSE_AMP, top+height,top);
   canvas.drawLine(left,y, left+width,y,FG_COLOR);
 }
@@ -370,17 +402,6 @@ float data_RMSE(int id1, int id2, int lastData=0) {
 //////////////////////////////////////////////////
 // Watch 5Vin for interlocking with RC units
 //////////////////////////////////////////////////
-void _axp_halt(){
-  Wire1.beginTransmission(0x34);
-  Wire1.write(0x32);
-  Wire1.endTransmission();
-  Wire1.requestFrom(0x34, 1);
-  uint8_t buf = Wire1.read();
-  Wire1.beginTransmission(0x34);
-  Wire1.write(0x32);
-  Wire1.write(buf | 0x80); // halt bit
-  Wire1.endTransmission();
-}
 void vin_watch() {
   static unsigned long lastTime = 0;
   float vin = M5.Axp.GetVinData()*1.7 /1000;
@@ -388,7 +409,7 @@ void vin_watch() {
   //Serial.printf("vin,usb = %f,%f\n",vin,usb);
   if ( vin < 3.0 && usb < 3.0 ) {
     if ( lastTime + 5*1000 < millis() ) {
-      _axp_halt();
+      Board::halt();
     }
   } else {
     lastTime = millis();
@@ -397,6 +418,28 @@ void vin_watch() {
 
 
 
+//////////////////////////////////////////////////
+// CPU clock by PID deadline margin and idle until the next PID step
+//////////////////////////////////////////////////
+PowerManager POWER;      // mode by CONFIG[_POW] (0: 240MHz fixed, 1: auto clock, idle in both)
+float POWER_MA = 0.0;   // input current by AXP [mA]
+
+// in every 1sec: measure current (clock by POWER, 240MHz while buttons are pressed)
+void power_loop(bool full) {
+  static unsigned long lastTime = 0;
+  POWER.loop(full);
+  if (millis() - lastTime < 1000) return;
+  lastTime = millis();
+  //
+  float vin = M5.Axp.GetVinData()*1.7;
+  float usb = M5.Axp.GetVusbinData()*1.7;
+  if (vin > 3000) POWER_MA = M5.Axp.GetIinData()*0.625;
+  else if (usb > 3000) POWER_MA = M5.Axp.GetIusbinData()*0.375;
+  else POWER_MA = fabs(M5.Axp.GetBatCurrent());
+}
+
+
+
 //////////////////////////////////////////////////
 // GyroM5 storage for setting
 //////////////////////////////////////////////////
@@ -404,21 +447,23 @@ Preferences STORAGE;
 const char CONFIG_NAME[] = "GYROM5";
 const char CONFIG_KEY[] = "CONF";
 
-// GyroM5 parameters
-const char *KEYS[] = {"KG","KP","KI","KD", "CH1","CH3","PWM", "MIN","MAX", "END",};
-const int _INIT_[] = {50,50,20,5, 0,0,50, 1000,2000, 12345,};
-int CONFIG[] = {50,50,20,5, 0,0,50, 1000,2000, 12345,};
-enum _INDEX {_KG=0,_KP,_KI,_KD, _CH1,_CH3,_PWM, _MIN,_MAX, _END,};
+// GyroM5 parameters (END is the layout magic: change it whenever KEYS change)
+const char *KEYS[] = {"KG","KP","KI","KD", "CH1","CH3","PWM", "SPD","SPS","SPT","SPG","FF", "EXP","TRM","SLW", "RYW","RCS", "POW", "SAFE", "FS", "MIN","MAX", "END",};
+const int _INIT_[] = {50,50,20,5, 0,0,50, 0,0,100,50,0, 0,0,0, 600,0, 0, 1, 1, 1000,2000, 12351,};
+int CONFIG[] = {50,50,20,5, 0,0,50, 0,0,100,50,0, 0,0,0, 600,0, 0, 1, 1, 1000,2000, 12351,};
+enum _INDEX {_KG=0,_KP,_KI,_KD, _CH1,_CH3,_PWM, _SPD,_SPS,_SPT,_SPG,_FF, _EXP,_TRM,_SLW, _RYW,_RCS, _POW, _SAFE, _FS, _MIN,_MAX, _END,};
 const int SIZE = sizeof(CONFIG)/sizeof(int);
-const int TAIL = 3; // number of items after "PWM"
+const int TAIL = 3; // number of items after "FS"
 
 // storage read/write
 void config_init() {
   pwmin_disable();
   //
   STORAGE.begin(CONFIG_NAME);
-  STORAGE.getBytes(CONFIG_KEY, &CONFIG, sizeof(CONFIG));
-  if (CONFIG[_END] != _INIT_[_END]) { // the first time
+  // saved blob of another layout (older firmware) is not read into the new slots
+  size_t length = STORAGE.getBytesLength(CONFIG_KEY);
+  if (length == sizeof(CONFIG)) STORAGE.getBytes(CONFIG_KEY, &CONFIG, sizeof(CONFIG));
+  if (length != sizeof(CONFIG) || CONFIG[_END] != _INIT_[_END]) { // the first time or another layout
     STORAGE.putBytes(CONFIG_KEY, &_INIT_, sizeof(CONFIG));
     STORAGE.getBytes(CONFIG_KEY, &CONFIG, sizeof(CONFIG));
   }
@@ -426,12 +471,14 @@ void config_init() {
   pwmin_enable();
 }
 void config_puts() {
+  const char *tag = WATCH.cause("save");
   // timer/interrupt must be disabled during writing Preferences, otherwise ESP32 crashes...
   pwmin_disable();
   //
   STORAGE.putBytes(CONFIG_KEY, &CONFIG, sizeof(CONFIG));
   //
   pwmin_enable();
+  WATCH.cause(tag);
 }
 void config_gets() {
   pwmin_disable();
@@ -453,11 +500,21 @@ void config_dump(WiFiClient *cl) {
   }
 }
 
+// CH1 output curve by CONFIG (on) or straight (off: setting end points, WiFi)
+void ch1_shape(bool on) {
+  portENTER_CRITICAL(&CH1_MUX);
+  if (on && CH1US_MEAN > 0) CH1_SHAPE.setup(CONFIG[_MIN],int(CH1US_MEAN),CONFIG[_MAX],CONFIG[_TRM],CONFIG[_EXP],CONFIG[_SLW]);
+  else CH1_SHAPE.open();
+  CH1_SHAPE.build(PWM_USEC,PWM_BITS);
+  portEXIT_CRITICAL(&CH1_MUX);
+}
+
 
 //////////////////////////////////////////////////
 // Parameter config by WiFi
 //////////////////////////////////////////////////
 void wifi_init(void) {
+  const char *tag = WATCH.cause("wifi");
   pwmin_disable();
   //
   WiFi.mode(WIFI_AP);
@@ -469,6 +526,7 @@ void wifi_init(void) {
   WIFI_SERVER.begin();
   //
   pwmin_enable();
+  WATCH.cause(tag);
 }
 //
 void wifi_quit(void) {
@@ -480,124 +538,147 @@ void wifi_quit(void) {
 }
 
 // HTML template
-const char HTML_TEMPLATE[] = R"(
-<!DOCTYPE HTML>
-<html>
-<head>
-<meta name='viewport' content='width=device-width,initial-scale=1' />
-<title>%s</title>
-</head>
-<body>
-<form method='get' name='setting'>
-<table>
-<tr><th>name</th><th>range</th><th>value</th><th>description</th></tr>
-<tr><td>KG</td><td><input type='range' name='KG' min='0' max='100' step='1' value='0' oninput='onInput(this)' /></td><td><span id='KG'>0</span></td><td>IMU gain G (0-100)</td></tr>
-<tr><td>KP</td><td><input type='range' name='KP' min='0' max='100' step='1' value='0' oninput='onInput(this)' /></td><td><span id='KP'>0</span></td><td>PID gain P (0-100)</td></tr>
-<tr><td>KI</td><td><input type='range' name='KI' min='0' max='100' step='1' value='0' oninput='onInput(this)' /></td><td><span id='KI'>0</span></td><td>PID gain I (0-100)</td></tr>
-<tr><td>KD</td><td><input type='range' name='KD' min='0' max='100' step='1' value='0' oninput='onInput(this)' /></td><td><span id='KD'>0</span></td><td>PID gain D (0-100)</td></tr>
-<tr><td>CH1</td><td><input type='range' name='CH1' min='0' max='1' step='1' value='0' oninput='onInput(this)' /></td><td><span id='CH1'>0</span></td><td>0:NOR, 1:REV</td></tr>
-<tr><td>CH3</td><td><input type='range' name='CH3' min='0' max='5' step='1' value='0' oninput='onInput(this)' /></td><td><span id='CH3'>0</span></td><td>0:TB, 1:KG, 2:KP, 3:KI, 4:KD, 5:NO</td></tr>
-<tr><td>PWM</td><td><input type='range' name='PWM' min='50' max='400' step='50' value='50' oninput='onInput(this)' /></td><td><span id='PWM'>50</span><td>PWM frequency (Hz)</td></tr>
-</table>
-<input type='hidden' name='JST' value='20001020103030' />
-<input type='submit' value='upload setting' onclick='onSubmit()' />
-<input type='button' value='download data' onclick='window.location=window.location.href.split("?")[0]+"csv";' />
-<input type='button' value='reload setting' onclick='window.location=window.location.href.split("?")[0];' />
-</form>
-</body>
-<script>
-function onInput(obj) { document.getElementById(obj.name).textContent = obj.value; }
-function onLoad() {
- const CONFIG = {KG:%d,KP:%d,KI:%d,KD:%d,CH1:%d,CH3:%d,PWM:%d,};
- const INPUTS = document.getElementsByTagName('input');
- for (let key in CONFIG){ document.getElementsByName(key)[0].value = document.getElementById(key).textContent  = CONFIG[key]; } 
- if (%d) { for (var i=0;i<INPUTS.length-1; i++) { INPUTS[i].disabled = true; } }
-}
-function D2(n) { return ('0'+n).slice(-2); }
-function onSubmit() {
- const now = new Date();
- const str = now.getFullYear() + D2(now.getMonth()+1) + D2(now.getDate()) + D2(now.getHours()) + D2(now.getMinutes()) + D2(now.getSeconds());
- document.getElementsByName('JST')[0].value = str;
+// config page: html/index.html compressed into WebUI.h by tools/webgz
+// (sent as is with ETag, values are fetched by "GET /api/config")
+void page_send(WiFiClient *cl, bool cached) {
+  if (cached) {
+    cl->print("HTTP/1.1 304 Not Modified\r\n");
+    cl->printf("ETag: %s\r\nCache-Control: no-cache\r\n\r\n", WEBUI_INDEX_ETAG);
+    return;
+  }
+  cl->print("HTTP/1.1 200 OK\r\n");
+  cl->print("Content-Type: text/html; charset=utf-8\r\nContent-Encoding: gzip\r\n");
+  cl->printf("Content-Length: %u\r\n", (unsigned)WEBUI_INDEX_LEN);
+  cl->printf("ETag: %s\r\nCache-Control: no-cache\r\n\r\n", WEBUI_INDEX_ETAG);
+  cl->write(WEBUI_INDEX, WEBUI_INDEX_LEN);
 }
-window.onload = onLoad();
-</script>
-</html>
-)";
 
-// HTML buffer
-char HTML_BUFFER[sizeof(HTML_TEMPLATE)+sizeof(WIFI_SSID)+8*SIZE];
+// config values as JSON {"KG":50,...}
+void config_json(WiFiClient *cl) {
+  cl->print("HTTP/1.1 200 OK\r\n");
+  cl->print("Content-Type: application/json\r\nCache-Control: no-store\r\n\r\n");
+  for (int n=0; n<(SIZE-TAIL); n++) {
+    cl->printf("%s\"%s\":%d", (n==0? "{": ","), KEYS[n], CONFIG[n]);
+  }
+  cl->print("}");
+}
 
 // foward prototype
 void gpid_init(bool);
 
 // Web server for config
+// (request line in a fixed buffer: no String and no heap while serving)
 bool configAccepted = false;
+const int LINE_MAX = 512;
+char LINE_BUF[LINE_MAX];
+//
+bool line_is(const char *line, const char *head) {
+  return strncmp(line, head, strlen(head)) == 0;
+}
+// integer of at most n digits at p (up to '&' or ' ')
+int line_int(const char *p, int n=11) {
+  char num[12];
+  int k = 0;
+  if (n > 11) n = 11;
+  while (k < n && p[k] && p[k] != '&' && p[k] != ' ') { num[k] = p[k]; k++; }
+  num[k] = 0;
+  return atoi(num);
+}
+//
 void serverLoop() {
   WiFiClient client = WIFI_SERVER.available();
 
   if (client) {
     //Serial.println("New Client.");
-    String currentLine = "";
+    char *currentLine = LINE_BUF;
+    int length = 0;
+    bool cached = false;
+    currentLine[0] = 0;
 
     while (client.connected()) {
       if (client.available()) {
         char c = client.read();
         //Serial.write(c);
         if (c == '\n') {
-          if (currentLine.length() == 0) {
+          if (length == 0) {
             // response for request "/"
-            client.println("HTTP/1.1 200 OK");
-            client.println("Content-type:text/html; charset=utf-8;");
-            client.println("");
-            sprintf(HTML_BUFFER,HTML_TEMPLATE, WIFI_SSID,CONFIG[_KG],CONFIG[_KP],CONFIG[_KI],CONFIG[_KD],CONFIG[_CH1],CONFIG[_CH3],CONFIG[_PWM],0);
-            client.println(HTML_BUFFER);
+            page_send(&client, cached);
+            break;
+          } 
+          else
+          if (line_is(currentLine, "GET /api/config")) {
+            // response for request "/api/config"
+            config_json(&client);
+            break;
+          } 
+          else
+          if (line_is(currentLine, "GET /api/link")) {
+            // response for request "/api/link" (CH1 link health)
+            client.print("HTTP/1.1 200 OK\r\n");
+            client.print("Content-Type: application/json\r\nCache-Control: no-store\r\n\r\n");
+            pwmin_link(0).printJSON(client);
+            break;
+          } 
+          else
+          if (line_is(currentLine, "GET /api/sys")) {
+            // response for request "/api/sys" (heap, stack and CPU load)
+            client.print("HTTP/1.1 200 OK\r\n");
+            client.print("Content-Type: application/json\r\nCache-Control: no-store\r\n\r\n");
+            ResourceMonitor::printJSON(client);
+            break;
+          } 
+          else
+          if (line_is(currentLine, "GET /api/rec")) {
+            // response for request "/api/rec" (flight recorder)
+            client.print("HTTP/1.1 200 OK\r\n");
+            client.print("Content-Type: text/csv\r\nCache-Control: no-store\r\n\r\n");
+            REC.printCSV(client);
             break;
           } 
           else
-          if (currentLine.indexOf("GET /?") == 0) {
+          if (line_is(currentLine, "GET /?")) {
             // response for request "/?KG=..."
-            int p1 = 0;
-            int p2 = 0;
-            int val = 0;
-            // set CONFIG
+            const char *p = currentLine;
+            const char *q;
+            // set CONFIG (keys in order, missing keys unchanged)
             for (int n=0; n<(SIZE-TAIL); n++) {
               char key[16];
               sprintf(key,"%s=",KEYS[n]);
-              p1 = currentLine.indexOf(key, p2) + strlen(key);
-              p2 = currentLine.indexOf('&', p1);
-              val = currentLine.substring(p1, p2).toInt();
-              CONFIG[n] = val;
+              q = strstr(p, key);
+              if (q == NULL) continue;
+              p = q + strlen(key);
+              CONFIG[n] = line_int(p);
             }
             // set RTC
-            p1 = currentLine.indexOf("JST=",p2) + strlen("JST=");
-            RTC_DATE.Year = currentLine.substring(p1+0,p1+4).toInt();
-            RTC_DATE.Month = currentLine.substring(p1+4,p1+6).toInt();
-            RTC_DATE.Date = currentLine.substring(p1+6,p1+8).toInt();
-            M5.Rtc.SetData(&RTC_DATE);
-            RTC_TIME.Hours = currentLine.substring(p1+8,p1+10).toInt();
-            RTC_TIME.Minutes = currentLine.substring(p1+10,p1+12).toInt();
-            RTC_TIME.Seconds = currentLine.substring(p1+12,p1+14).toInt();
-            M5.Rtc.SetTime(&RTC_TIME);
+            q = strstr(p, "JST=");
+            if (q != NULL) {
+              p = q + strlen("JST=");
+              RTC_DATE.Year = line_int(p+0,4);
+              RTC_DATE.Month = line_int(p+4,2);
+              RTC_DATE.Date = line_int(p+6,2);
+              M5.Rtc.SetData(&RTC_DATE);
+              RTC_TIME.Hours = line_int(p+8,2);
+              RTC_TIME.Minutes = line_int(p+10,2);
+              RTC_TIME.Seconds = line_int(p+12,2);
+              M5.Rtc.SetTime(&RTC_TIME);
+            }
             // save CONFIG
             config_puts();
             ch1_setFreq(CONFIG[_PWM]);
             gpid_init(true);
-            // response
-            client.println("HTTP/1.1 200 OK");
-            client.println("Content-type:text/html; charset=utf-8;");
-            client.println("");
-            sprintf(HTML_BUFFER,HTML_TEMPLATE, WIFI_SSID,CONFIG[_KG],CONFIG[_KP],CONFIG[_KI],CONFIG[_KD],CONFIG[_CH1],CONFIG[_CH3],CONFIG[_PWM],1);
-            client.println(HTML_BUFFER);
+            // response (the page shows the uploaded values from its URL)
+            page_send(&client, false);
             configAccepted = true;
             break;
           } 
           else
-          if (currentLine.indexOf("GET /csv") == 0) {
+          if (line_is(currentLine, "GET /csv")) {
             // response for request "/csv"
             client.println("HTTP/1.1 200 OK");
             client.println("Content-type:text/csv; charset=utf-8;");
             //client.println("Content-Disposition:attachment; filename=data.csv");
-            client.printf("Content-Disposition:attachment; filename=data-%04d%02d%02d-%02d%02d.csv\n", RTC_DATE.Year,RTC_DATE.Month,RTC_DATE.Date, RTC_TIME.Hours,RTC_TIME.Minutes);
+            client.print("Content-Disposition:attachment; ");
+            client.printf("filename=data-%04d%02d%02d-%02d%02d.csv\n", RTC_DATE.Year,RTC_DATE.Month,RTC_DATE.Date, RTC_TIME.Hours,RTC_TIME.Minutes);
             client.println("");
             config_dump(&client);
             data_dump(&client);
@@ -606,10 +687,13 @@ void serverLoop() {
           } 
           else 
           {
-            currentLine = "";
+            if (line_is(currentLine, "If-None-Match:") && strstr(currentLine, WEBUI_INDEX_ETAG) != NULL) cached = true;
+            length = 0;
+            currentLine[0] = 0;
           }
-        } else if (c != '\r') {
-          currentLine += c;
+        } else if (c != '\r' && length < LINE_MAX-1) {
+          currentLine[length++] = c;
+          currentLine[length] = 0;
         }
       }
     }
@@ -630,21 +714,28 @@ void setup_by_wifi() {
     canvas.println("IP:"); canvas.print(" "); canvas.println(WIFI_IP);
     canvas_footer("WIFI");
     sprintf(url,"http://%d.%d.%d.%d/",((WIFI_IP>>0)&0xff),((WIFI_IP>>8)&0xff),((WIFI_IP>>16)&0xff),((WIFI_IP>>24)&0xff));
-    M5.Lcd.qrcode(url,0,80,80,2);
+    M5.Lcd.qrcode(url,0,Board::PLOT,Board::PLOT,2);
   }
   delay(GUI_MSEC);
   //
+  const char *tag = WATCH.cause("www");
   configAccepted = false;
+  ch1_shape(false);
   while (!configAccepted) {
     serverLoop();
+    ch1_setUsec(CH1_USEC);
+    WATCH.tick(PWM_WAIT);
     vin_watch();
     M5.update();
     if (M5.BtnA.isPressed()) {
+      ch1_shape(true);
       delay(GUI_MSEC);
+      WATCH.cause(tag);
       return;
     }
     //delay(2);
   }
+  WATCH.cause(tag);
   //
   //WIFI_SERVER.end();
   //
@@ -653,7 +744,9 @@ void setup_by_wifi() {
 
 // config for ch1 end points
 void setup_ch1ends() {
+  const char *tag = WATCH.cause("ends");
   int ch1,val;
+  ch1_shape(false); // gpid_init() after this sets the curve of new end points
   for (int n=0; n<2; n++) {
     delay(GUI_MSEC);
     while (true) {
@@ -661,6 +754,7 @@ void setup_ch1ends() {
       val = map(ch1, 0,PWM_USEC, 0,PWM_DUTY);
       //ledcWrite(PWM_CH1,(ch1>0? val: 0));
       ch1_setUsec(ch1);
+      WATCH.tick(PWM_WAIT);
       if (canvas_header("ENDS",LCD_MSEC)) {
         canvas.println((n? "LEFT": "RIGHT"));
         canvas.printf("[A] SAVE\n");
@@ -679,6 +773,7 @@ void setup_ch1ends() {
       if (M5.BtnB.isPressed()) {
         //ch1_setUsec(0);
         delay(GUI_MSEC);
+        WATCH.cause(tag);
         return;
       }
     } 
@@ -694,6 +789,7 @@ void setup_ch1ends() {
   }
   //ch1_setUsec(0);
   delay(GUI_MSEC);
+  WATCH.cause(tag);
 }
 
 
@@ -755,6 +851,89 @@ int countHz(bool getOnly = false) {
   return freq;
 }
 
+// Calibration cache: last means with IMU temperature
+const char CALIB_KEY[] = "CALB";
+struct {
+  float CH1US;
+  float OMEGA[3];
+  float ACCEL[3];
+  float TEMP;
+  int END;
+} CALIB;
+
+void calib_puts() {
+  CALIB.CH1US = CH1US_MEAN;
+  for (int i=0; i<3; i++) {
+    CALIB.OMEGA[i] = OMEGA_MEAN[i];
+    CALIB.ACCEL[i] = ACCEL_MEAN[i];
+  }
+  M5.IMU.getTempData(&CALIB.TEMP);
+  CALIB.END = _INIT_[_END];
+  //
+  const char *tag = WATCH.cause("calib");
+  pwmin_disable();
+  STORAGE.putBytes(CALIB_KEY, &CALIB, sizeof(CALIB));
+  pwmin_enable();
+  WATCH.cause(tag);
+}
+
+// quick check: still for msec and close to the cached means
+extern int CH1_USEC;
+bool calib_check(unsigned long msec=100) {
+  float omega[3],accel[3],temp;
+  float om[3] = {0.0,0.0,0.0}, ov[3] = {0.0,0.0,0.0}, am[3] = {0.0,0.0,0.0};
+  float ch1 = 0.0;
+  int count = 0, ch1count = 0;
+  //
+  CALIB.END = 0;
+  pwmin_disable();
+  STORAGE.getBytes(CALIB_KEY, &CALIB, sizeof(CALIB));
+  pwmin_enable();
+  if (CALIB.END != _INIT_[_END]) return false;
+  //
+  unsigned long startTime = millis();
+  while (millis() - startTime < msec) {
+    M5.IMU.getGyroData(&omega[0],&omega[1],&omega[2]);
+    M5.IMU.getAccelData(&accel[0],&accel[1],&accel[2]);
+    for (int i=0; i<3; i++) {
+      om[i] += omega[i];
+      ov[i] += omega[i]*omega[i];
+      am[i] += accel[i];
+    }
+    count = count + 1;
+    if (CH1_USEC > 0) {
+      ch1 += CH1_USEC;
+      ch1count = ch1count + 1;
+    }
+    delay(1);
+  }
+  M5.IMU.getTempData(&temp);
+  if (count < 10 || ch1count == 0) return false;
+  //
+  float aa = 0.0, ac = 0.0, cc = 0.0;
+  for (int i=0; i<3; i++) {
+    om[i] /= count;
+    am[i] /= count;
+    ov[i] = ov[i]/count - om[i]*om[i];
+    if (ov[i] > 0.5*0.5) return false;                   // still: noise < 0.5 o/s
+    if (abs(om[i] - CALIB.OMEGA[i]) > 0.5) return false; // bias < 0.5 o/s
+    aa += am[i]*am[i];
+    ac += am[i]*CALIB.ACCEL[i];
+    cc += CALIB.ACCEL[i]*CALIB.ACCEL[i];
+  }
+  if (abs(sqrt(aa) - 1.0) > 0.05) return false;         // |g| = 1 +/- 0.05
+  if (ac < 0.9986*sqrt(aa*cc)) return false;           // tilt < 3 deg
+  if (abs(ch1/ch1count - CALIB.CH1US) > 8.0) return false; // neutral < 8 us
+  if (abs(temp - CALIB.TEMP) > 8.0) return false;       // temp < 8 deg C
+  //
+  CH1US_MEAN = CALIB.CH1US;
+  for (int i=0; i<3; i++) {
+    OMEGA_MEAN[i] = CALIB.OMEGA[i];
+    ACCEL_MEAN[i] = CALIB.ACCEL[i];
+  }
+  return true;
+}
+
 void mean_init(void) {
   unsigned long startTime;
   int count;
@@ -766,6 +945,8 @@ void mean_init(void) {
       canvas_footer("WAIT");
     }
   }
+  // cache
+  if (calib_check(100)) return;
   // zero
   CH1US_MEAN = 0.0;
   for (int i=0; i<3; i++) OMEGA_MEAN[i] = ACCEL_MEAN[i] = 0.0;
@@ -808,6 +989,7 @@ void mean_init(void) {
     OMEGA_MEAN[i] = OMEGA_MEAN[i]/count;
     ACCEL_MEAN[i] = ACCEL_MEAN[i]/count;
   }
+  calib_puts();
 }
 
 // yaw rate := (w,z)
@@ -841,12 +1023,10 @@ float getVibrationalG(float *accel) {
 
 
 //////////////////////////////////////////////////
-// QuickPID with timer interruption
+// ServoPID of GyroM5Core (fixed step, no heap) called by gpid_timing()
 //////////////////////////////////////////////////
-float Setpoint = 0.0;
-float Input = 0.0;
-float Output = 0.0;
-QuickPID GyroPID(&Input, &Output, &Setpoint, 1.0,0.0,0.0, QuickPID::DIRECT);
+ServoPID GyroPID;   // with servo lag (SPD/SPS/SPT/SPG) and stick feedforward (FF)
+unsigned long GPID_LAST = 0;
 
 // PWM input values in usec
 int CH1_USEC = 0;
@@ -865,23 +1045,31 @@ float IMU_ACCEL[3];
 //Ticker tickerPID;
 //hw_timer_t *timerPID = NULL;
 
-// PID setup
-void gpid_init(bool resetPID=false) {
+// PID tunings only (bumpless, no reset of the servo model)
+void gpid_tune() {
   float Kp = (CONFIG[_KP]/50.);
   float Ki = (CONFIG[_KI]/250.);
   float Kd = (CONFIG[_KD]/5000.);
-  int Min = int(CONFIG[_MIN] - CH1US_MEAN);
-  int Max = int(CONFIG[_MAX] - CH1US_MEAN);
 
-  GyroPID.SetTunings(Kp,Ki,Kd);
-  GyroPID.SetOutputLimits(Min,Max);
+  GyroPID.setGains(Kp,Ki,Kd);
+  // model gain: SPG in 0.01 (o/s)/usec (K of tools/sysid) times KG
+  GyroPID.setPredictor(CONFIG[_SPD],CONFIG[_SPS],CONFIG[_SPT],CONFIG[_KG]/20.*CONFIG[_SPG]/100.,CONFIG[_FF]/100.);
+}
+
+// PID setup
+void gpid_init(bool resetPID=false) {
+  GyroPID.setup(CONFIG[_KP]/50.,CONFIG[_KI]/250.,CONFIG[_KD]/5000., CONFIG[_MIN],CH1US_MEAN,CONFIG[_MAX], CONFIG[_PWM]);
+  GyroPID.setTimer(true);
+  gpid_tune();
+  ch1_shape(true);
+  WATCH.setMode(CONFIG[_SAFE],int(CH1US_MEAN));
+  POWER.setup(CONFIG[_POW]);
+  // REC: 750msec before and 500msec after the trigger (no drift angle on Stick)
+  REC.setup(REC_HZ,750,500);
+  REC.setLimits(CONFIG[_RYW],0,CONFIG[_RCS],int(CH1US_MEAN),CONFIG[_CH1]);
   
   if (resetPID) {
-    int CycleInUs = 1000000/CONFIG[_PWM];
-    //int CycleInUs = 1000000/countHz(true);
-    GyroPID.SetSampleTimeUs(CycleInUs);
-    GyroPID.SetMode(QuickPID::TIMER);
-    //GyroPID.SetMode(QuickPID::AUTOMATIC);
+    GyroPID.PID.reset(GyroPID.Input,0.0,GyroPID.Setpoint);
 
     // PID timer is not working
     //tickerPID.attach(CycleInUs/1000000.0,gpid_update);
@@ -893,9 +1081,92 @@ void gpid_init(bool resetPID=false) {
 }
 
 // PID loop
+// CH1 while the link is lost by CONFIG[_FS] (0:hold, 1:pass, 2:neutral)
+int gpid_failsafe(int ch1) {
+  static int lastUsec = 0;
+  if (ch1 > 0) return (lastUsec = ch1);
+  switch (CONFIG[_FS]) {
+    case 0: return lastUsec;
+    case 2: return int(CH1US_MEAN);
+    default: return 0;
+  }
+}
+
+// REC: offered each PID step (sampled at REC_HZ by time), triggers by deadline and dropout
+void rec_put(int ch1, float yrate, int usec) {
+  static int lastMissed = 0;
+  static bool lastLive = true;
+  bool live = (CH1_USEC > 0);
+  int missed = WATCH.getMissed();
+  if (missed != lastMissed && lastLive && live) REC.trigger(REC_DEADLINE);
+  if (lastLive && !live) REC.trigger(REC_DROPOUT);
+  lastMissed = missed;
+  lastLive = live;
+  //
+  FlightSample S;
+  S.time = micros();
+  S.ch1 = ch1;
+  S.ch3 = CH3_USEC;
+  for (int i=0; i<3; i++) {
+    S.gyro[i] = constrain(10*IMU_OMEGA[i], -32767, 32767);
+    S.accl[i] = constrain(1000*IMU_ACCEL[i], -32767, 32767);
+  }
+  S.rate = constrain(10*yrate, -32767, 32767);
+  S.slip = S.roll = S.pitch = 0;
+  S.p = constrain(10*GyroPID.PID.getP(), -32767, 32767);
+  S.i = constrain(10*GyroPID.PID.getI(), -32767, 32767);
+  S.d = constrain(10*GyroPID.PID.getD(), -32767, 32767);
+  S.out = usec;
+  S.duty = CH1_SHAPE.lastDuty;
+  S.flags = 0;
+  REC.put(S);
+}
+
+// CH3 remote gain at every PID step: CH3 >> LPF >> steps with hysteresis >> CONFIG[_CH3] target
+// (true when CONFIG has changed, so tunings are updated only then)
+float GAIN_LPF = 0.0;
+int GAIN_LAST = -1;
+int GAIN_MODE = 0;
+bool gain_update(int ch3, int usec) {
+  if (ch3 <= 0 || CONFIG[_CH3] != GAIN_MODE) {
+    GAIN_LAST = -1;
+    GAIN_MODE = CONFIG[_CH3];
+  }
+  if (ch3 <= 0 || CONFIG[_CH3] == 0) return false;
+  if (CONFIG[_CH3] == 5) {
+    // PID off by CH3
+    bool changed = (CONFIG[_KP] != 50 || CONFIG[_KG] != 0 || CONFIG[_KI] != 0 || CONFIG[_KD] != 0);
+    CONFIG[_KP] = 50; CONFIG[_KG] = CONFIG[_KI] = CONFIG[_KD] = 0;
+    return changed;
+  }
+  float gain = (ch3 - (PULSE_MIN+PULSE_MAX)/2.0)*GAIN_AMP/PULSE_AMP;
+  gain = constrain(gain, GAIN_MIN,GAIN_MAX);
+  if (GAIN_LAST < 0) GAIN_LPF = gain;
+  else GAIN_LPF += usec/(GAIN_TAU*1000.0 + usec)*(gain - GAIN_LPF);
+  int step = GAIN_LAST;
+  if (step < 0 || fabs(GAIN_LPF - step) > GAIN_HYST) step = int(GAIN_LPF + 0.5);
+  if (step == GAIN_LAST) return false;
+  GAIN_LAST = step;
+  int *target = NULL;
+  switch (CONFIG[_CH3]) {
+    case 1: target = &CONFIG[_KG]; break;
+    case 2: target = &CONFIG[_KP]; break;
+    case 3: target = &CONFIG[_KI]; break;
+    case 4: target = &CONFIG[_KD]; break;
+    default: return false;
+  }
+  if (*target == step) return false;
+  *target = step;
+  return true;
+}
+
 void gpid_update() {
   int ch1_usec;
+  int ch1 = gpid_failsafe(CH1_USEC);
   float yrate;
+
+  // CH3 >> CONFIG >> ServoPID (only when the gain steps)
+  if (gain_update(CH3_USEC, PWM_USEC)) gpid_tune();
   float Kg = (CONFIG[_KG]/20.0);
  
   // Input IMU
@@ -906,20 +1177,17 @@ void gpid_update() {
   Kg = CONFIG[_CH1]? -Kg: Kg;
   yrate = getYawRate(IMU_OMEGA);
   
-  // Compute PID
-  Setpoint = CH1_USEC>0? CH1_USEC - CH1US_MEAN: 0.0;
-  Input = Kg * yrate;
-  GyroPID.Compute();
-  ch1_usec = constrain(CH1US_MEAN + Output, CONFIG[_MIN],CONFIG[_MAX]);
+  // Compute PID (0 while CH1 is lost)
+  ch1_usec = GyroPID.loop(ch1, Kg * yrate);
   
   // Output PWM
-  ch1_setUsec((CH1_USEC>0? ch1_usec: 0));
+  ch1_setUsec(ch1_usec);
+  rec_put(ch1, yrate, ch1_usec);
 }
 //
 bool gpid_timing(int usec) {
-  static unsigned long lastTime = 0;
-  if (lastTime + usec < micros()) {
-    lastTime = micros();
+  if ((long)(micros() - GPID_LAST) > usec) {
+    GPID_LAST = micros();
     return true;
   }
   return false;
@@ -950,6 +1218,7 @@ void setup() {
   pwmin_init(CH1_IN,&CH1_USEC,&CH1_FREQ,PWM_WAIT);
   pwmin_init(CH3_IN,&CH3_USEC,&CH3_FREQ,PWM_WAIT);
   ch1_setFreq(CONFIG[_PWM]);
+  Board::initPins();
   
   // (5) Initialize Ring buffer
   data_init(DATA_Setpoint,"CH1",TFT_CYAN);
@@ -964,6 +1233,9 @@ void setup() {
 
   // (8) setup others
   //Serial.begin(115200);
+  WATCH.setup(watch_in,watch_out);
+  ResourceMonitor::setup();
+  ResourceMonitor::watch("timer",xTaskGetHandle("esp_timer"));
 }
 
 
@@ -975,22 +1247,25 @@ void loop() {
   // Fetch Setpoint/Input and compute Output by PID
   //CH1_USEC = pulseIn(CH1_IN,HIGH,PWM_WAIT);
   if (gpid_timing(PWM_USEC)) {
+    POWER.begin();
     gpid_update();
     countHz();
+    POWER.end(PWM_USEC);
+    WATCH.tick(PWM_USEC);
   }
   
   // Sample PID variables in every 100msec
   if (data_sample(DATA_MSEC)){
-    data_put(0,Setpoint);
-    data_put(1,Output);
-    data_put(2,Input);
+    data_put(0,GyroPID.Setpoint);
+    data_put(1,GyroPID.Output);
+    data_put(2,GyroPID.Input);
   }
 
   // Monitor variables in every 500msec
+  const char *tag = WATCH.cause("lcd");
   if (canvas_header("HOME",LCD_MSEC)) {
     int lastData = 8*1000/DATA_MSEC;
     int lastLine = 1;
-    int ch3_gain;    
     // RCV monitor
     //canvas.println("RCV (us)"); lastLine++;
     //canvas.printf( " CH1:%6d\n", CH1_USEC); lastLine++;
@@ -1001,6 +1276,13 @@ void loop() {
     canvas.printf( " IN :%6d\n", CH1_FREQ); lastLine++;
     canvas.printf( " OUT:%6d\n", PWM_FREQ); lastLine++;
     canvas.printf( " PID:%6d\n", countHz(true)); lastLine++;
+    canvas.printf( " MHz:%6d\n", POWER.getMhz()); lastLine++;
+    canvas.printf( " mA :%6.0f\n", POWER_MA); lastLine++;
+    // link: glitches/dropouts (with room above the graph)
+    if (lastLine < Board::PLOT/8 - 3) {
+      LinkHealth& link = pwmin_link(0);
+      canvas.printf( " G/D:%3u/%2u\n", (unsigned)link.glitches%1000,(unsigned)link.dropouts%100); lastLine++;
+    }
     // IMU monitor
     //canvas.println("OMEGA (rad/s)"); lastLine++;
     //canvas.printf( " X:%8.2f\n", IMU_OMEGA[0]); lastLine++;
@@ -1014,6 +1296,12 @@ void loop() {
     canvas.println("PID (0-100)"); lastLine++;
     canvas.printf( " G/P:%3d/%3d\n", CONFIG[_KG],CONFIG[_KP]); lastLine++;
     canvas.printf( " I/D:%3d/%3d\n", CONFIG[_KI],CONFIG[_KD]); lastLine++;
+    // SYS monitor: free heap [kB] and CPU load [%] of core 0/1 (with room above the graph)
+    ResourceMonitor::sample();
+    if (lastLine < Board::PLOT/8 - 1) {
+      canvas.printf( " KB :%6u\n", (unsigned)(ResourceMonitor::heapFree/1024)); lastLine++;
+      canvas.printf( " CPU:%3d/%3d\n", ResourceMonitor::load[0],ResourceMonitor::load[1]); lastLine++;
+    }
     //canvas.printf( " MAE:%6.1f\n", data_MAE(0,2,lastData)); lastLine++;
     //canvas.printf( "RMSE:%6.1f\n", data_RMSE(0,2,lastData)); lastLine++;
     // RGB graph
@@ -1021,31 +1309,19 @@ void loop() {
     data_grid(CONFIG[_MIN]-CH1US_MEAN);
     data_grid(CONFIG[_MAX]-CH1US_MEAN);
     data_draw(lastData,lastLine);
-    // LCD draw
-    canvas_footer("HOME");
-    
-    // CH3 >> CONFIG
-    //CH3_USEC = pulseIn(CH3_IN,HIGH,PWM_WAIT);
-    if (CH3_USEC > 0) {
-      ch3_gain = map(CH3_USEC, PULSE_MIN,PULSE_MAX, -GAIN_AMP,GAIN_AMP);
-      ch3_gain = constrain(ch3_gain, GAIN_MIN,GAIN_MAX);
-      switch (CONFIG[_CH3]) {
-        case 1: CONFIG[_KG] = ch3_gain; break;
-        case 2: CONFIG[_KP] = ch3_gain; break;
-        case 3: CONFIG[_KI] = ch3_gain; break;
-        case 4: CONFIG[_KD] = ch3_gain; break;
-        case 5: CONFIG[_KG] = 50; CONFIG[_KG] = CONFIG[_KI] = CONFIG[_KD] = 0; break;
-        default: break;
-      }
-    }
-    // CONFIG >> QuickPID
-    gpid_init();    
+    // LCD draw (LOST while CH1 link is down)
+    pwmin_link(0).roll();
+    canvas_footer((char*)(pwmin_link(0).isDown()? "LOST": "HOME"));
   }
+  WATCH.cause(tag);
+  watch_report();
 
   // Watch vin and buttons
   vin_watch();
   M5.update();
-  if (M5.BtnA.isPressed()) setup_by_wifi();
+  power_loop(M5.BtnA.isPressed() || M5.BtnB.isPressed());
+  if (M5.BtnA.isPressed()) { REC.freeze(REC_BUTTON); setup_by_wifi(); }
   else
-  if (M5.BtnB.isPressed()) setup_ch1ends();
+  if (M5.BtnB.isPressed()) { setup_ch1ends(); gpid_init(); }
+  else POWER.idle(GPID_LAST + PWM_USEC - 1000); // the last 1msec by polling
 }
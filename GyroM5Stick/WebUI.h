@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+// WebUI.h: 設定画面（gzip圧縮済み）
+//  tools/webgz で html/*.html から生成（直接編集しない）
+////////////////////////////////////////////////////////////////////////////////
+#ifndef WEBUI_H
+#define WEBUI_H
+
+// index.html: 6058 -> 1610 bytes
+const char WEBUI_INDEX_ETAG[] = "\"05266837\"";
+const size_t WEBUI_INDEX_LEN = 1610;
+const uint8_t WEBUI_INDEX[] PROGMEM = {
+ 0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0xb5,0x58,0x5b,0x73,0xda,0x38,
+ 0x14,0x7e,0xe7,0x57,0xa8,0x99,0xd9,0xb1,0x99,0x10,0x2e,0x49,0xd3,0x07,0x6e,0x3b,
+ 0xdb,0x10,0x08,0x4d,0x48,0x98,0x40,0x36,0xed,0x74,0xfa,0xa0,0xd8,0x32,0xd6,0xd6,
+ 0xc8,0x5e,0x49,0x86,0xd0,0x4e,0xff,0xfb,0x9e,0x63,0x71,0x0b,0x18,0xd6,0x4c,0x93,
+ 0xc9,0x04,0xdb,0xba,0x7c,0xe7,0xfb,0x74,0x2e,0x92,0x5d,0x7f,0xd7,0xba,0xbb,0x18,
+ 0x7e,0xe9,0x5f,0x92,0xab,0x61,0xef,0xa6,0x99,0xab,0xfb,0x7a,0x1c,0xe0,0x85,0x51,
+ 0x17,0x2e,0x63,0xa6,0x29,0x11,0x74,0xcc,0x1a,0xd6,0x84,0xb3,0x69,0x14,0x4a,0x6d,
+ 0x11,0x27,0x14,0x9a,0x09,0xdd,0xb0,0xa6,0xdc,0xd5,0x7e,0xc3,0x65,0x13,0xee,0xb0,
+ 0x93,0xe4,0xa1,0xc0,0x05,0xd7,0x9c,0x06,0x27,0xca,0xa1,0x01,0x6b,0x54,0x2c,0x52,
+ 0x02,0x14,0xcd,0x75,0xc0,0x9a,0x9d,0x99,0x0c,0x7b,0xe7,0x93,0xd3,0x7a,0xc9,0x3c,
+ 0xe7,0xea,0xa5,0xb9,0x95,0xa7,0xd0,0x9d,0xc1,0xc5,0x0b,0xe5,0x98,0x80,0x45,0x3f,
+ 0x74,0x1b,0xd6,0x88,0x81,0x25,0x63,0x59,0x31,0xad,0xb9,0x18,0x59,0x88,0x44,0x9f,
+ 0x92,0x99,0x5a,0x36,0xeb,0xda,0x6f,0x62,0x3f,0xc0,0xf9,0xc9,0x83,0xa4,0x62,0xb4,
+ 0x7a,0x9a,0xd0,0x20,0x5e,0x3d,0xb9,0x4c,0x39,0x92,0x47,0x9a,0x87,0xc2,0xb4,0x95,
+ 0x00,0x61,0x0e,0xe3,0x36,0xaf,0x3b,0xf0,0xec,0x26,0xb7,0x75,0x2e,0xa2,0x58,0x13,
+ 0x3d,0x8b,0xc0,0x70,0x82,0xb8,0x60,0x71,0xdd,0xb1,0xc8,0x98,0x8b,0x86,0x55,0x86,
+ 0x2b,0x7d,0x6e,0x58,0x95,0x32,0xdc,0x29,0xcd,0x22,0xb8,0xb5,0x48,0x62,0x2f,0xe9,
+ 0x0c,0x45,0x82,0xd1,0xb0,0x42,0xd1,0xc5,0x1b,0x5b,0xfb,0x5c,0xe5,0x71,0x25,0x56,
+ 0x56,0x54,0x44,0x05,0xe1,0x6e,0x82,0xda,0x2c,0xd7,0x4b,0xf8,0xbc,0xea,0xee,0xf6,
+ 0x1e,0xc8,0x88,0x72,0x41,0x3a,0xc4,0x2e,0x9f,0x80,0x9d,0xbc,0xe9,0x7a,0x49,0xba,
+ 0x9f,0x85,0x74,0xff,0x4d,0x48,0xf7,0x53,0x48,0xf7,0xbb,0x2d,0x43,0xba,0xbf,0x8f,
+ 0x74,0x37,0x0b,0xe9,0xee,0x9b,0x90,0xee,0xee,0x23,0xdd,0xdd,0x47,0xba,0x95,0x85,
+ 0x74,0xeb,0x4d,0x48,0xb7,0xf6,0x91,0x6e,0xed,0x21,0x7d,0x71,0x55,0xc9,0xc0,0x1a,
+ 0x46,0x6d,0xd2,0xfe,0x7d,0xd2,0x08,0xba,0xcd,0xba,0x5c,0xbd,0xbd,0xbb,0x2f,0x90,
+ 0x4a,0xf5,0xfe,0xf2,0xef,0x54,0xbe,0x67,0x99,0xf8,0x9e,0x6d,0xf0,0x3d,0x7f,0x0d,
+ 0xbe,0x67,0xa9,0x7c,0x87,0x1f,0x91,0xee,0x75,0xa7,0x40,0x4e,0xab,0xd7,0xfd,0x02,
+ 0x39,0xab,0x5e,0x77,0x0b,0xe4,0x7d,0xf5,0xba,0x55,0x20,0xe7,0xa0,0x26,0x45,0x45,
+ 0xff,0xb1,0x97,0x41,0x05,0x8c,0x9a,0xab,0x38,0x5f,0xc8,0x78,0xbf,0x8a,0x16,0x6c,
+ 0x9b,0x2b,0x39,0x3f,0x54,0x0a,0x22,0x37,0xcf,0x97,0x5a,0x0c,0x23,0xe2,0x49,0xf6,
+ 0x6f,0xcc,0x84,0x33,0x23,0xf6,0xd5,0x8f,0xb4,0x60,0x19,0xf4,0xb3,0x84,0x38,0x8c,
+ 0x7a,0x8b,0x18,0x47,0xd8,0xed,0xe5,0x57,0x4c,0x4e,0x42,0xe2,0xc2,0x06,0x41,0x34,
+ 0x1f,0x33,0x62,0x8f,0x15,0x73,0x0a,0xa4,0x5c,0x15,0x21,0x89,0x24,0x73,0xb9,0xa3,
+ 0x43,0x99,0xae,0x65,0x90,0x49,0xcb,0x60,0x33,0x90,0x5e,0x45,0xca,0x60,0xa7,0x14,
+ 0x15,0x31,0xe6,0x12,0x3b,0x06,0x19,0xa5,0x35,0x2d,0x01,0x1f,0x73,0x9d,0xae,0x63,
+ 0x98,0x49,0xc7,0x70,0x4b,0xc7,0x4a,0xc8,0x2a,0x92,0x12,0x4f,0x1d,0xa8,0x65,0x68,
+ 0x35,0x61,0xda,0xa6,0x1a,0x87,0x4a,0xe3,0x11,0x38,0x06,0x28,0x4d,0x85,0x5e,0xb8,
+ 0x66,0x48,0x42,0x8f,0xa8,0x99,0xe2,0x6e,0xba,0x9c,0x4e,0x26,0x39,0x9b,0xbb,0xec,
+ 0x69,0x5a,0x88,0x9d,0x1f,0x2e,0xa6,0xb3,0x9e,0x17,0xeb,0x5a,0x92,0x4a,0x6a,0x97,
+ 0x8b,0xe5,0x0a,0x44,0xdb,0xa8,0x84,0xee,0x89,0x13,0x3d,0xd7,0x7b,0xf5,0xb4,0xdb,
+ 0x19,0xe4,0xb4,0xdb,0x6f,0x91,0x30,0x80,0x9a,0x12,0x64,0x9a,0x3b,0xdf,0x89,0x07,
+ 0x31,0x06,0xc7,0xa8,0x29,0x95,0x10,0x6a,0x7f,0xa4,0xf1,0xbe,0xfc,0x9c,0xe5,0xdc,
+ 0x00,0xa3,0xde,0x82,0x39,0xc2,0xee,0xca,0x0f,0xf6,0x1c,0x85,0x3b,0x38,0x0f,0xef,
+ 0xb3,0x54,0x55,0x18,0x35,0xe7,0x7c,0x92,0x90,0x7d,0x3d,0xda,0x88,0xbc,0x33,0xad,
+ 0xe3,0x27,0x2d,0xf9,0xd8,0x24,0x76,0x6a,0xe0,0xdf,0x3c,0x66,0x09,0xfc,0x9b,0xc7,
+ 0xb7,0xa8,0x47,0x80,0xba,0x8b,0xb8,0xa4,0x9a,0x99,0xea,0x73,0x40,0x51,0xba,0xff,
+ 0x92,0x45,0x0c,0x8c,0xda,0x8e,0x9e,0xb4,0xaa,0xf4,0xe1,0xe0,0xaa,0x84,0xd0,0xcd,
+ 0x0f,0xdb,0x55,0x49,0x32,0x27,0x94,0x2e,0x83,0xd2,0x24,0xf9,0x68,0x04,0xd7,0x19,
+ 0x9d,0x1a,0x89,0xf6,0x3c,0xab,0x51,0x5a,0xe8,0x79,0xa9,0xaa,0x2e,0xb2,0x6c,0x19,
+ 0x30,0x2a,0x53,0xa9,0x3d,0x58,0xd2,0x45,0xda,0xa6,0xb1,0x25,0xc8,0x09,0x63,0x78,
+ 0xed,0x92,0x68,0x0f,0x7e,0xed,0x78,0xbf,0xa4,0xfe,0x5d,0x16,0x47,0xc1,0xa8,0xd7,
+ 0x3f,0xfe,0x21,0xe8,0xb6,0x9e,0x8b,0xfe,0x03,0x71,0x82,0x10,0x6a,0x54,0xb9,0x7a,
+ 0xfa,0xbe,0xdc,0xbb,0xfa,0x41,0x3c,0xfe,0xcc,0x5c,0x3c,0x62,0xd1,0x58,0x87,0x69,
+ 0x99,0xf3,0x57,0xfb,0x32,0x4b,0xea,0xc0,0xb0,0xcd,0x4d,0x63,0x5b,0x45,0xe5,0xd0,
+ 0xd4,0x41,0xd4,0x66,0x65,0xbb,0xcc,0xd2,0x20,0x20,0x1e,0xfc,0x3c,0xd1,0x44,0x8b,
+ 0x1f,0x06,0x89,0x86,0x88,0x2a,0x85,0x07,0x45,0xc1,0x62,0x2d,0x69,0x90,0xb6,0x63,
+ 0x64,0x09,0xb2,0xf6,0xe0,0xf5,0xa5,0x00,0xe6,0xb6,0x10,0x8f,0xf2,0x40,0x51,0x8f,
+ 0x65,0x93,0x50,0x5a,0xbc,0x78,0xaf,0x13,0xf7,0xb9,0xeb,0x32,0xb1,0x60,0xfe,0x69,
+ 0x30,0x5c,0x32,0x84,0x4d,0xbb,0x5c,0x29,0x9f,0xc2,0xff,0x19,0xfc,0x99,0x8f,0x00,
+ 0xeb,0x33,0xa1,0x68,0x42,0x81,0x59,0x0e,0x8f,0xa3,0x20,0x84,0x73,0xde,0xe2,0x3d,
+ 0x1f,0xd4,0x39,0x01,0xec,0x66,0xa8,0x6e,0x90,0x8c,0xb4,0xf3,0xdb,0x18,0x4f,0xb1,
+ 0xd6,0xa1,0x58,0x62,0xb8,0xe1,0x54,0x24,0x28,0x2e,0xd5,0x74,0x0d,0x62,0xca,0x05,
+ 0x74,0x15,0x21,0xf2,0x28,0xbe,0xfd,0x37,0x36,0x9e,0x8b,0xbe,0x64,0x5e,0x51,0x45,
+ 0x01,0x18,0x39,0xfa,0xf3,0x28,0xff,0xb5,0xfc,0xed,0xf8,0xc8,0x51,0x93,0xa3,0xda,
+ 0xff,0x5a,0x0c,0xb8,0xf8,0x4e,0x7c,0x46,0x03,0xed,0xff,0xa6,0x3d,0x1a,0xf1,0x12,
+ 0xa2,0x65,0x30,0x2a,0x99,0x0a,0x63,0xe9,0x30,0xf5,0x0a,0x26,0xe1,0x6c,0x93,0xc1,
+ 0xa2,0x17,0xf0,0x91,0xaf,0xc9,0xa2,0x1e,0xbd,0x82,0x5d,0x80,0xca,0xa4,0x74,0x47,
+ 0x50,0x1c,0x6e,0x76,0x6e,0xac,0x84,0x1f,0x98,0xf0,0x3a,0xff,0xde,0x64,0x3e,0x09,
+ 0x35,0x73,0x5e,0x2c,0x1c,0x9c,0x49,0x16,0xc9,0x14,0x3e,0xfd,0x93,0x27,0x3f,0x89,
+ 0x1b,0x3a,0xf1,0x98,0x09,0x5d,0x1c,0x31,0x7d,0x19,0x30,0xbc,0xfd,0x38,0xeb,0xba,
+ 0xd8,0x5d,0xc4,0x98,0xcf,0x17,0x35,0x7b,0xd6,0x17,0xe6,0x6b,0x18,0x69,0x10,0x6c,
+ 0x4f,0xc8,0xd7,0xc8,0xaf,0x75,0xd0,0x1b,0xd0,0x61,0x03,0x60,0x8e,0x7b,0xc4,0xde,
+ 0x64,0xab,0x18,0x95,0x8e,0x8f,0xbd,0xa5,0x12,0x51,0x74,0xc2,0xdc,0x2a,0x51,0x7e,
+ 0x38,0x25,0xda,0x67,0xc4,0x24,0x06,0x5b,0xae,0x02,0xb1,0x1f,0x79,0x9b,0x13,0xae,
+ 0xb0,0x94,0x2a,0x68,0xa7,0x1e,0x6e,0x09,0x66,0x58,0x3e,0x97,0x9c,0xc8,0xc9,0xc5,
+ 0xdd,0x6d,0xbb,0xdb,0x01,0x3e,0x3f,0x7f,0xd5,0x72,0x20,0x99,0xd8,0x01,0xd3,0xe4,
+ 0xeb,0x77,0x36,0x2b,0x00,0xbb,0x6f,0x78,0xaa,0x15,0x6c,0x4a,0x1e,0xee,0x6f,0x06,
+ 0x89,0xed,0x3e,0x95,0x74,0xac,0x76,0x11,0xcb,0x13,0x64,0x0d,0x93,0xc9,0xbb,0x06,
+ 0x49,0x92,0x3c,0x3f,0xb7,0x80,0x88,0xdf,0xc0,0x0c,0x80,0xd6,0x72,0x40,0x10,0x16,
+ 0xc2,0xe3,0x23,0xdb,0x74,0x16,0xb4,0x8c,0x59,0xbe,0x96,0x93,0x4c,0xc7,0x52,0xd4,
+ 0x72,0xbf,0xe6,0xe4,0x9e,0x7d,0x09,0x53,0xd0,0xfe,0xe7,0xde,0xcd,0x95,0xd6,0xd1,
+ 0x3d,0xbe,0x9a,0x2a,0xc8,0xf0,0x5a,0x0e,0xfa,0x8a,0x61,0xc4,0x84,0x6d,0x75,0x2e,
+ 0x87,0x56,0xc1,0x2a,0x61,0xb0,0x38,0x09,0xaa,0xb5,0xe8,0x36,0x39,0xde,0x20,0x8b,
+ 0xe5,0xc5,0x75,0x25,0x2b,0xe3,0x9f,0x06,0x77,0xb7,0xc5,0x88,0x4a,0xc5,0x6c,0x1c,
+ 0x0e,0xd9,0x12,0x81,0x59,0x96,0x2f,0x40,0xc5,0x86,0x0b,0x3a,0xc6,0xc0,0x30,0x29,
+ 0x43,0x99,0x82,0x33,0x84,0x37,0x9b,0x10,0x43,0x20,0xf1,0x5a,0x01,0xcf,0x2d,0xcb,
+ 0x59,0x8a,0x09,0x17,0x79,0xae,0x39,0x77,0x4b,0x36,0xee,0x70,0xe8,0x4c,0xa3,0xb6,
+ 0x7b,0xdb,0x7f,0x18,0x0e,0xc0,0x4c,0x4a,0x28,0xa9,0x8f,0xb3,0x21,0x1d,0xdd,0x42,
+ 0x1c,0xd9,0x56,0x92,0x06,0xa8,0x71,0xe9,0x2e,0x5c,0x70,0x78,0x2f,0x31,0xa8,0xf9,
+ 0x9f,0x3b,0x00,0x92,0xd9,0x30,0x14,0x83,0xdc,0x84,0x5e,0xba,0xad,0x24,0x6c,0x71,
+ 0xdc,0x8b,0x88,0x85,0xb1,0x6b,0x9e,0x44,0x95,0xe8,0xea,0xb9,0x02,0x92,0x50,0x99,
+ 0xc0,0x0b,0x12,0x6f,0x94,0x6b,0xbc,0x6e,0xa4,0x14,0x03,0x26,0x46,0xda,0x3f,0xa9,
+ 0xd4,0x08,0x3f,0x3e,0xc6,0x61,0xa6,0xfd,0x2b,0xff,0x56,0x74,0xb9,0xc2,0x4d,0x02,
+ 0xbd,0x83,0xce,0x07,0x3c,0x40,0x5c,0x5b,0xab,0xd6,0xa9,0x2d,0x70,0x86,0x09,0x09,
+ 0x62,0xc3,0x16,0x77,0x2c,0xf2,0x45,0x05,0x59,0xcd,0xec,0x93,0xd3,0xfc,0x46,0xd6,
+ 0x2c,0x2a,0xff,0x72,0x31,0x05,0x24,0x85,0x09,0x9d,0x16,0x9c,0xeb,0xd0,0x11,0xa6,
+ 0x5d,0xe9,0x24,0xa4,0x20,0x76,0x41,0x70,0x3b,0x0e,0x82,0x2f,0x10,0xb9,0x30,0xef,
+ 0x38,0xb1,0x68,0x9a,0x7b,0x20,0xd9,0xb7,0xf3,0xc7,0x95,0x97,0xcd,0x06,0xe8,0x65,
+ 0xdb,0x15,0xd4,0x57,0xb5,0xd9,0xd8,0xe3,0x22,0xd6,0x6c,0xab,0x79,0x00,0x45,0x51,
+ 0xb8,0xd8,0x5c,0xcb,0xed,0xf1,0x90,0x49,0x9b,0x75,0x1f,0x01,0x67,0x8c,0xa3,0x79,
+ 0xce,0x2d,0xa3,0x7a,0x51,0x2b,0x6a,0x50,0xa4,0x16,0xd5,0xa9,0x5e,0x32,0x9f,0xe4,
+ 0xff,0x03,0x28,0xeb,0xca,0xcf,0xaa,0x17,0x00,0x00,
+};
+
+#endif
@@ -0,0 +1,1090 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// GyroM5Core.hpp: 全ボード共通のコア（ボード特性と制御経路の共通部品）
+//  Arduinoライブラリ libraries/GyroM5Core に1つだけ置き（PIDEngine.hpp も）、各スケッチは <GyroM5Core.hpp> で読む
+//  （Arduino IDEのスケッチブックの場所をこのリポジトリにするか、libraries/GyroM5Core をライブラリのフォルダへ）
+//  インクルードの前に GYROM5_BOARD でボードを選ぶ（ボードのヘッダもここで読む）
+//
+//  BoardTraits<>: ボードの違い（ピン、LCD、IMU、電源IC、停止）をコンパイル時に解決
+//   Board::CH1_IN など定数と、halt()/initPins() の静的関数（実行時の分岐なし）
+//  LinkHealth{}: 受信のリンク品質（雑音、途絶、フレーム間隔のヒストグラム）
+//  PulseCapture{}: PWM入力のエッジ処理（割り込み）、雑音の除去とタイムアウト（全ボード共通）
+//   edge(): エッジ1回の処理（正常なパルスの立下りでtrue）
+//   expire(): 入力が途絶えたら幅と周期を0に（タイマ）
+//  ServoPredictor{}: サーボの遅れ（むだ時間と速度制限）を補うスミス予測器とFF（全ボード共通）
+//  OutputShaper{}: 出力の曲線（エキスポ、左右別のエンド、サブトリム、速度制限）をLEDCのデューティ表に（全ボード共通）
+//  ServoPID{}: PIDEngine とサーボの予測器をまとめた操舵のPID（全ボード共通）
+//  Supervisor{}: 制御周期の監視と停止中の縮退出力（全ボード共通）
+//  PowerManager{}: CPU周波数とアイドル/ライトスリープの管理（全ボード共通）
+//  ResourceMonitor{}: ヒープ、タスクのスタック、コアごとのCPU負荷の監視（全ボード共通）
+//  FlightRecorder<>: 一定間隔の標本を常に記録し、きっかけの前後を保存（フライトレコーダ、全ボード共通）
+////////////////////////////////////////////////////////////////////////////////
+#ifndef GYROM5_CORE_HPP
+#define GYROM5_CORE_HPP
+
+#define BOARD_STICK     1   // M5StickC
+#define BOARD_STICKPLUS 2   // M5StickC Plus
+#define BOARD_ATOM      3   // M5Atom Matrix
+
+#ifndef GYROM5_BOARD
+#error "GYROM5_BOARD is not defined (BOARD_STICK, BOARD_STICKPLUS or BOARD_ATOM)"
+#endif
+
+#if GYROM5_BOARD == BOARD_STICK
+#include <M5StickC.h>
+#elif GYROM5_BOARD == BOARD_STICKPLUS
+#include <M5StickCPlus.h>
+#elif GYROM5_BOARD == BOARD_ATOM
+#include <M5Atom.h>
+#endif
+#include <esp_freertos_hooks.h>
+#include <esp_sleep.h>
+#include <Ticker.h>
+#include "PIDEngine.hpp"
+
+// IMU and power chip (M5.IMU/M5.Axp select the driver)
+enum { IMU_SH200Q_MPU6886, IMU_MPU6886 };
+enum { POWER_NONE, POWER_AXP192 };
+
+
+////////////////////////////////////////////////////////////////////////////////
+// BoardTraits<>: ボード特性
+//  CH1_IN/CH3_IN/CH1_OUT: 入出力ピン（CH3_IN<0 はなし）
+//  LCD_W/LCD_H: 画面の大きさ（0はLCDなし）、PLOT: グラフとQRコードの一辺
+//  IMU, POWER: 種類、SSID: 設定用WiFiの名前
+//  halt(): 電源を切る（5V入力が無くなったとき）
+//  initPins(): ボード固有のピン設定（GPIOとPWM出力の設定の後）
+////////////////////////////////////////////////////////////////////////////////
+template <int ID> struct BoardTraits;
+
+// only the selected board is compiled (M5.Axp and Wire1 are not in every library)
+#if GYROM5_BOARD == BOARD_STICK
+template <> struct BoardTraits<BOARD_STICK> {
+  static constexpr const char* SSID = "GyroM5v2";
+  static const int CH1_IN = 26;
+  static const int CH3_IN = 36;
+  static const int CH1_OUT = 0;   // G0 must be HIGH while booting, so shoud be output pin
+  static const int LCD_W = 80;
+  static const int LCD_H = 160;
+  static const int PLOT = 80;
+  static const int IMU = IMU_SH200Q_MPU6886;
+  static const int POWER = POWER_AXP192;
+  // AXP192 halt bit (no PowerOff() in older M5StickC libraries)
+  static void halt(void) {
+    Wire1.beginTransmission(0x34);
+    Wire1.write(0x32);
+    Wire1.endTransmission();
+    Wire1.requestFrom(0x34, 1);
+    uint8_t buf = Wire1.read();
+    Wire1.beginTransmission(0x34);
+    Wire1.write(0x32);
+    Wire1.write(buf | 0x80); // halt bit
+    Wire1.endTransmission();
+  }
+  static void initPins(void) {}
+};
+#endif
+
+#if GYROM5_BOARD == BOARD_STICKPLUS
+template <> struct BoardTraits<BOARD_STICKPLUS> {
+  static constexpr const char* SSID = "GyroM5v2plus";
+  static const int CH1_IN = 26;
+  static const int CH3_IN = 36;
+  static const int CH1_OUT = 0;
+  static const int LCD_W = 135;
+  static const int LCD_H = 240;
+  static const int PLOT = 120;
+  static const int IMU = IMU_MPU6886;
+  static const int POWER = POWER_AXP192;
+  static void halt(void) { M5.Axp.PowerOff(); }
+  // G25 shares the pad with G36 (CH3_IN)
+  static void initPins(void) {
+    gpio_pulldown_dis(GPIO_NUM_25);
+    gpio_pullup_dis(GPIO_NUM_25);
+  }
+};
+#endif
+
+#if GYROM5_BOARD == BOARD_ATOM
+template <> struct BoardTraits<BOARD_ATOM> {
+  static constexpr const char* SSID = "m5atom";
+  static const int CH1_IN = 26;   // Grove
+  static const int CH3_IN = -1;
+  static const int CH1_OUT = 32;  // Grove
+  static const int LCD_W = 0;
+  static const int LCD_H = 0;
+  static const int PLOT = 0;
+  static const int IMU = IMU_MPU6886;
+  static const int POWER = POWER_NONE;
+  static void halt(void) {}
+  static void initPins(void) {}
+};
+#endif
+
+typedef BoardTraits<GYROM5_BOARD> Board;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LinkHealth{}: 受信のリンク品質（割り込みやタイマから記録、loop()から集計）
+//  frame(): 正常なパルス/フレーム（前回からの間隔[usec]をヒストグラムに、途絶からの復帰）
+//  glitch(): 捨てたパルス（幅が範囲外）やフレーム（受信機のフェイルセーフ）
+//  drop(): 途絶（タイムアウト、続く間は1回だけ数える）
+//  isDown(): 途絶中か
+//  roll(): ヒストグラムの窓を進める（loop()から一定周期で、直近の窓をhistに）
+//  printJSON(): 集計のJSON（/api/link）
+////////////////////////////////////////////////////////////////////////////////
+struct LinkHealth {
+  static const int BINS = 8;
+  volatile uint32_t count[BINS];  // frame intervals of this window
+  uint32_t hist[BINS];            // of the last window
+  volatile uint32_t frames, glitches, dropouts;
+  volatile bool down;
+  unsigned long downAt;
+  uint32_t gapUs, worstUs;        // last and longest dropout [usec]
+
+  // upper edges of bins [msec] (50Hz frames in 19-23, one frame missed in 23-40)
+  static int bin(uint32_t us) {
+    static const uint32_t EDGE[BINS-1] = {4000,8000,12000,16000,19000,23000,40000};
+    int b = 0;
+    while (b < BINS-1 && us >= EDGE[b]) b++;
+    return b;
+  }
+  void init(void) {
+    for (int b=0; b<BINS; b++) count[b] = hist[b] = 0;
+    frames = glitches = dropouts = 0;
+    down = false;
+    downAt = 0;
+    gapUs = worstUs = 0;
+  }
+  inline void frame(uint32_t intervalUs, unsigned long tnow) {
+    frames++;
+    count[bin(intervalUs)]++;
+    if (down) {
+      down = false;
+      gapUs = tnow - downAt;
+      if (gapUs > worstUs) worstUs = gapUs;
+    }
+  }
+  inline void glitch(void) { glitches++; }
+  inline void drop(unsigned long tnow) {
+    if (down) return;
+    down = true;
+    downAt = tnow;
+    dropouts++;
+  }
+  inline bool isDown(void) const { return down; }
+  // counts by ISR between copy and clear are lost (one window only)
+  void roll(void) {
+    for (int b=0; b<BINS; b++) {
+      hist[b] = count[b];
+      count[b] = 0;
+    }
+  }
+  size_t printJSON(Print& out) {
+    // each printf under 64 chars (no malloc in Print::printf)
+    size_t n = out.printf("{\"frames\":%u,\"glitches\":%u,", (unsigned)frames, (unsigned)glitches);
+    n += out.printf("\"dropouts\":%u,\"down\":%d,", (unsigned)dropouts, (int)down);
+    n += out.printf("\"gap_ms\":%.1f,\"worst_ms\":%.1f,", gapUs/1000.0F, worstUs/1000.0F);
+    n += out.print("\"bins_ms\":[4,8,12,16,19,23,40,0],\"hist\":[");
+    for (int b=0; b<BINS; b++) n += out.printf("%s%u", (b? ",": ""), (unsigned)hist[b]);
+    n += out.print("]}");
+    return n;
+  }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// PulseCapture{}: PWM入力のエッジ処理（割り込みから呼ぶ、全ボード共通）
+//  立上りから立下りまでをパルス幅、正常なパルスの立上りの間隔を周期とする
+//  幅が minUs〜maxUs の外のパルスは雑音として捨てる（値もタイムアウトも更新しない）
+//  割り込みでは割り算をしない（周波数は getFreq() で周期から）
+//  init(): 初期化（既定の範囲は800〜2200usec）
+//  setWindow(): 正常なパルス幅の範囲[usec]
+//  edge(): エッジ1回の処理（正常なパルスの立下りでtrue）
+//  expire(): 入力が途絶えたら幅と周期を0に（タイマから、途絶の始まりでtrue）
+////////////////////////////////////////////////////////////////////////////////
+struct PulseCapture {
+  int pin;
+  int tout;
+  int minUs, maxUs;
+  // for pulse
+  int dstUsec;
+  int prev;
+  unsigned long last;       // last edge of valid pulses
+  unsigned long lastFall;
+  unsigned long rise;
+  // for freq
+  int dstPeriod;
+  unsigned long lastRise;
+  LinkHealth link;
+
+  void init(int pin_, int toutUs, unsigned long tnow) {
+    pin = pin_;
+    tout = toutUs;
+    minUs = 800;
+    maxUs = 2200;
+    dstUsec = dstPeriod = 0;
+    prev = 0;
+    last = lastFall = rise = lastRise = tnow;
+    link.init();
+  }
+  void setWindow(int min, int max) {
+    minUs = min;
+    maxUs = max;
+  }
+  inline int getFreq(void) const {
+    int p = dstPeriod;
+    return p > 0? 1000000/p: 0;
+  }
+  // true at down edge of valid pulse
+  inline bool edge(int vnow, unsigned long tnow) {
+    if (prev==0 && vnow==1) {
+      // at up edge
+      prev = 1;
+      last = tnow;
+      rise = tnow;
+    }
+    else
+    if (prev==1 && vnow==0) {
+      // at down edge
+      prev = 0;
+      int width = tnow - rise;
+      if (width < minUs || width > maxUs) {
+        // glitch: as if the pulse did not come
+        last = lastFall;
+        link.glitch();
+        return false;
+      }
+      dstUsec = width;
+      dstPeriod = rise - lastRise;
+      link.frame(dstPeriod, tnow);
+      lastRise = rise;
+      last = tnow;
+      lastFall = tnow;
+      return true;
+    }
+    return false;
+  }
+  inline bool expire(unsigned long tnow) {
+    if ((long)(tnow - last) > tout) {
+      dstUsec = 0;
+      dstPeriod = 0;
+      if (!link.isDown()) {
+        link.drop(tnow);
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// ServoPredictor{}: サーボの遅れを補うスミス予測器（PIDの前段）と目標値のフィードフォワード
+//  サーボのモデル: 指令 → むだ時間 → 速度制限 → 舵角（遅延線は固定長のリング、ヒープ不使用）
+//  車両のモデル: 舵角 → 1次遅れ（時定数） → 観測値（ゲイン倍、tools/sysid の K と T）
+//  PIDには観測値に「出したがまだ舵角になっていない指令」の効きを足して渡す
+//  （遅れのないサーボに見える分、KP/KDを上げても発振しにくい）
+//  setup(): むだ時間[msec]、速度[usec/msec]（0:制限なし）、時定数[msec]、モデルゲイン、FFの割合
+//  setRate(): 制御周期[Hz]（遅延線の段数と1周期の速度制限）
+//  isActive(): 予測かFFが有効か（無効なら呼び出し側は素通し）
+//  predict(): PIDに渡す観測値（PV + ゲイン*1次遅れ(指令 - 舵角モデル)）
+//  feed(): 出力に足すフィードフォワード（SPの割合）
+//  push(): 今回の指令（中立からのusec）を遅延線とモデルに入れる（制御周期ごとに1回）
+////////////////////////////////////////////////////////////////////////////////
+struct ServoPredictor {
+  static const int DELAY_MAX = 64;  // steps (160msec at 400Hz), power of 2
+  float line[DELAY_MAX];
+  int head;
+  int deadMs, slewUs;   // servo: dead time [msec], speed [usec/msec]
+  int tauMs;            // car: time constant [msec]
+  float gain, ff;
+  int delay;            // dead time [steps]
+  float step;           // speed [usec/step] (0: no limit)
+  float alpha;          // lag per step
+  float pos;            // servo position of model [usec]
+  float lag;            // lagged (command - position) [usec]
+
+  ServoPredictor() {
+    deadMs = slewUs = tauMs = 0;
+    gain = 1.0F;
+    ff = 0.0F;
+    setRate(50);
+  }
+  void setup(int deadMs_, int slewUs_, int tauMs_, float gain_, float ff_) {
+    deadMs = deadMs_;
+    slewUs = slewUs_;
+    tauMs = tauMs_;
+    gain = gain_;
+    ff = ff_;
+  }
+  void setRate(int hz) {
+    if (hz < 1) hz = 1;
+    delay = deadMs*hz/1000;
+    if (delay > DELAY_MAX-1) delay = DELAY_MAX-1;
+    step = slewUs*1000.0F/hz;
+    alpha = 1000.0F/hz/(tauMs + 1000.0F/hz);
+    for (int i=0; i<DELAY_MAX; i++) line[i] = 0.0F;
+    head = 0;
+    pos = lag = 0.0F;
+  }
+  inline bool isActive(void) const { return deadMs > 0 || slewUs > 0 || ff != 0.0F; }
+  inline float predict(float pv) const { return pv + gain*lag; }
+  inline float feed(float sp) const { return ff*sp; }
+  inline void push(float u) {
+    line[head] = u;
+    float old = line[(head - delay) & (DELAY_MAX-1)];
+    head = (head + 1) & (DELAY_MAX-1);
+    float d = old - pos;
+    if (step > 0.0F) d = (d > step? step: (d < -step? -step: d));
+    pos += d;
+    lag += alpha*((u - pos) - lag);
+  }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// OutputShaper{}: 出力パルス幅[usec]からLEDCのデューティへの曲線（固定長の表を線形補間）
+//  曲線: 中立(mid)から左右それぞれのエンド(lo/hi)までを -1〜+1 に、エキスポ (1-e)x + ex^3 を掛け、
+//  中立+サブトリム から左右のエンドまでに戻す（エンドはトリムで動かない、範囲外はエンドで止める）
+//  表の点は中立の両側に HALF 区間ずつ（中立が点なのでエキスポ0なら補間の誤差なし）
+//  表は周波数とビット数のデューティで持つ（制御周期ごとの除算なし、作り直しは設定か周波数の変更時だけ）
+//  setup(): エンド[usec]、中立[usec]、サブトリム[usec]、エキスポ[%]、速度制限[usec/msec]（0:制限なし）
+//  open(): 曲線なし（500〜2500usecを素通し、エンドの調整や設定画面での手動操作用）
+//  build(): 表の作成（PWMの周期[usec]とビット数、setup()/open()の後と周波数の変更時）
+//  duty(): パルス幅[usec]（0以下はパルスなし）に速度制限と曲線を掛けたデューティ
+//   速度制限は前回の duty() からの経過時間[usec]で決める（呼ぶ回数によらない）
+//   複数の処理から呼ぶなら呼び出し側で排他（状態は last だけ、ledcWrite と一緒に）
+//  getUsec(): 最後の duty() の出力パルス幅[usec]
+////////////////////////////////////////////////////////////////////////////////
+struct OutputShaper {
+  static const int HALF = 32;   // segments on each side of the neutral
+  float lut[2*HALF+1];          // duty at the nodes
+  int lo, mid, hi;              // end points and neutral [usec]
+  int trim, expo, slew;         // subtrim [usec], expo [%], speed [usec/msec]
+  float kLo, kHi;               // nodes per usec on each side
+  float usPerDuty;
+  float last;                   // last width before the curve [usec] (0: no pulse)
+  unsigned long lastTime;       // time of the last duty() [usec]
+  uint32_t lastDuty;
+
+  OutputShaper() {
+    open();
+    build(20000,16);
+  }
+  void setup(int lo_, int mid_, int hi_, int trim_, int expo_, int slew_) {
+    lo = lo_ < mid_? lo_: mid_;
+    hi = hi_ > mid_? hi_: mid_;
+    mid = mid_;
+    trim = trim_;
+    expo = expo_ < 0? 0: (expo_ > 100? 100: expo_);
+    slew = slew_ < 0? 0: slew_;
+  }
+  void open(void) { setup(500,1500,2500,0,0,0); }
+  void build(int periodUs, int bits) {
+    float dutyPerUs = (float)(1UL << bits)/periodUs;
+    float e = expo/100.0F;
+    int zero = mid + trim;
+    for (int i=0; i<=2*HALF; i++) {
+      float x = (i - HALF)/(float)HALF;
+      float y = (1.0F - e)*x + e*x*x*x;
+      float us = zero + y*(y < 0.0F? zero - lo: hi - zero);
+      if (us < lo) us = lo;
+      if (us > hi) us = hi;
+      lut[i] = us*dutyPerUs;
+    }
+    kLo = mid > lo? HALF/(float)(mid - lo): 0.0F;
+    kHi = hi > mid? HALF/(float)(hi - mid): 0.0F;
+    usPerDuty = 1.0F/dutyPerUs;
+    last = 0.0F;
+    lastTime = 0;
+    lastDuty = 0;
+  }
+  inline uint32_t duty(float usec, unsigned long now) {
+    unsigned long dt = now - lastTime;
+    lastTime = now;
+    if (usec <= 0.0F) {
+      last = 0.0F;
+      return lastDuty = 0;
+    }
+    if (slew > 0 && last > 0.0F) {
+      float step = slew*dt/1000.0F;
+      float d = usec - last;
+      usec = last + (d > step? step: (d < -step? -step: d));
+    }
+    last = usec;
+    float f = (usec < mid)? HALF - (mid - usec)*kLo: HALF + (usec - mid)*kHi;
+    if (f < 0.0F) f = 0.0F;
+    if (f > 2*HALF) f = 2*HALF;
+    int i = (int)f;
+    if (i > 2*HALF-1) i = 2*HALF-1;
+    return lastDuty = (uint32_t)(lut[i] + (f - i)*(lut[i+1] - lut[i]));
+  }
+  inline int getUsec(void) const { return (int)(lastDuty*usPerDuty + 0.5F); }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// ServoPID{}: PID（比例、積分、微分）制御アルゴリズム（PIDEngineのラッパ）
+//  setup(): PID制御のパラメータ変更
+//  loop(): PID制御の出力計算
+//  setTimer(): 外部タイミングでの計算（時間判定なし）
+//  setGains(): ゲインだけの変更（今の周期で、出力は跳ばない、予測器はそのまま）
+//  setPredictor(): サーボの遅れの予測とFF（ServoPredictor、むだ時間と速度が0でFF=0なら無効）
+////////////////////////////////////////////////////////////////////////////////
+class ServoPID {
+public:
+  
+  float Setpoint, Input, Output;
+  float Min, Mean, Max;
+  PIDEngine<float,PID_AW_CLAMP,PID_D_MEAS> PID;
+  ServoPredictor PRED;
+  unsigned long SampleTimeUs, lastTime;
+  bool Timer;
+  
+  ServoPID(void) {
+    //
+    Setpoint = 0.0F;
+    Input = 0.0F;
+    Output = 0.0F;
+    //
+    Mean = 1500;
+    Min = 1000 - Mean;
+    Max = 2000 - Mean;
+    //
+    SampleTimeUs = 1000000/50;
+    lastTime = 0;
+    Timer = false;
+    PID.setLimits(Min,Max);
+    PID.setTunings(1.0,0.0,0.0, SampleTimeUs/1000000.0);
+  }
+  
+  // PID setup
+  void setup(float Kp, float Ki, float Kd, int MIN=1000, float MEAN=1500, int MAX=2000, int Hz=50) {
+    Min = MIN - MEAN;
+    Mean = MEAN;
+    Max = MAX - MEAN;
+  
+    SampleTimeUs = (Hz>=50? 1000000/Hz: 1000000/50);
+    PID.setLimits(Min,Max);
+    PID.setTunings(Kp,Ki,Kd, SampleTimeUs/1000000.0);
+    PRED.setRate(1000000/SampleTimeUs);
+  }
+  void setupT(float Kp, float Ti, float Td, int MIN=1000, float MEAN=1500, int MAX=2000, int Hz=50) {
+    if (Ti <= 0.0) Ti = 1.0;
+    float Ki = Kp/Ti;
+    float Kd = Kp*Td;
+    setup(Kp,Ki,Kd, MIN,MEAN,MAX,Hz);
+  }
+  void setupU(float Ku, float Tu, int MIN=1000, float MEAN=1500, int MAX=2000, int Hz=50) {
+    if (Tu <= 0.0) Tu = 1.0;
+    // Ziegler–Nichols method
+    float Ti = 0.50*Tu;
+    float Td = 0.125*Tu;
+    float Kp = 0.60*Ku;
+    float Ki = Kp/Ti;
+    float Kd = Kp*Td;
+    setup(Kp,Ki,Kd, MIN,MEAN,MAX,Hz);
+  }
+  
+  // gains only at the current sample time (bumpless, no reset of the predictor)
+  void setGains(float Kp, float Ki, float Kd) {
+    PID.setTunings(Kp,Ki,Kd, SampleTimeUs/1000000.0);
+  }
+
+  // PID timing by caller (compute every call) or by sample time
+  void setTimer(bool timer) {
+    Timer = timer;
+  }
+
+  // servo dead time [msec], speed [usec/msec], car time constant [msec], model gain (PV/usec), stick feedforward
+  void setPredictor(int deadMs, int slewUs, int tauMs, float gain, float ff) {
+    PRED.setup(deadMs, slewUs, tauMs, gain, ff);
+    PRED.setRate(1000000/SampleTimeUs);
+  }
+  
+  // PID loop
+  float loop(float SP, float PV) {
+    // Compute PID
+    Setpoint = (SP > 0? SP - Mean: 0.0);
+    Input = PV;
+    unsigned long now = micros();
+    if (Timer || now - lastTime >= SampleTimeUs) {
+      if (PRED.isActive()) {
+        // PID sees the servo without lag, the command includes feedforward
+        Output = constrain(PID.compute(Setpoint,PRED.predict(Input)) + PRED.feed(Setpoint),Min,Max);
+        PRED.push(Output);
+      }
+      else Output = PID.compute(Setpoint,Input);
+      lastTime = now;
+    }
+    return SP > 0? Mean + constrain(Output,Min,Max): 0;
+  }
+
+  // debug print
+  void debug(void) {
+    Serial.printf("%.2f %.2f %.2f\n", Setpoint,Input,Output);
+  }
+
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Supervisor{}: 制御周期の監視と停止中の縮退出力（デッドライン超過の検出）
+//  setup(): 監視タイマの起動と入出力の登録（縮退出力に使う）
+//  setMode(): 縮退モード（0:保持、1:入力の素通し、2:中立）
+//  start(): 監視の再開（ライトスリープ等の後）
+//  stop(): 監視の中止（ライトスリープ等の前）
+//  tick(): 制御1周の完了（制御周期[usec]、間隔が1.5周期を越えたら遅れとして記録）
+//  cause(): 長い処理の原因タグの設定（前のタグを返す、記録に残る）
+//  isFallback(): 縮退出力中か
+//  getMissed(): 遅れた周期の累計
+//  getWorst(): 最長の間隔[usec]（report()でリセット）
+//  report(): 記録した遅れの出力（"WDG tag=... usec=..."、loop()から呼ぶ）
+//
+//  Ticker(2msec)で前回の tick() からの経過を見て、LIMIT_US（3周期以上）を越えたら
+//  制御の代わりに縮退出力を書き続ける（次の tick() で制御に戻る）
+//  静的メンバはテンプレートで定義（ツールで複数の翻訳単位から読んでも重複しない）
+////////////////////////////////////////////////////////////////////////////////
+template <int ID = 0>
+class SupervisorT {
+  static const int LIMIT_US = 20000;  // min of stall to fallback (one servo frame)
+  static const int CHECK_MS = 2;
+  static const int LOG_MAX = 8;
+  typedef struct {
+    const char* tag;
+    unsigned long at;   // [msec]
+    long usec;          // interval of tick()
+    int missed;         // ticks missed
+    bool fallback;
+  } Violation;
+
+  static Ticker WDT;
+  static int (*IN)(int);
+  static bool (*OUT)(int, float);
+  static int CH;
+  static int MODE;
+  static int NEUTRAL;
+  static volatile bool ACTIVE;
+  static volatile bool FALLBACK;
+  static volatile unsigned long LAST;
+  static volatile int PERIOD;
+  static const char* volatile CAUSE;
+  static const char* volatile STALL;
+  static int MISSED;
+  static long WORST;
+  static Violation LOG[LOG_MAX];
+  static volatile int HEAD;
+  static volatile int TAIL;
+  static int DROPPED;
+
+  static long limit(void) { return max((long)LIMIT_US, 3L*PERIOD); }
+  static void check(void) {
+    if (!ACTIVE || PERIOD <= 0) return;
+    if ((long)(micros() - LAST) < limit()) return;
+    if (!FALLBACK) {
+      STALL = CAUSE;
+      FALLBACK = true;
+    }
+    if (MODE == 1) OUT(CH, IN(CH));
+    else if (MODE == 2) OUT(CH, NEUTRAL);
+  }
+  static void record(const char* tag, long usec, int missed, bool fallback) {
+    int next = (HEAD + 1) % LOG_MAX;
+    if (next == TAIL) { DROPPED++; return; }
+    Violation* v = &LOG[HEAD];
+    v->tag = (tag? tag: "?");
+    v->at = millis();
+    v->usec = usec;
+    v->missed = missed;
+    v->fallback = fallback;
+    HEAD = next;
+  }
+
+public:
+  static void setup(int (*in)(int), bool (*out)(int, float), int ch = 0) {
+    IN = in;
+    OUT = out;
+    CH = ch;
+    start();
+    WDT.attach_ms(CHECK_MS, &check);
+  }
+  static void setMode(int mode, int neutralUs) {
+    MODE = mode;
+    NEUTRAL = neutralUs;
+  }
+  static void start(void) {
+    LAST = micros();
+    FALLBACK = false;
+    ACTIVE = true;
+  }
+  static void stop(void) {
+    ACTIVE = false;
+  }
+  static void tick(int periodUs) {
+    unsigned long now = micros();
+    long gap = (long)(now - LAST);
+    LAST = now;
+    if (ACTIVE && PERIOD > 0 && gap > PERIOD + PERIOD/2) {
+      int missed = (gap + PERIOD/2)/PERIOD - 1;
+      MISSED += missed;
+      if (gap > WORST) WORST = gap;
+      record((FALLBACK? STALL: CAUSE), gap, missed, FALLBACK);
+    }
+    FALLBACK = false;
+    PERIOD = periodUs;
+  }
+  static const char* cause(const char* tag) {
+    const char* prev = CAUSE;
+    CAUSE = tag;
+    return prev;
+  }
+  static bool isFallback(void) { return FALLBACK; }
+  static int getMissed(void) { return MISSED; }
+  static long getWorst(void) { return WORST; }
+  static void report(Print& out) {
+    while (TAIL != HEAD) {
+      Violation* v = &LOG[TAIL];
+      out.printf("WDG tag=%s usec=%ld missed=%d at=%lu%s\n", v->tag, v->usec, v->missed, v->at, (v->fallback? " fallback": ""));
+      TAIL = (TAIL + 1) % LOG_MAX;
+    }
+    if (DROPPED) {
+      out.printf("WDG dropped=%d\n", DROPPED);
+      DROPPED = 0;
+    }
+    WORST = 0;
+  }
+};
+
+template <int ID> Ticker SupervisorT<ID>::WDT;
+template <int ID> int (*SupervisorT<ID>::IN)(int) = NULL;
+template <int ID> bool (*SupervisorT<ID>::OUT)(int, float) = NULL;
+template <int ID> int SupervisorT<ID>::CH = 0;
+template <int ID> int SupervisorT<ID>::MODE = 1;
+template <int ID> int SupervisorT<ID>::NEUTRAL = 1500;
+template <int ID> volatile bool SupervisorT<ID>::ACTIVE = false;
+template <int ID> volatile bool SupervisorT<ID>::FALLBACK = false;
+template <int ID> volatile unsigned long SupervisorT<ID>::LAST = 0;
+template <int ID> volatile int SupervisorT<ID>::PERIOD = 0;
+template <int ID> const char* volatile SupervisorT<ID>::CAUSE = NULL;
+template <int ID> const char* volatile SupervisorT<ID>::STALL = NULL;
+template <int ID> int SupervisorT<ID>::MISSED = 0;
+template <int ID> long SupervisorT<ID>::WORST = 0;
+template <int ID> typename SupervisorT<ID>::Violation SupervisorT<ID>::LOG[SupervisorT<ID>::LOG_MAX];
+template <int ID> volatile int SupervisorT<ID>::HEAD = 0;
+template <int ID> volatile int SupervisorT<ID>::TAIL = 0;
+template <int ID> int SupervisorT<ID>::DROPPED = 0;
+typedef SupervisorT<> Supervisor;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// PowerManager{}: CPU周波数とアイドル/ライトスリープの管理（電池の持ち）
+//  setup(): 初期化（mode 0:240MHz固定、1:周波数自動、2:自動＋無信号でライトスリープ）
+//  begin(): 制御1回の開始（実行時間の計測）
+//  end(): 制御1回の終了（制御周期に対する余裕の記録）
+//  loop(): 周波数の選択（1秒ごと、余裕がなければ即240MHz、WiFi使用中は240MHz）
+//  idle(): 期限まで待つ（どのmodeでも、タスク通知で早く起きる、待つ間CPUは止まる、1msec未満は戻る）
+//  isLost(): 入力なしが続いているか（ライトスリープの条件）
+//  sleep(): ライトスリープ（入力ピンのHIGHかタイマで復帰）
+//  getMhz(): CPU周波数[MHz]
+//  getLoad(): 制御の負荷[%]（最大実行時間/制御周期）
+//  getMargin(): 期限までの余裕の最小[usec]（制御周期-最大実行時間）
+//  getMilliAmps(): 消費電流の推定[mA]（ESP32データシートの値から）
+////////////////////////////////////////////////////////////////////////////////
+class PowerManager {
+  // 80MHz or more keeps APB at 80MHz (LEDC/UART/I2C/WiFi unchanged)
+  static const int LEVELS = 3;
+  const int MHZ[LEVELS] = {80, 160, 240};
+  // ESP32 modem-sleep current [mA] with CPU waiting or running
+  const float MA_IDLE[LEVELS] = {20.0F, 27.0F, 30.0F};
+  const float MA_BUSY[LEVELS] = {31.0F, 44.0F, 68.0F};
+  const float MA_WIFI = 100.0F;
+  const float MA_SLEEP = 0.8F;
+  // busy/period to keep at a lower clock, and to go 240MHz at once
+  const float HEADROOM = 0.5F;
+  const float PANIC = 0.75F;
+  const unsigned long LOST_MS = 2000;
+
+  int mode;
+  int level;
+  volatile bool panic;
+  unsigned long start;
+  unsigned long window;
+  unsigned long busyUs, sleepUs;
+  int worst, period, margin;
+  float load, mA;
+  int lastMargin;
+  unsigned long lost;
+
+  void setLevel(int lv) {
+    if (lv == level) return;
+    if (setCpuFrequencyMhz(MHZ[lv])) level = lv;
+  }
+  void reset(int mode_) {
+    mode = mode_;
+    level = LEVELS-1;
+    panic = false;
+    start = window = micros();
+    busyUs = sleepUs = 0;
+    worst = period = 0;
+    margin = lastMargin = 0;
+    load = mA = 0.0F;
+    lost = millis();
+  }
+
+public:
+  // no clock change here (global objects are built before the Arduino core)
+  PowerManager() {
+    reset(0);
+  }
+  // back to 240MHz even if a lower clock was left by the last mode
+  void setup(int mode_) {
+    reset(mode_);
+    setCpuFrequencyMhz(MHZ[level]);
+  }
+  void begin(void) {
+    start = micros();
+  }
+  void end(int periodUs) {
+    int exec = micros() - start;
+    busyUs += exec;
+    period = periodUs;
+    if (exec > worst) worst = exec;
+    if (periodUs > 0 && (margin == 0 || periodUs - exec < margin)) margin = periodUs - exec;
+    if (periodUs > 0 && exec > PANIC*periodUs && level < LEVELS-1) panic = true;
+  }
+  void loop(bool wifi) {
+    if (mode == 0 || wifi || panic) {
+      setLevel(LEVELS-1);
+      panic = false;
+    }
+    unsigned long now = micros();
+    unsigned long win = now - window;
+    if (win < 1000000) return;
+    // current estimate of the last window
+    float busy = min(1.0F, float(busyUs)/win);
+    float slept = min(1.0F, float(sleepUs)/win);
+    mA = slept*MA_SLEEP + (1.0F - slept)*(MA_IDLE[level] + (MA_BUSY[level] - MA_IDLE[level])*busy) + (wifi? MA_WIFI: 0.0F);
+    load = period > 0? 100.0F*worst/period: 0.0F;
+    lastMargin = margin;
+    // lowest clock keeping worst case within headroom (up at once, down by one)
+    if (mode > 0 && !wifi && period > 0) {
+      int lv = LEVELS-1;
+      while (lv > 0 && float(worst)*MHZ[level]/MHZ[lv-1] <= HEADROOM*period) lv--;
+      setLevel(lv > level? lv: (lv < level? level-1: level));
+    }
+    window = now;
+    busyUs = sleepUs = 0;
+    worst = margin = 0;
+  }
+  void idle(unsigned long untilUs) {
+    long wait = (long)(untilUs - micros());
+    if (wait < 1000) return;
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait/1000));
+  }
+  bool isLost(bool input, bool wifi) {
+    unsigned long now = millis();
+    if (mode < 2 || input || wifi) lost = now;
+    return now - lost > LOST_MS;
+  }
+  void sleep(int pin, int msec = 500) {
+    gpio_wakeup_enable((gpio_num_t)pin, GPIO_INTR_HIGH_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+    esp_sleep_enable_timer_wakeup(msec*1000ULL);
+    unsigned long t0 = micros();
+    esp_light_sleep_start();
+    sleepUs += micros() - t0;
+    gpio_wakeup_disable((gpio_num_t)pin);
+  }
+  int getMhz(void) { return MHZ[level]; }
+  float getLoad(void) { return load; }
+  int getMargin(void) { return lastMargin; }
+  float getMilliAmps(void) { return mA; }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// ResourceMonitor{}: ヒープ、タスクのスタック、コアごとのCPU負荷の監視
+//  CPU負荷はティック割り込み（1msec）ごとに実行中がアイドルタスクかを数える（標本化）
+//  ヒープとスタックは sample() で読む（loop()から1秒ごと、制御の経路では呼ばない）
+//  DRIFTは基準からの空きヒープの減少（定常運転では0のはず、増え続けたら漏れか断片化）
+//  setup(): ティックフックの登録と呼んだタスク（loop）の登録
+//  watch(): 監視するタスクの登録（ハンドル変数のアドレス、NULLのままなら未起動）
+//  sample(): ヒープ、スタックの余裕、CPU負荷の更新（前回の sample() からの窓）
+//  rebase(): DRIFTの基準を今の空きヒープに（WiFiの起動や停止の後）
+//  getStack(): 登録したタスクのスタックの余裕の最小[bytes]
+//  printJSON(): 最新の値をJSONで（/api/sys、1回のprintfは64文字未満でmallocなし）
+//  静的メンバはテンプレートで定義（ツールで複数の翻訳単位から読んでも重複しない）
+////////////////////////////////////////////////////////////////////////////////
+template <int ID = 0>
+class ResourceMonitorT {
+  static const int TASKS = 8;
+  static const char* NAME[TASKS];
+  static TaskHandle_t const* TASK[TASKS];
+  static TaskHandle_t FIXED[TASKS];   // handles registered by value
+  static int STACK[TASKS];            // free stack [bytes] (-1 not running)
+  static int COUNT;
+  static volatile uint32_t TICKS[2], IDLE[2];
+  static uint32_t lastTicks[2], lastIdle[2];
+
+  static inline void tick(int cpu) {
+    TICKS[cpu]++;
+    if (xTaskGetCurrentTaskHandleForCPU(cpu) == xTaskGetIdleTaskHandleForCPU(cpu)) IDLE[cpu]++;
+  }
+  static void IRAM_ATTR tick0(void) { tick(0); }
+  static void IRAM_ATTR tick1(void) { tick(1); }
+
+public:
+  static uint32_t heapFree, heapMin, heapBlock, heapBase;
+  static int load[2];   // [%]
+
+  static void setup(void) {
+    esp_register_freertos_tick_hook_for_cpu(tick0, 0);
+    if (portNUM_PROCESSORS > 1) esp_register_freertos_tick_hook_for_cpu(tick1, 1);
+    watch("loop", xTaskGetCurrentTaskHandle());
+    heapBase = 0;
+  }
+  static void watch(const char* name, TaskHandle_t const* task) {
+    if (COUNT >= TASKS) return;
+    NAME[COUNT] = name;
+    TASK[COUNT] = task;
+    STACK[COUNT] = -1;
+    COUNT++;
+  }
+  static void watch(const char* name, TaskHandle_t task) {
+    if (COUNT >= TASKS) return;
+    FIXED[COUNT] = task;
+    watch(name, &FIXED[COUNT]);
+  }
+  static void sample(void) {
+    heapFree = ESP.getFreeHeap();
+    heapMin = ESP.getMinFreeHeap();
+    heapBlock = ESP.getMaxAllocHeap();
+    if (heapBase == 0) heapBase = heapFree;
+    for (int n=0; n<COUNT; n++) {
+      TaskHandle_t task = *TASK[n];
+      STACK[n] = (task? (int)uxTaskGetStackHighWaterMark(task): -1);
+    }
+    for (int c=0; c<2; c++) {
+      uint32_t ticks = TICKS[c], idle = IDLE[c];
+      uint32_t dt = ticks - lastTicks[c], di = idle - lastIdle[c];
+      load[c] = (dt > 0? 100 - (int)(100*di/dt): 0);
+      lastTicks[c] = ticks;
+      lastIdle[c] = idle;
+    }
+  }
+  static void rebase(void) { heapBase = ESP.getFreeHeap(); }
+  static int getDrift(void) { return (heapBase? (int)heapBase - (int)heapFree: 0); }
+  static int getStack(void) {
+    int least = -1;
+    for (int n=0; n<COUNT; n++) {
+      if (STACK[n] >= 0 && (least < 0 || STACK[n] < least)) least = STACK[n];
+    }
+    return least;
+  }
+  static size_t printJSON(Print& out) {
+    size_t n = out.printf("{\"heap\":%u,\"heap_min\":%u,", (unsigned)heapFree, (unsigned)heapMin);
+    n += out.printf("\"block\":%u,\"drift\":%d,", (unsigned)heapBlock, getDrift());
+    n += out.printf("\"load\":[%d,%d],\"stack\":{", load[0], load[1]);
+    for (int k=0; k<COUNT; k++) n += out.printf("%s\"%s\":%d", (k? ",": ""), NAME[k], STACK[k]);
+    n += out.print("}}");
+    return n;
+  }
+};
+
+template <int ID> const char* ResourceMonitorT<ID>::NAME[ResourceMonitorT<ID>::TASKS];
+template <int ID> TaskHandle_t const* ResourceMonitorT<ID>::TASK[ResourceMonitorT<ID>::TASKS];
+template <int ID> TaskHandle_t ResourceMonitorT<ID>::FIXED[ResourceMonitorT<ID>::TASKS];
+template <int ID> int ResourceMonitorT<ID>::STACK[ResourceMonitorT<ID>::TASKS];
+template <int ID> int ResourceMonitorT<ID>::COUNT = 0;
+template <int ID> volatile uint32_t ResourceMonitorT<ID>::TICKS[2] = {0,0};
+template <int ID> volatile uint32_t ResourceMonitorT<ID>::IDLE[2] = {0,0};
+template <int ID> uint32_t ResourceMonitorT<ID>::lastTicks[2] = {0,0};
+template <int ID> uint32_t ResourceMonitorT<ID>::lastIdle[2] = {0,0};
+template <int ID> uint32_t ResourceMonitorT<ID>::heapFree = 0;
+template <int ID> uint32_t ResourceMonitorT<ID>::heapMin = 0;
+template <int ID> uint32_t ResourceMonitorT<ID>::heapBlock = 0;
+template <int ID> uint32_t ResourceMonitorT<ID>::heapBase = 0;
+template <int ID> int ResourceMonitorT<ID>::load[2] = {0,0};
+typedef ResourceMonitorT<> ResourceMonitor;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// FlightRecorder<>: 一定間隔の標本を常に記録し、きっかけの前後を保存する（フライトレコーダ）
+//  記録は2面のリング（ヒープ不使用）、標本ごとに1回コピーするだけ（put()）
+//  標本は時刻で間引く（setup() の Hz ごとに1つ、put() を呼ぶ回数によらない、間のきっかけは次の標本に）
+//  窓も時刻で決める（きっかけの前 preMs と後 postMs、Hz で N 標本に収まるよう前を縮める）
+//  きっかけから postMs の後に面を切り替え（記録は止めない、前の面が保存した記録）
+//  未読の記録があれば自動のきっかけは無視（最初の1回を残す）、ボタンは上書き
+//  きっかけ: ヨーレート、横滑り角、カウンタステア（ヨーレートの半分以上でヨーと逆向きのスティック）、
+//   締切の遅れ、受信の途絶、ボタン（REC_*、保存した記録の flags の上位8ビット）
+//  setup(): 標本の頻度[Hz]、きっかけの前と後の長さ[msec]
+//  setLimits(): ヨーレート[deg/sec]、横滑り角[deg]、カウンタステア[usec]（0:なし）、中立[usec]、逆転
+//  put(): 標本の記録（制御1回ごとに呼ぶ、値によるきっかけの判定もここで）
+//  trigger(): きっかけ（ほかの処理から、次の標本で記録を始める）
+//  freeze(): その場で保存（後の長さなし、制御を止めた後にボタンで）
+//  isUnread()/getCount(): 未読の記録があるか、保存した回数
+//  printCSV(): 保存した記録をCSVで（時刻はきっかけからの[usec]、読むと既読に、1回のprintfは64文字未満）
+////////////////////////////////////////////////////////////////////////////////
+#define REC_YAW       0x01  // yaw rate over the limit
+#define REC_SLIP      0x02  // drift angle over the limit
+#define REC_COUNTER   0x04  // counter steer
+#define REC_DEADLINE  0x08  // missed control step
+#define REC_DROPOUT   0x10  // receiver link lost
+#define REC_BUTTON    0x20  // button
+
+typedef struct {
+  uint32_t time;    // clock [usec]
+  int16_t ch1, ch3; // input pulse [usec]
+  int16_t gyro[3];  // raw IMU [0.1 deg/sec]
+  int16_t accl[3];  // raw IMU [mG]
+  int16_t rate;     // estimated yaw rate [0.1 deg/sec]
+  int16_t slip;     // estimated drift angle [0.01 deg]
+  int16_t roll, pitch; // [0.01 deg]
+  int16_t p, i, d;  // PID terms [0.1 usec]
+  int16_t out;      // output pulse [usec]
+  uint16_t duty;    // LEDC duty
+  uint16_t flags;   // caller flags (lower 8 bits), REC_* at the trigger (upper 8 bits)
+} FlightSample;
+
+template <int N = 512>
+struct FlightRecorder {
+  FlightSample bank[2][N];  // N is a power of 2
+  int live, head, count;    // bank being written
+  long interval;            // between samples [usec]
+  long preUs, postUs;       // window around the trigger [usec]
+  uint32_t next;            // time of the next sample
+  bool capturing;           // after the trigger, until postUs
+  volatile uint16_t pending;
+  uint16_t cause;
+  uint32_t at;
+  int yawLim, slipLim, steerLim, mid, sign;
+  // saved capture (the other bank)
+  int savedHead, savedCount, captures;
+  uint16_t savedCause;
+  uint32_t savedAt;
+  volatile bool unread, reading;
+
+  FlightRecorder() {
+    live = head = count = 0;
+    next = 0;
+    capturing = false;
+    pending = cause = savedCause = 0;
+    at = savedAt = 0;
+    savedHead = savedCount = captures = 0;
+    unread = reading = false;
+    setLimits(0,0,0,1500,false);
+    setup(50,500,250);
+  }
+  void setup(int hz, int preMs, int postMs) {
+    if (hz < 1) hz = 1;
+    interval = 1000000L/hz;
+    // pre + post at hz within the ring (one slot to spare)
+    long maxMs = (N - 2)*1000L/hz;
+    if (postMs > maxMs/2) postMs = maxMs/2;
+    if (preMs + postMs > maxMs) preMs = maxMs - postMs;
+    preUs = 1000L*preMs;
+    postUs = 1000L*postMs;
+  }
+  void setLimits(int yawDps, int slipDeg, int steerUs, int midUs, bool rev) {
+    yawLim = 10*yawDps;
+    slipLim = 100*slipDeg;
+    steerLim = steerUs;
+    mid = midUs;
+    sign = rev? -1: 1;
+  }
+  inline uint16_t check(const FlightSample& s) const {
+    uint16_t c = 0;
+    int rate = s.rate;
+    if (yawLim > 0 && abs(rate) > yawLim) c |= REC_YAW;
+    if (slipLim > 0 && abs(s.slip) > slipLim) c |= REC_SLIP;
+    if (steerLim > 0 && s.ch1 > 0 && 2*abs(rate) > yawLim) {
+      int st = s.ch1 - mid;
+      if (abs(st) > steerLim && st*sign*rate < 0) c |= REC_COUNTER;
+    }
+    return c;
+  }
+  inline void put(const FlightSample& s) {
+    uint16_t c = check(s);
+    long early = (int32_t)(next - s.time);
+    if (early > 0) {
+      // between samples: the trigger waits for the next one
+      if (c) pending |= c;
+      return;
+    }
+    next = (early > -interval)? next + interval: s.time + interval;
+    FlightSample* p = &bank[live][head];
+    memcpy(p, &s, sizeof(FlightSample));
+    head = (head + 1) & (N-1);
+    if (count < N) count++;
+    if (capturing) {
+      if ((int32_t)(s.time - at) >= postUs) save();
+      return;
+    }
+    c |= pending;
+    pending = 0;
+    if (c == 0 || (unread && !(c & REC_BUTTON))) return;
+    p->flags |= (c << 8);
+    cause = c;
+    at = s.time;
+    capturing = true;
+    if (postUs == 0) save();
+  }
+  inline void trigger(uint16_t c) { pending |= c; }
+  void freeze(uint16_t c) {
+    if (count == 0) return;
+    FlightSample* p = &bank[live][(head - 1) & (N-1)];
+    p->flags |= (c << 8);
+    if (!capturing) {
+      cause = c;
+      at = p->time;
+    } else cause |= c;
+    save();
+  }
+  void save(void) {
+    capturing = false;
+    if (reading) return;
+    savedHead = head;
+    savedCount = count;
+    savedCause = cause;
+    savedAt = at;
+    live ^= 1;
+    head = count = 0;
+    captures++;
+    unread = true;
+  }
+  bool isUnread(void) const { return unread; }
+  int getCount(void) const { return captures; }
+  size_t printCSV(Print& out) {
+    if (captures == 0) return out.print("# no capture\n");
+    reading = true;
+    size_t len = out.printf("# cause=0x%02x captures=%d\n", savedCause, captures);
+    len += out.print("time,ch1,ch3,gx,gy,gz,ax,ay,az,rate,slip,roll,pitch,p,i,d,out,duty,flags\n");
+    const FlightSample* b = bank[live ^ 1];
+    for (int k=0; k<savedCount; k++) {
+      const FlightSample* s = &b[(savedHead - savedCount + k) & (N-1)];
+      long t = (long)(int32_t)(s->time - savedAt);
+      if (t < -preUs) continue;
+      const int16_t v[] = {s->ch1, s->ch3, s->gyro[0], s->gyro[1], s->gyro[2], s->accl[0], s->accl[1], s->accl[2],
+        s->rate, s->slip, s->roll, s->pitch, s->p, s->i, s->d, s->out};
+      len += out.print(t);
+      for (int n=0; n<16; n++) {
+        len += out.write(',');
+        len += out.print(v[n]);
+      }
+      len += out.write(',');
+      len += out.print(s->duty);
+      len += out.write(',');
+      len += out.print(s->flags);
+      len += out.write('\n');
+    }
+    unread = false;
+    reading = false;
+    return len;
+  }
+};
+
+#endif
@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+#ifndef PIDENGINE_HPP
+#define PIDENGINE_HPP
+
+#include <stdint.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+// class Fixed<F>{}: 固定小数点数（int32_t、小数部Fビット）
+//  Q15 = Fixed<15>: 範囲±65536、分解能1/32768
+//  Q16 = Fixed<16>: 範囲±32768、分解能1/65536
+////////////////////////////////////////////////////////////////////////////////
+template <int F>
+class Fixed {
+  int32_t v;
+public:
+  static Fixed raw(int32_t r) { Fixed x; x.v = r; return x; }
+  Fixed() : v(0) {}
+  Fixed(int i) : v((int32_t)i << F) {}
+  Fixed(float f) : v((int32_t)(f * (1L << F) + (f >= 0? 0.5F: -0.5F))) {}
+  operator float() const { return (float)v / (1L << F); }
+  int32_t getRaw() const { return v; }
+
+  Fixed operator+(Fixed b) const { return raw(v + b.v); }
+  Fixed operator-(Fixed b) const { return raw(v - b.v); }
+  Fixed operator-() const { return raw(-v); }
+  Fixed operator*(Fixed b) const { return raw((int32_t)(((int64_t)v * b.v) >> F)); }
+  Fixed operator/(Fixed b) const { return raw((int32_t)(((int64_t)v << F) / b.v)); }
+  Fixed& operator+=(Fixed b) { v += b.v; return *this; }
+  Fixed& operator-=(Fixed b) { v -= b.v; return *this; }
+  bool operator<(Fixed b) const { return v < b.v; }
+  bool operator>(Fixed b) const { return v > b.v; }
+  bool operator<=(Fixed b) const { return v <= b.v; }
+  bool operator>=(Fixed b) const { return v >= b.v; }
+  bool operator==(Fixed b) const { return v == b.v; }
+  bool operator!=(Fixed b) const { return v != b.v; }
+};
+typedef Fixed<15> Q15;
+typedef Fixed<16> Q16;
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// class PIDEngine<T,AW,DM>{}: PID制御の計算エンジン（ヘッダのみ、ヒープ不使用）
+//  T: 数値型（float, Q15, Q16）
+//  AW: 積分のワインドアップ対策（PID_AW_OFF, PID_AW_CLAMP, PID_AW_COND）
+//  DM: 微分の対象（PID_D_ERROR: 偏差, PID_D_MEAS: 観測値）
+//  u = Kp*(b*r - y) + Ki*INT(r - y) + Kd*LPF(DOT(-y or r - y))
+//  setLimits(): 出力範囲
+//  setTunings(): ゲインと周期の変更（積分を補正して出力を連続に保つ）
+//  reset(): 出力uから再開（手動から自動への切替など）
+//  compute(): 1周期分の計算（時間判定なし、呼び出し側が周期を守る）
+//  getP()/getI()/getD(): 各項の値
+////////////////////////////////////////////////////////////////////////////////
+enum { PID_AW_OFF = 0, PID_AW_CLAMP, PID_AW_COND };
+enum { PID_D_ERROR = 0, PID_D_MEAS };
+
+template <class T = float, int AW = PID_AW_CLAMP, int DM = PID_D_MEAS>
+class PIDEngine {
+  // gains in discrete form: ki = Ki*dt, kd = Kd/dt
+  T kp, ki, kd;
+  T beta;  // setpoint weight of P
+  T alpha; // D filter: d += alpha*(raw - d)
+  T outMin, outMax;
+  // states
+  T iSum, dSum;
+  T lastSp, lastPv, lastErr;
+  T pTerm, dTerm;
+
+  static inline T clamp(T x, T lo, T hi) { return x < lo? lo: (x > hi? hi: x); }
+
+public:
+  PIDEngine() {
+    kp = T(1.0F); ki = T(0.0F); kd = T(0.0F);
+    beta = T(1.0F); alpha = T(1.0F);
+    outMin = T(-1000.0F); outMax = T(1000.0F);
+    iSum = dSum = lastSp = lastPv = lastErr = pTerm = dTerm = T(0.0F);
+  }
+
+  void setLimits(float min, float max) {
+    outMin = T(min);
+    outMax = T(max);
+    iSum = clamp(iSum, outMin, outMax);
+  }
+
+  // Kp, Ki [1/sec], Kd [sec], dt [sec], Tf: D filter time constant [sec], b: setpoint weight
+  void setTunings(float Kp, float Ki, float Kd, float dt, float Tf = 0.0F, float b = 1.0F) {
+    T pOld = kp * (beta * lastSp - lastPv);
+    kp = T(Kp);
+    ki = T(Ki * dt);
+    kd = T(dt > 0.0F? Kd / dt: 0.0F);
+    beta = T(b);
+    alpha = T(dt > 0.0F? dt / (Tf + dt): 1.0F);
+    // bumpless: move the change of P into I
+    T pNew = kp * (beta * lastSp - lastPv);
+    if (AW != PID_AW_OFF) iSum = clamp(iSum + pOld - pNew, outMin, outMax);
+    else iSum += pOld - pNew;
+  }
+
+  void reset(T pv, T out, T sp = T(0.0F)) {
+    lastSp = sp;
+    lastPv = pv;
+    lastErr = sp - pv;
+    dSum = T(0.0F);
+    iSum = clamp(out - kp * (beta * sp - pv), outMin, outMax);
+  }
+
+  inline T compute(T sp, T pv) {
+    T err = sp - pv;
+    // P with setpoint weight
+    pTerm = kp * (beta * sp - pv);
+    // D on error or on measurement, filtered
+    T raw = (DM == PID_D_ERROR)? kd * (err - lastErr): -(kd * (pv - lastPv));
+    dSum += alpha * (raw - dSum);
+    dTerm = dSum;
+    // I with anti-windup
+    T inc = ki * err;
+    if (AW == PID_AW_COND) {
+      // integrate only while not pushing further into saturation
+      T out = pTerm + iSum + dTerm;
+      if (!((out >= outMax && inc > T(0.0F)) || (out <= outMin && inc < T(0.0F)))) iSum += inc;
+    } else {
+      iSum += inc;
+      if (AW == PID_AW_CLAMP) iSum = clamp(iSum, outMin, outMax);
+    }
+    lastSp = sp;
+    lastPv = pv;
+    lastErr = err;
+    return clamp(pTerm + iSum + dTerm, outMin, outMax);
+  }
+
+  float getP(void) const { return (float)pTerm; }
+  float getI(void) const { return (float)iSum; }
+  float getD(void) const { return (float)dTerm; }
+};
+
+#endif
@@ -0,0 +1,37 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// GyroM5Bench: ESP32(M5Atom)上でのマイクロベンチマーク
+//  tools/bench_atom.hpp を esp_cpu_get_ccount() のサイクル数で計測してJSONをシリアルに出す
+//  結果は "BENCH-JSON" の行から保存して tools/bench の -i で比較する
+//  （GY/GRVのピンには何も繋がない、BENCH_OUT_PIN にはサーボ信号が出る）
+//
+// build (libraries のコアと、GyroM5Atom と tools をインクルードパスに追加):
+//  arduino-cli compile -b esp32:esp32:m5stack-atom --libraries $PWD/libraries \
+//   --build-property "compiler.cpp.extra_flags=-I$PWD/GyroM5Atom -I$PWD/tools" -u -p PORT tools/GyroM5Bench
+//  arduino-cli monitor -p PORT -c baudrate=115200 > esp32.log
+//  cd tools && ./bench -i ../esp32.log -b esp32-base.json
+////////////////////////////////////////////////////////////////////////////////
+
+#include <M5Atom.h>
+#include "GyroM5Atom.hpp"
+#include "bench.hpp"
+#include "bench_atom.hpp"
+
+static char JSON[4096];
+
+void setup() {
+  M5.begin(true, false, true);
+  delay(2000);
+  DEBUG.printf("BENCH: cpu=%dMHz\n", getCpuFrequencyMhz());
+  benchRun(NULL, 50.0, 5);
+  benchJSON(JSON, sizeof(JSON), "esp32", getCpuFrequencyMhz());
+  DEBUG.println("BENCH-JSON");
+  DEBUG.print(JSON);
+}
+
+void loop() {
+  delay(1000);
+}
@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// bench: 制御経路のマイクロベンチマーク（ホスト実行と結果の比較）
+//  bench_atom.hpp: PulsePort, ServoPID, M5StackAHRS, CONFIG, SERVER, TelemetryTx, VibrationFFT
+//  bench_stick.cpp: data_put/data_draw/data_MAE, getYawRate/getHorizontalG
+//  ESP32での実行は GyroM5Bench/GyroM5Bench.ino（結果のJSONを -i で読んで比較）
+//
+//  比較: 基準の結果(-b)に対する増加率[%]が許容値を越えたら NG（終了コード2）
+//   許容値は bench_thresholds.json の名前ごとの値、無ければ "default"
+//   両方に cycles があれば cycles で、無ければ real_time[nsec] で比べる
+//
+// build:
+//  g++ -O2 -std=c++17 -fno-strict-aliasing -Ihost -I../libraries/GyroM5Core/src -I../GyroM5Atom -I../GyroM5Stick -o bench bench.cpp bench_stick.cpp
+// usage:
+//  ./bench [-f FILTER] [-t MIN_MS] [-n REPS] [-o OUT.json] [-b BASE.json] [-T THRESHOLDS.json]
+//  ./bench -i ESP32.json -b BASE.json   (ESP32のシリアル出力を保存したものを比較)
+////////////////////////////////////////////////////////////////////////////////
+#include "Arduino.h"
+#include "M5Atom.h"
+#include "GyroM5Atom.hpp"
+#include "bench.hpp"
+#include "bench_atom.hpp"
+#include <string>
+
+static bool readFile(const char* path, std::string& text) {
+  FILE* fp = fopen(path, "rb");
+  if (!fp) return false;
+  char buf[4096];
+  size_t n;
+  text.clear();
+  while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) text.append(buf, n);
+  fclose(fp);
+  return true;
+}
+
+// allowed increase [%] by name, {"default": 10, "NAME": 25, ...}
+static double threshold(const std::string& text, const char* name, double def) {
+  std::string key = std::string("\"") + name + "\"";
+  size_t p = text.find(key);
+  if (p == std::string::npos) p = text.find("\"default\"");
+  if (p == std::string::npos) return def;
+  p = text.find(':', p);
+  return p == std::string::npos? def: atof(text.c_str() + p + 1);
+}
+
+static int compare(const BenchResult* R, int n, const BenchResult* B, int nb, const std::string& limits) {
+  int ng = 0;
+  printf("%-34s %12s %12s %8s %6s\n", "name", "now", "base", "diff[%]", "limit");
+  for (int i=0; i<n; i++) {
+    const BenchResult* b = NULL;
+    for (int j=0; j<nb; j++) if (strcmp(R[i].name, B[j].name) == 0) b = &B[j];
+    if (!b) {
+      printf("%-34s %12.2f %12s\n", R[i].name, R[i].cycles > 0? R[i].cycles: R[i].ns, "-");
+      continue;
+    }
+    bool cyc = R[i].cycles > 0 && b->cycles > 0;
+    double now = cyc? R[i].cycles: R[i].ns;
+    double base = cyc? b->cycles: b->ns;
+    double diff = base > 0? 100.0*(now - base)/base: 0.0;
+    double lim = threshold(limits, R[i].name, 10.0);
+    bool ok = diff <= lim;
+    if (!ok) ng++;
+    printf("%-34s %12.2f %12.2f %8.1f %6.0f %s%s\n", R[i].name, now, base, diff, lim, cyc? "cyc ": "ns  ", ok? "ok": "NG");
+  }
+  return ng;
+}
+
+static void usage(void) {
+  fprintf(stderr, "usage: bench [-f FILTER] [-t MIN_MS] [-n REPS] [-o OUT.json] [-b BASE.json] [-T THRESHOLDS.json] [-i RESULT.json]\n");
+  exit(1);
+}
+
+int main(int argc, char** argv) {
+  const char* filter = NULL;
+  const char* out = NULL;
+  const char* base = NULL;
+  const char* input = NULL;
+  const char* limits = "bench_thresholds.json";
+  double minMs = 200.0;
+  int reps = 5;
+  for (int i=1; i<argc; i++) {
+    if (argv[i][0] != '-' || i+1 >= argc) usage();
+    switch (argv[i][1]) {
+      case 'f': filter = argv[++i]; break;
+      case 't': minMs = atof(argv[++i]); break;
+      case 'n': reps = atoi(argv[++i]); break;
+      case 'o': out = argv[++i]; break;
+      case 'b': base = argv[++i]; break;
+      case 'T': limits = argv[++i]; break;
+      case 'i': input = argv[++i]; break;
+      default: usage();
+    }
+  }
+
+  static BenchResult R[BENCH_MAX], B[BENCH_MAX];
+  static char json[8192];
+  int n = 0;
+  if (input) {
+    std::string text;
+    if (!readFile(input, text)) { fprintf(stderr, "bench: cannot read %s\n", input); return 1; }
+    n = benchLoad(text.c_str(), R, BENCH_MAX);
+  }
+  else {
+    n = benchRun(filter, minMs, reps);
+    memcpy(R, benchList().result, n*sizeof(BenchResult));
+    benchJSON(json, sizeof(json), "host", 0);
+    if (out) {
+      FILE* fp = (strcmp(out, "-") == 0? stdout: fopen(out, "w"));
+      if (!fp) { fprintf(stderr, "bench: cannot write %s\n", out); return 1; }
+      fputs(json, fp);
+      if (fp != stdout) fclose(fp);
+    }
+  }
+
+  if (!base) {
+    printf("%-34s %12s %12s %12s\n", "name", "iterations", "real_time", "cycles");
+    for (int i=0; i<n; i++) printf("%-34s %12u %12.2f %12.1f\n", R[i].name, (unsigned)R[i].iterations, R[i].ns, R[i].cycles);
+    return 0;
+  }
+  std::string text, lim;
+  if (!readFile(base, text)) { fprintf(stderr, "bench: cannot read %s\n", base); return 1; }
+  readFile(limits, lim);
+  int nb = benchLoad(text.c_str(), B, BENCH_MAX);
+  return compare(R, n, B, nb, lim) > 0? 2: 0;
+}
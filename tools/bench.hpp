@@ -0,0 +1,187 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// bench.hpp: Google Benchmark 風の小さなマイクロベンチマーク（ホストとESP32で共通）
+//  BENCH(name): ベンチマーク関数の登録（本体は while (st.run()) {...} で回す）
+//  benchKeep(): 計算結果を最適化で消されないようにする
+//  benchRun(): 登録された全ベンチマークの実行（filter は名前の部分一致）
+//  benchJSON(): 結果のJSON出力（Google Benchmark の --benchmark_format=json に準じる）
+//  benchLoad(): JSON結果の読み込み（基準値との比較用）
+//
+//  計時: ホストは steady_clock[nsec]、ESP32は esp_cpu_get_ccount()[cycles]
+//  反復回数は1回の計測が minMs を越えるまで10倍ずつ増やし、reps 回の中央値を採る
+////////////////////////////////////////////////////////////////////////////////
+#ifndef GYROM5_BENCH_HPP
+#define GYROM5_BENCH_HPP
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifdef ESP_PLATFORM
+#if __has_include(<esp_cpu.h>)
+#include <esp_cpu.h>
+#else
+#include <soc/cpu.h>
+#endif
+#else
+#include <chrono>
+#endif
+
+
+// clock: ticks are cycles on ESP32, nsec on host
+#ifdef ESP_PLATFORM
+typedef uint32_t BenchTick;
+static inline BenchTick benchTick(void) { return esp_cpu_get_ccount(); }
+static inline double benchTickNs(void) { return 1000.0/getCpuFrequencyMhz(); }
+#else
+typedef uint64_t BenchTick;
+static inline BenchTick benchTick(void) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+static inline double benchTickNs(void) { return 1.0; }
+#endif
+
+// keep value alive (like benchmark::DoNotOptimize)
+template <class T>
+static inline void benchKeep(const T& v) { asm volatile("" : : "g"(&v) : "memory"); }
+
+
+class BenchState {
+public:
+  const uint32_t iterations;
+  BenchState(uint32_t n) : iterations(n), count(0), start(0), stop(0) {}
+  bool run(void) {
+    if (count == 0) start = benchTick();
+    if (count++ < iterations) return true;
+    stop = benchTick();
+    return false;
+  }
+  BenchTick ticks(void) const { return stop - start; }
+private:
+  uint32_t count;
+  BenchTick start, stop;
+};
+
+typedef void (*BenchFunc)(BenchState&);
+
+struct BenchResult {
+  char name[40];
+  uint32_t iterations;
+  double ns;      // median per iteration
+  double ns_min;  // best per iteration
+  double cycles;  // median per iteration (ESP32 only, 0 on host)
+};
+
+static const int BENCH_MAX = 32;
+struct BenchList {
+  int count;
+  const char* name[BENCH_MAX];
+  BenchFunc func[BENCH_MAX];
+  BenchResult result[BENCH_MAX];
+  int results;
+};
+inline BenchList& benchList(void) { static BenchList list; return list; }
+
+struct BenchReg {
+  BenchReg(const char* name, BenchFunc func) {
+    BenchList& L = benchList();
+    if (L.count < BENCH_MAX) {
+      L.name[L.count] = name;
+      L.func[L.count] = func;
+      L.count++;
+    }
+  }
+};
+#define BENCH(name) \
+  static void bench_##name(BenchState& st); \
+  static BenchReg benchReg_##name(#name, bench_##name); \
+  static void bench_##name(BenchState& st)
+
+
+static inline int benchCmp(const void* a, const void* b) {
+  double x = *(const double*)a, y = *(const double*)b;
+  return x < y? -1: (x > y? 1: 0);
+}
+
+// run one benchmark: grow iterations until minMs, then median of reps
+static inline void benchOne(const char* name, BenchFunc func, double minMs, int reps, BenchResult& R) {
+  const double minTicks = minMs*1e6/benchTickNs();
+  uint32_t n = 1;
+  for (;;) {
+    BenchState st(n);
+    func(st);
+    if (st.ticks() >= minTicks || n >= 100000000) break;
+    n = (st.ticks() > minTicks/100? (uint32_t)(n*minTicks/st.ticks()) + 1: n*10);
+  }
+  double t[16];
+  if (reps > 16) reps = 16;
+  if (reps < 1) reps = 1;
+  for (int r=0; r<reps; r++) {
+    BenchState st(n);
+    func(st);
+    t[r] = (double)st.ticks()/n;
+  }
+  qsort(t, reps, sizeof(double), benchCmp);
+  snprintf(R.name, sizeof(R.name), "%s", name);
+  R.iterations = n;
+  R.ns = t[reps/2]*benchTickNs();
+  R.ns_min = t[0]*benchTickNs();
+#ifdef ESP_PLATFORM
+  R.cycles = t[reps/2];
+#else
+  R.cycles = 0.0;
+#endif
+}
+
+// run all benchmarks matching filter (NULL for all)
+static inline int benchRun(const char* filter, double minMs, int reps) {
+  BenchList& L = benchList();
+  L.results = 0;
+  for (int i=0; i<L.count; i++) {
+    if (filter && !strstr(L.name[i], filter)) continue;
+    benchOne(L.name[i], L.func[i], minMs, reps, L.result[L.results++]);
+  }
+  return L.results;
+}
+
+// JSON text of results into buf (returns length)
+static inline int benchJSON(char* buf, int size, const char* host, int mhz) {
+  BenchList& L = benchList();
+  int n = snprintf(buf, size, "{\n \"context\": {\"host\": \"%s\", \"mhz\": %d, \"time_unit\": \"ns\"},\n \"benchmarks\": [\n", host, mhz);
+  for (int i=0; i<L.results && n<size; i++) {
+    const BenchResult& R = L.result[i];
+    n += snprintf(buf+n, size-n, "  {\"name\": \"%s\", \"iterations\": %u, \"real_time\": %.2f, \"min_time\": %.2f, \"cycles\": %.1f}%s\n",
+      R.name, (unsigned)R.iterations, R.ns, R.ns_min, R.cycles, i<L.results-1? ",": "");
+  }
+  if (n < size) n += snprintf(buf+n, size-n, " ]\n}\n");
+  return n < size? n: size-1;
+}
+
+// read results from JSON text made by benchJSON() (returns count)
+static inline int benchLoad(const char* text, BenchResult* R, int max) {
+  int n = 0;
+  const char* p = strstr(text, "\"benchmarks\"");
+  while (p && n < max && (p = strstr(p, "{\"name\": \"")) != NULL) {
+    p += 10;
+    const char* q = strchr(p, '"');
+    if (!q) break;
+    BenchResult& r = R[n];
+    memset(&r, 0, sizeof(r));
+    snprintf(r.name, sizeof(r.name), "%.*s", (int)(q-p), p);
+    const char* e = strchr(q, '}');
+    const char* f;
+    if ((f = strstr(q, "\"iterations\": ")) && f < e) r.iterations = strtoul(f+14, NULL, 10);
+    if ((f = strstr(q, "\"real_time\": ")) && f < e) r.ns = strtod(f+13, NULL);
+    if ((f = strstr(q, "\"min_time\": ")) && f < e) r.ns_min = strtod(f+12, NULL);
+    if ((f = strstr(q, "\"cycles\": ")) && f < e) r.cycles = strtod(f+10, NULL);
+    n++;
+    p = e;
+  }
+  return n;
+}
+
+#endif
@@ -0,0 +1,291 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// bench_atom.hpp: GyroM5Atom.hpp の制御経路のベンチマーク（ホストとESP32で共通）
+//  GyroM5Atom.hpp と bench.hpp の後にインクルードする
+//  PulsePort::ISR は割り込みを使わずに直接呼ぶ（毎回エッジの分岐を通す）
+//  OutputShaper::duty はエキスポ、サブトリム、速度制限の全部が効いた状態
+//  FlightRecorder::put はきっかけの判定込み（未読の記録が残るので2回目からは保存しない）
+//  SERVER::handleJson は応答の文字列化まで（ホストは送信しない）
+//  CONFIG::printJSON は数えるだけの Print に出力（送信の手前まで）
+//  TelemetryTx::put は制御側の1回分（送信はしない）、TelemetryPacker は1パケット分
+//  VibrationFFT::loop はノッチ2段が効いた状態、analyze は毎回1窓分を解析
+////////////////////////////////////////////////////////////////////////////////
+#ifndef GYROM5_BENCH_ATOM_HPP
+#define GYROM5_BENCH_ATOM_HPP
+
+#ifndef BENCH_IN_PIN
+#define BENCH_IN_PIN 32
+#endif
+#ifndef BENCH_OUT_PIN
+#define BENCH_OUT_PIN 26
+#endif
+
+// access to private members of GyroM5Atom.hpp (friend)
+class GyroM5Bench {
+public:
+  static int setupIn(int pin) {
+    if (PulsePort::InCH == 0) PulsePort::InCH = 1;
+    PulsePort::IN[0].init(pin, 21*1000, micros());
+    return 0;
+  }
+  static InPulse* in(int ch) { return &PulsePort::IN[ch]; }
+  static void ISR(int ch) { PulsePort::ISR((void*)(intptr_t)ch); }
+  static void handleJson(void) { SERVER::handleJson(); }
+  static void update(M5StackAHRS& A, const float* g, const float* a, float* out) {
+    A.MahonyAHRSupdateIMU(g[0],g[1],g[2], a[0],a[1],a[2], &out[0],&out[1],&out[2]);
+  }
+  static float invSqrt(M5StackAHRS& A, float x) { return A.invSqrt(x); }
+  static void drain(TelemetryTx& T) { T.tail = T.head; }
+  static void rewind(VibrationFFT& V) { V.last = 0; }
+};
+
+// inputs not known at compile time (fixed seed)
+struct BenchInput {
+  static const int N = 256;
+  float usec[N];   // pulse width [usec]
+  float gyro[N][3];  // [rad/s]
+  float accl[N][3];  // [G]
+  BenchInput() {
+    unsigned long seed = 12345;
+    for (int i=0; i<N; i++) {
+      float r[7];
+      for (int k=0; k<7; k++) {
+        seed = seed*1103515245UL + 12345UL;
+        r[k] = ((seed >> 16) & 0x7FFF)/32768.0F - 0.5F;
+      }
+      usec[i] = 1500.0F + 800.0F*r[0];
+      gyro[i][0] = r[1]; gyro[i][1] = r[2]; gyro[i][2] = 4.0F*r[3];
+      accl[i][0] = 0.3F*r[4]; accl[i][1] = 0.3F*r[5]; accl[i][2] = 1.0F + 0.1F*r[6];
+    }
+  }
+};
+inline BenchInput& benchInput(void) { static BenchInput in; return in; }
+
+
+BENCH(PulsePort_ISR) {
+  int ch = GyroM5Bench::setupIn(BENCH_IN_PIN);
+  InPulse* pwm = GyroM5Bench::in(ch);
+  int v = digitalRead(BENCH_IN_PIN);
+  while (st.run()) {
+    pwm->prev = !v;
+    GyroM5Bench::ISR(ch);
+  }
+  benchKeep(pwm->dstUsec);
+}
+
+BENCH(PulsePort_mapFloat) {
+  const BenchInput& in = benchInput();
+  float sum = 0.0F;
+  int i = 0;
+  while (st.run()) {
+    sum += PulsePort::mapFloat(in.usec[i++ & 255], 0,20000, 0,65536);
+    benchKeep(sum);
+  }
+}
+
+BENCH(PulsePort_putUsec) {
+  static int ch = PulsePort::setupOut(BENCH_OUT_PIN, 50);
+  const BenchInput& in = benchInput();
+  int i = 0;
+  while (st.run()) PulsePort::putUsec(ch, in.usec[i++ & 255]);
+}
+
+BENCH(OutputShaper_duty) {
+  const BenchInput& in = benchInput();
+  OutputShaper S;
+  S.setup(1000,1500,2000, 20,30,10);
+  S.build(20000,16);
+  uint32_t sum = 0;
+  int i = 0;
+  while (st.run()) {
+    sum += S.duty(in.usec[i & 255], 2500UL*i);
+    i++;
+    benchKeep(sum);
+  }
+}
+
+BENCH(FlightRecorder_put) {
+  const BenchInput& in = benchInput();
+  static FlightRecorder<> REC;
+  REC.setup(400,750,500);
+  REC.setLimits(600,60,0,1500,false);
+  FlightSample S;
+  memset(&S, 0, sizeof(S));
+  int i = 0;
+  while (st.run()) {
+    int k = i++ & 255;
+    S.time = 2500*i;
+    S.ch1 = in.usec[k];
+    S.rate = 1000.0F*in.gyro[k][2];
+    REC.put(S);
+  }
+  benchKeep(REC.getCount());
+}
+
+BENCH(ServoPID_loop) {
+  const BenchInput& in = benchInput();
+  ServoPID PID;
+  PID.setup(50/50.0, 10/250.0, 5/5000.0, 1000,1500,2000, 400);
+  PID.setTimer(true);
+  float out = 0.0F;
+  int i = 0;
+  while (st.run()) {
+    int k = i++ & 255;
+    out = PID.loop(in.usec[k], 100.0F*in.gyro[k][2]);
+    benchKeep(out);
+  }
+}
+
+BENCH(ServoPID_predictor) {
+  const BenchInput& in = benchInput();
+  ServoPID PID;
+  PID.setup(50/50.0, 10/250.0, 5/5000.0, 1000,1500,2000, 400);
+  PID.setTimer(true);
+  PID.setPredictor(50, 5, 100, 1.4F, 0.2F);
+  float out = 0.0F;
+  int i = 0;
+  while (st.run()) {
+    int k = i++ & 255;
+    out = PID.loop(in.usec[k], 100.0F*in.gyro[k][2]);
+    benchKeep(out);
+  }
+}
+
+BENCH(M5StackAHRS_MahonyAHRSupdateIMU) {
+  const BenchInput& in = benchInput();
+  static M5StackAHRS AHRS;
+  float out[3];
+  int i = 0;
+  while (st.run()) {
+    int k = i++ & 255;
+    GyroM5Bench::update(AHRS, in.gyro[k], in.accl[k], out);
+    benchKeep(out);
+  }
+}
+
+BENCH(M5StackAHRS_invSqrt) {
+  const BenchInput& in = benchInput();
+  static M5StackAHRS AHRS;
+  float sum = 0.0F;
+  int i = 0;
+  while (st.run()) {
+    sum += GyroM5Bench::invSqrt(AHRS, in.accl[i++ & 255][2]);
+    benchKeep(sum);
+  }
+}
+
+// Print that only counts (the socket side of CONFIG::printJSON)
+class BenchSink : public Print {
+public:
+  size_t count = 0;
+  size_t write(uint8_t) { count++; return 1; }
+  size_t write(const uint8_t*, size_t n) { count += n; return n; }
+};
+
+BENCH(CONFIG_printJSON) {
+  CONFIG conf;
+  conf.init();
+  BenchSink out;
+  while (st.run()) {
+    conf.printJSON(out);
+    benchKeep(out.count);
+  }
+}
+
+BENCH(SERVER_handleJson) {
+  static float LOOK[13];
+  static const char* KEYS[13] = {
+    "CH1_FREQ","CH1_USEC","IMU_PITCH","IMU_ROLL","IMU_RATE","PID_LOOP","PID_USEC",
+    "PID_PHASE","PID_DELAY","CH1_JITTER","PWM_FREQ","IMU_SLIP","EST_USEC",
+  };
+  static bool init = false;
+  if (!init) {
+    for (int n=0; n<13; n++) SERVER::lookFloat(KEYS[n], &LOOK[n]);
+    init = true;
+  }
+  const BenchInput& in = benchInput();
+  int i = 0;
+  while (st.run()) {
+    LOOK[1] = in.usec[i++ & 255];
+    GyroM5Bench::handleJson();
+  }
+}
+
+BENCH(TelemetryTx_put) {
+  static TelemetryTx TLM;
+  static bool init = false;
+  if (!init) {
+    TLM.setup(1, IPAddress(127,0,0,1), 1, 9);  // discard port
+    init = true;
+  }
+  const BenchInput& in = benchInput();
+  TelemetrySample S = {};
+  int i = 0;
+  while (st.run()) {
+    int k = i++ & 255;
+    S.time = micros();
+    S.ch1 = in.usec[k];
+    S.rate = 573.0F*in.gyro[k][2];
+    TLM.put(S);
+    if ((i & 15) == 0) GyroM5Bench::drain(TLM);
+  }
+  benchKeep(TLM.getDropped());
+}
+
+BENCH(TelemetryPacker_packet) {
+  const BenchInput& in = benchInput();
+  static TelemetryPacker PACK;
+  TelemetrySample S = {};
+  int i = 0, n = 0;
+  while (st.run()) {
+    for (int k=0; k<TelemetryPacker::MAX; k++) {
+      S.ch1 = in.usec[(i + k) & 255];
+      PACK.add(S);
+    }
+    n = PACK.finish(i++);
+    benchKeep(n);
+  }
+}
+
+// two vibration peaks at 400Hz sampling (notches placed before timing)
+static VibrationFFT& benchVibration(void) {
+  static VibrationFFT* V = NULL;
+  if (!V) {
+    V = new VibrationFFT();
+    V->setup(2);
+    unsigned long t0 = micros();
+    for (int i=0; i<4*VibrationFFT::N; i++) {
+      float t = i/400.0F;
+      delayMicroseconds(2500);
+      V->loop(20.0F*sinf(2.0F*PI*95.0F*t) + 8.0F*sinf(2.0F*PI*150.0F*t));
+      V->analyze();
+    }
+    benchKeep(t0);
+  }
+  return *V;
+}
+
+BENCH(VibrationFFT_loop) {
+  VibrationFFT& V = benchVibration();
+  const BenchInput& in = benchInput();
+  float sum = 0.0F;
+  int i = 0;
+  while (st.run()) {
+    sum += V.loop(100.0F*in.gyro[i++ & 255][2]);
+    benchKeep(sum);
+  }
+}
+
+BENCH(VibrationFFT_analyze) {
+  VibrationFFT& V = benchVibration();
+  while (st.run()) {
+    GyroM5Bench::rewind(V);
+    V.analyze();
+  }
+  benchKeep(V.getNotch(0));
+}
+
+#endif
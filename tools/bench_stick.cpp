@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// bench_stick.cpp: GyroM5Stick.ino のベンチマーク（ホストのみ、bench.cpp とリンク）
+//  スケッチをそのままインクルードして setup()/loop() は呼ばない
+//  data_draw() の描画はホスト用LCDで座標の checksum になる
+////////////////////////////////////////////////////////////////////////////////
+#include "GyroM5Stick.ino"
+#include "bench.hpp"
+
+// ring buffers and IMU means as after mean_init()
+static void stick_init(void) {
+  static bool init = false;
+  if (init) return;
+  data_init(DATA_Setpoint,(char*)"CH1",TFT_CYAN);
+  data_init(DATA_Output,(char*)"SRV",TFT_MAGENTA);
+  data_init(DATA_Input,(char*)"YAW",TFT_YELLOW);
+  unsigned long seed = 12345;
+  for (int n=0; n<DATA_SIZE; n++) {
+    for (int id=0; id<3; id++) {
+      seed = seed*1103515245UL + 12345UL;
+      data_put(id, (int)((seed >> 16) % 1001) - 500);
+    }
+  }
+  const float g[3] = {0.05F, -0.08F, 0.99F};
+  for (int i=0; i<3; i++) {
+    OMEGA_MEAN[i] = 0.01F*(i+1);
+    ACCEL_MEAN[i] = g[i];
+  }
+  init = true;
+}
+
+static float STICK_IMU[256][3];
+static void stick_imu(void) {
+  unsigned long seed = 54321;
+  for (int n=0; n<256; n++) {
+    for (int i=0; i<3; i++) {
+      seed = seed*1103515245UL + 12345UL;
+      STICK_IMU[n][i] = ((seed >> 16) & 0x7FFF)/32768.0F - 0.5F;
+    }
+  }
+}
+
+
+BENCH(Stick_data_put) {
+  stick_init();
+  int i = 0;
+  while (st.run()) {
+    data_put(i % 3, i & 511);
+    i++;
+  }
+}
+
+BENCH(Stick_data_draw) {
+  stick_init();
+  int lastData = 8*1000/DATA_MSEC;
+  while (st.run()) data_draw(lastData, 9);
+  benchKeep(canvas.checksum);
+}
+
+BENCH(Stick_data_MAE) {
+  stick_init();
+  int lastData = 8*1000/DATA_MSEC;
+  float sum = 0.0F;
+  while (st.run()) {
+    sum += data_MAE(0, 2, lastData);
+    benchKeep(sum);
+  }
+}
+
+BENCH(Stick_getYawRate) {
+  stick_init();
+  stick_imu();
+  float sum = 0.0F;
+  int i = 0;
+  while (st.run()) {
+    sum += getYawRate(STICK_IMU[i++ & 255]);
+    benchKeep(sum);
+  }
+}
+
+BENCH(Stick_getHorizontalG) {
+  stick_init();
+  stick_imu();
+  float sum = 0.0F;
+  int i = 0;
+  while (st.run()) {
+    sum += getHorizontalG(STICK_IMU[i++ & 255]);
+    benchKeep(sum);
+  }
+}
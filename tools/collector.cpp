@@ -0,0 +1,298 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// collector: GyroM5Atom のUDPテレメトリ（Telemetry.hpp）の受信と保存（複数台）
+//  車両ごとに番号の欠落・重複・順序違いを数え、車載時計をホスト時計に合わせる
+//  時計合わせ: 10秒ごとの (受信時刻 - 送信時刻) の最小値（最短の遅延）を直線で近似
+//   （定数項がオフセット、傾きが水晶の誤差[ppm]、32bitのusecの一巡は展開）
+//  出力:
+//   DIR/car-XXXXXXXX.csv  受信順の全サンプル（HOST_USECは受信時点の推定値）
+//   DIR/aligned.csv       終了時に全車を同じ時刻の格子に並べたもの（0次ホールド、
+//                         途切れた区間は空欄）
+//   標準エラー            1秒ごとの状態（パケット数、欠落、遅延、時計誤差）
+//   標準出力（-g）        gnuplot のコマンド（直近10秒のヨーレートと出力）
+//
+// build:
+//  g++ -O2 -std=c++17 -o collector collector.cpp
+// usage:
+//  ./collector [-p PORT] [-o DIR] [-t SEC] [-r HZ] [-g]
+//   -p: 受信ポート（既定5005）  -o: 出力先（既定 .）  -t: 受信時間（既定は Ctrl-C まで）
+//   -r: aligned.csv の格子の周波数（既定100Hz）  -g: ./collector -g | gnuplot
+////////////////////////////////////////////////////////////////////////////////
+#include "../GyroM5Atom/Telemetry.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+static const int64_t WINDOW_US = 10*1000000LL;  // offset window
+static const int64_t GAP_US = 100*1000LL;       // hold limit in aligned.csv
+static const int64_t PLOT_US = 10*1000000LL;    // span of live plot
+
+static volatile bool running = true;
+static void onSignal(int) { running = false; }
+
+static int64_t hostUsec(void) {
+  static timespec t0 = {0, 0};
+  timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  if (t0.tv_sec == 0 && t0.tv_nsec == 0) t0 = t;
+  return (t.tv_sec - t0.tv_sec)*1000000LL + (t.tv_nsec - t0.tv_nsec)/1000;
+}
+
+// one sample with unwrapped car time
+struct Row {
+  int64_t car;
+  uint32_t seq;
+  TelemetrySample s;
+};
+
+struct Car {
+  uint32_t id = 0;
+  FILE* fp = NULL;
+  std::vector<Row> rows;
+  // sequence
+  bool started = false;
+  uint32_t next = 0;      // expected seq
+  uint64_t recent = 0;    // bit k: seq (next-1-k) received
+  long packets = 0, samples = 0, lost = 0, dups = 0, late = 0;
+  long lastPackets = 0, lastSamples = 0;
+  // clock
+  bool clocked = false;
+  int64_t ref = 0;        // unwrapped car time of the last header
+  std::map<int64_t,std::pair<int64_t,int64_t>> minima;  // window -> (car, host-car)
+  double offset = 0, drift = 0;
+  //
+  int64_t unwrap(uint32_t t) const { return ref + (int32_t)(t - (uint32_t)ref); }
+  int64_t toHost(int64_t car) const { return (int64_t)(car*(1.0 + drift) + offset); }
+  // min delay per window, line fit over windows (constant with one window)
+  void fit(void) {
+    int n = minima.size();
+    if (n == 0) return;
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (auto& m: minima) {
+      double x = m.second.first, y = m.second.second;
+      sx += x; sy += y; sxx += x*x; sxy += x*y;
+    }
+    double den = n*sxx - sx*sx;
+    drift = (n >= 2 && den > 0)? (n*sxy - sx*sy)/den: 0.0;
+    offset = (sy - drift*sx)/n;
+  }
+  void clock(uint32_t sent, int64_t rx) {
+    ref = clocked? unwrap(sent): (int64_t)sent;
+    clocked = true;
+    int64_t d = rx - ref;
+    int64_t w = ref / WINDOW_US;
+    auto it = minima.find(w);
+    if (it == minima.end() || d < it->second.second) minima[w] = std::make_pair(ref, d);
+    fit();
+  }
+  // false if duplicated (already received)
+  bool sequence(uint32_t seq) {
+    if (!started) { started = true; next = seq + 1; recent = 1; return true; }
+    int32_t diff = (int32_t)(seq - next);
+    if (diff >= 0) {
+      lost += diff;
+      recent = (diff + 1 >= 64)? 1: ((recent << (diff + 1)) | 1);
+      next = seq + 1;
+      return true;
+    }
+    int k = -diff - 1;
+    if (k >= 64) { dups++; return false; }
+    if (recent & (1ULL << k)) { dups++; return false; }
+    recent |= (1ULL << k);
+    lost--;
+    late++;
+    return true;
+  }
+};
+
+static std::map<uint32_t,Car> CARS;
+static std::string OUTDIR = ".";
+
+static Car& getCar(uint32_t id) {
+  Car& c = CARS[id];
+  if (!c.fp) {
+    c.id = id;
+    char path[512];
+    snprintf(path, sizeof(path), "%s/car-%08x.csv", OUTDIR.c_str(), id);
+    c.fp = fopen(path, "w");
+    if (!c.fp) { fprintf(stderr, "collector: cannot write %s\n", path); exit(1); }
+    fprintf(c.fp, "HOST_USEC,CAR_USEC,SEQ,CH1,OUT,RATE,ROLL,PITCH,SLIP,LOOP,FLAGS\n");
+    fprintf(stderr, "collector: car %08x\n", id);
+  }
+  return c;
+}
+
+static void receive(const uint8_t* buf, int n, int64_t rx) {
+  TelemetryHeader h;
+  const TelemetrySample* s;
+  if (!telemetryParse(buf, n, h, s)) {
+    fprintf(stderr, "collector: bad packet (%d bytes)\n", n);
+    return;
+  }
+  Car& c = getCar(h.car);
+  if (!c.sequence(h.seq)) return;
+  c.clock(h.sent, rx);
+  c.packets++;
+  for (int k=0; k<h.count; k++) {
+    Row r;
+    memcpy(&r.s, &s[k], sizeof(TelemetrySample));
+    r.car = c.unwrap(r.s.time);
+    r.seq = h.seq;
+    c.rows.push_back(r);
+    c.samples++;
+    fprintf(c.fp, "%lld,%lld,%u,%d,%d,%.1f,%.2f,%.2f,%.2f,%u,%u\n",
+      (long long)c.toHost(r.car), (long long)r.car, r.seq, r.s.ch1, r.s.out,
+      r.s.rate/10.0, r.s.roll/100.0, r.s.pitch/100.0, r.s.slip/100.0, r.s.loop, r.s.flags);
+  }
+}
+
+static void status(void) {
+  for (auto& it: CARS) {
+    Car& c = it.second;
+    fprintf(stderr, "car %08x: %4ld pkt/s %5ld smp/s lost=%ld dup=%ld late=%ld offset=%.3fs clock=%+.1fppm\n",
+      c.id, c.packets - c.lastPackets, c.samples - c.lastSamples, c.lost, c.dups, c.late,
+      c.offset/1e6, -c.drift*1e6);
+    c.lastPackets = c.packets;
+    c.lastSamples = c.samples;
+    fflush(c.fp);
+  }
+}
+
+// gnuplot: yaw rate and output of each car in the last PLOT_US
+static void plot(int64_t now) {
+  if (CARS.empty()) return;
+  printf("set multiplot layout 2,1\nset xrange [%.1f:%.1f]\n", (now - PLOT_US)/1e6, now/1e6);
+  for (int panel=0; panel<2; panel++) {
+    printf("set ylabel '%s'\nplot", panel? "out [usec]": "rate [deg/sec]");
+    const char* sep = "";
+    for (auto& it: CARS) { printf("%s '-' with lines title '%08x'", sep, it.first); sep = ","; }
+    printf("\n");
+    for (auto& it: CARS) {
+      const Car& c = it.second;
+      size_t i = c.rows.size();
+      while (i > 0 && c.toHost(c.rows[i-1].car) >= now - PLOT_US) i--;
+      for (; i<c.rows.size(); i++) {
+        const TelemetrySample& s = c.rows[i].s;
+        printf("%.4f %.1f\n", c.toHost(c.rows[i].car)/1e6, panel? (double)s.out: s.rate/10.0);
+      }
+      printf("e\n");
+    }
+  }
+  printf("unset multiplot\n");
+  fflush(stdout);
+}
+
+// all cars on one grid with the final clock fit (zero-order hold)
+static void align(double hz) {
+  if (CARS.empty()) return;
+  std::string path = OUTDIR + "/aligned.csv";
+  FILE* fp = fopen(path.c_str(), "w");
+  if (!fp) { fprintf(stderr, "collector: cannot write %s\n", path.c_str()); return; }
+  int64_t t0 = INT64_MAX, t1 = INT64_MIN;
+  fprintf(fp, "HOST_SEC");
+  for (auto& it: CARS) {
+    Car& c = it.second;
+    std::stable_sort(c.rows.begin(), c.rows.end(), [](const Row& a, const Row& b) { return a.car < b.car; });
+    if (c.rows.empty()) continue;
+    t0 = std::min(t0, c.toHost(c.rows.front().car));
+    t1 = std::max(t1, c.toHost(c.rows.back().car));
+    const char* cols[] = {"CH1","OUT","RATE","ROLL","SLIP","FLAGS"};
+    for (const char* k: cols) fprintf(fp, ",%08x_%s", c.id, k);
+  }
+  fprintf(fp, "\n");
+  int64_t step = (int64_t)(1e6/hz);
+  std::vector<size_t> pos(CARS.size(), 0);
+  long lines = 0;
+  for (int64_t t=t0; t<=t1; t+=step, lines++) {
+    fprintf(fp, "%.6f", t/1e6);
+    int n = 0;
+    for (auto& it: CARS) {
+      const Car& c = it.second;
+      size_t& i = pos[n++];
+      while (i < c.rows.size() && c.toHost(c.rows[i].car) <= t) i++;
+      if (c.rows.empty()) continue;
+      if (i == 0 || t - c.toHost(c.rows[i-1].car) > GAP_US) { fprintf(fp, ",,,,,,"); continue; }
+      const TelemetrySample& s = c.rows[i-1].s;
+      fprintf(fp, ",%d,%d,%.1f,%.2f,%.2f,%u", s.ch1, s.out, s.rate/10.0, s.roll/100.0, s.slip/100.0, s.flags);
+    }
+    fprintf(fp, "\n");
+  }
+  fclose(fp);
+  fprintf(stderr, "collector: %s %ld rows x %d cars at %.0fHz\n", path.c_str(), lines, (int)CARS.size(), hz);
+}
+
+static void usage(const char* name) {
+  fprintf(stderr, "usage: %s [-p PORT] [-o DIR] [-t SEC] [-r HZ] [-g]\n", name);
+  exit(1);
+}
+
+int main(int argc, char** argv) {
+  int port = TELEMETRY_PORT;
+  double seconds = 0;
+  double hz = 100;
+  bool gnuplot = false;
+  int c;
+  while ((c = getopt(argc, argv, "p:o:t:r:g")) != -1) {
+    switch (c) {
+      case 'p': port = atoi(optarg); break;
+      case 'o': OUTDIR = optarg; break;
+      case 't': seconds = atof(optarg); break;
+      case 'r': hz = atof(optarg); break;
+      case 'g': gnuplot = true; break;
+      default: usage(argv[0]);
+    }
+  }
+  if (hz <= 0) usage(argv[0]);
+
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  int on = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  int rcv = 1 << 20;
+  setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcv, sizeof(rcv));
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (fd < 0 || bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+    fprintf(stderr, "collector: cannot bind port %d\n", port);
+    return 1;
+  }
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  fprintf(stderr, "collector: port %d -> %s\n", port, OUTDIR.c_str());
+
+  static uint8_t buf[2048];
+  int64_t start = hostUsec();
+  int64_t tick = start + 1000000;
+  while (running) {
+    int64_t now = hostUsec();
+    if (seconds > 0 && now - start >= seconds*1e6) break;
+    if (now >= tick) {
+      status();
+      if (gnuplot) plot(now);
+      tick += 1000000;
+    }
+    pollfd p = {fd, POLLIN, 0};
+    if (poll(&p, 1, 50) <= 0) continue;
+    int n;
+    while ((n = recv(fd, buf, sizeof(buf), MSG_DONTWAIT)) > 0) receive(buf, n, hostUsec());
+  }
+  close(fd);
+  status();
+  align(hz);
+  for (auto& it: CARS) fclose(it.second.fp);
+  return 0;
+}
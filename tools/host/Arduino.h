@@ -0,0 +1,236 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// ホスト用のArduino.h（GyroM5Atom.hpp や他のライブラリをPCでビルドするため）
+//  micros()/millis() は host_clock で進める仮想時計
+//  digitalRead() は host_pin() の値、attachInterruptArg() は host_edge() で呼ぶ
+//  ledcWrite() の値は host_duty() で読める
+//  setCpuFrequencyMhz() の値は host_mhz() で読める
+//  Ticker/FreeRTOS/esp_timer は何もしない（呼び出し側が周期を進める）
+//  1つの翻訳単位からのみインクルードする（-std=c++17）
+////////////////////////////////////////////////////////////////////////////////
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+
+#ifndef ARDUINO
+#define ARDUINO 10800
+#include "driver/gpio.h"
+
+#endif
+
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PI 3.1415926535897932384626433832795
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+#define HIGH 1
+#define LOW 0
+#define INPUT 1
+#define OUTPUT 2
+#define INPUT_PULLUP 5
+#define RISING 1
+#define FALLING 2
+#define CHANGE 3
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define PROGMEM
+#define F(x) x
+#ifndef constrain
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#include "driver/gpio.h"
+
+#endif
+
+
+// virtual clock in usec
+inline unsigned long& host_clock(void) { static unsigned long t = 0; return t; }
+inline unsigned long micros(void) { return host_clock(); }
+inline unsigned long millis(void) { return host_clock() / 1000; }
+inline void delay(unsigned long ms) { host_clock() += ms * 1000; }
+inline void delayMicroseconds(unsigned int us) { host_clock() += us; }
+inline int64_t esp_timer_get_time(void) { return (int64_t)host_clock(); }
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+
+// GPIO and interrupts
+struct HostIsr { void (*fn)(void*); void* arg; };
+inline int& host_pin(int pin) { static int level[64]; return level[pin & 63]; }
+inline HostIsr& host_isr(int pin) { static HostIsr isr[64]; return isr[pin & 63]; }
+inline void host_edge(int pin, int level) {
+  host_pin(pin) = level;
+  HostIsr& isr = host_isr(pin);
+  if (isr.fn) isr.fn(isr.arg);
+}
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t pin) { return host_pin(pin); }
+inline void digitalWrite(uint8_t pin, uint8_t val) { host_pin(pin) = val; }
+inline int analogRead(uint8_t) { return 0; }
+inline void analogWrite(uint8_t, int) {}
+inline void attachInterruptArg(uint8_t pin, void (*fn)(void*), void* arg, int) { host_isr(pin) = {fn, arg}; }
+inline void detachInterrupt(uint8_t pin) { host_isr(pin) = {NULL, NULL}; }
+inline unsigned long pulseIn(uint8_t, uint8_t, unsigned long = 1000000) { return 0; }
+
+
+// LEDC
+inline uint32_t& host_duty(int ch) { static uint32_t duty[16]; return duty[ch & 15]; }
+inline double ledcSetup(uint8_t, double freq, uint8_t) { return freq; }
+inline void ledcWrite(uint8_t ch, uint32_t duty) { host_duty(ch) = duty; }
+inline void ledcAttachPin(uint8_t, uint8_t) {}
+inline void ledcDetachPin(uint8_t) {}
+
+inline uint32_t& host_mhz(void) { static uint32_t mhz = 240; return mhz; }
+inline bool setCpuFrequencyMhz(uint32_t mhz) { if (mhz != 80 && mhz != 160 && mhz != 240) return false; host_mhz() = mhz; return true; }
+inline uint32_t getCpuFrequencyMhz(void) { return host_mhz(); }
+inline uint32_t getApbFrequency(void) { return 80000000; }
+
+
+// String (subset)
+class String {
+  std::string s;
+public:
+  String(const char* c = "") : s(c? c: "") {}
+  String(const std::string& c) : s(c) {}
+  String(int v) : s(std::to_string(v)) {}
+  unsigned int length(void) const { return s.size(); }
+  const char* c_str(void) const { return s.c_str(); }
+  long toInt(void) const { return atol(s.c_str()); }
+  float toFloat(void) const { return atof(s.c_str()); }
+  void toCharArray(char* buf, unsigned int size) const { if (size == 0) return; strncpy(buf, s.c_str(), size - 1); buf[size - 1] = 0; }
+  int indexOf(const char* t, int from = 0) const { size_t p = s.find(t, from); return p == std::string::npos? -1: (int)p; }
+  int indexOf(char c, int from = 0) const { size_t p = s.find(c, from); return p == std::string::npos? -1: (int)p; }
+  String substring(int b, int e = -1) const { return String(s.substr(b, e < 0? std::string::npos: e - b)); }
+  String& operator+=(char c) { s += c; return *this; }
+  String& operator+=(const char* c) { s += c; return *this; }
+  bool operator==(const char* c) const { return s == c; }
+};
+
+
+class IPAddress {
+  uint8_t a[4];
+public:
+  IPAddress(uint8_t a0 = 0, uint8_t a1 = 0, uint8_t a2 = 0, uint8_t a3 = 0) : a{a0, a1, a2, a3} {}
+  uint8_t operator[](int i) const { return a[i & 3]; }
+  operator uint32_t() const { return a[0] | (a[1] << 8) | (a[2] << 16) | ((uint32_t)a[3] << 24); }
+};
+
+
+// Print/Serial (stdout when enabled)
+class Print {
+public:
+  bool enabled = false;
+  virtual ~Print() {}
+  virtual size_t write(const uint8_t* b, size_t n) { return enabled? fwrite(b, 1, n, stdout): n; }
+  size_t write(uint8_t c) { return write(&c, 1); }
+  virtual void flush(void) {}
+  size_t printf(const char* fmt, ...) {
+    char buf[512];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    return write((const uint8_t*)buf, n < (int)sizeof(buf)? n: sizeof(buf) - 1);
+  }
+  size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t print(const String& s) { return print(s.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v) { return printf("%d", v); }
+  size_t print(unsigned int v) { return printf("%u", v); }
+  size_t print(long v) { return printf("%ld", v); }
+  size_t print(unsigned long v) { return printf("%lu", v); }
+  size_t print(double v, int d = 2) { return printf("%.*f", d, v); }
+  size_t print(const IPAddress& a) { return printf("%d.%d.%d.%d", a[0], a[1], a[2], a[3]); }
+  template <class T> size_t println(const T& v) { return print(v) + print("\n"); }
+  size_t println(void) { return print("\n"); }
+};
+class Stream : public Print {
+public:
+  virtual int available(void) { return 0; }
+  virtual int read(void) { return -1; }
+  size_t readBytes(uint8_t* b, size_t n) { size_t i = 0; int c; while (i < n && (c = read()) >= 0) b[i++] = c; return i; }
+};
+
+#define SERIAL_8N1 0x800001c
+#define SERIAL_8E2 0x800003e
+class HardwareSerial : public Stream {
+public:
+  HardwareSerial(int = 0) {}
+  void begin(unsigned long, uint32_t = SERIAL_8N1, int8_t = -1, int8_t = -1, bool = false, unsigned long = 20000UL, uint8_t = 112) {}
+  void end(void) {}
+  void onReceive(void (*)(void), bool = false) {}
+  bool setRxTimeout(uint8_t) { return true; }
+  size_t setRxBufferSize(size_t n) { return n; }
+  operator bool(void) { return true; }
+};
+inline HardwareSerial Serial(0), Serial1(1), Serial2(2);
+
+
+class EspClass {
+public:
+  uint32_t getCycleCount(void) { return (uint32_t)(host_clock() * 240); }
+  uint32_t getFreeHeap(void) { return 200000; }
+  uint32_t getMinFreeHeap(void) { return 200000; }
+  uint32_t getMaxAllocHeap(void) { return 100000; }
+  uint32_t getHeapSize(void) { return 300000; }
+  uint64_t getEfuseMac(void) { return 0x00000000A1B2C3D4ULL; }
+  void restart(void) {}
+};
+inline EspClass ESP;
+
+
+// FreeRTOS (no tasks on host: the caller runs control steps)
+typedef void* TaskHandle_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+typedef struct { int x; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(m) (void)(m)
+#define portEXIT_CRITICAL(m) (void)(m)
+#define portENTER_CRITICAL_ISR(m) (void)(m)
+#define portEXIT_CRITICAL_ISR(m) (void)(m)
+#define portYIELD_FROM_ISR(...) ((void)0)
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define portMAX_DELAY 0xffffffff
+#define pdMS_TO_TICKS(x) (x)
+#define portTICK_PERIOD_MS 1
+#define configMAX_PRIORITIES 25
+#define tskNO_AFFINITY 0x7fffffff
+inline BaseType_t xTaskCreatePinnedToCore(void (*)(void*), const char*, uint32_t, void*, UBaseType_t, TaskHandle_t* h, BaseType_t) { if (h) *h = NULL; return pdPASS; }
+inline void vTaskNotifyGiveFromISR(TaskHandle_t, BaseType_t* w) { if (w) *w = pdFALSE; }
+inline void xTaskNotifyGive(TaskHandle_t) {}
+inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t t) { host_clock() += t * 1000; return 0; }
+inline void vTaskDelay(TickType_t t) { host_clock() += t * 1000; }
+inline TickType_t xTaskGetTickCount(void) { return millis(); }
+inline void vTaskDelete(TaskHandle_t) {}
+inline BaseType_t xPortGetCoreID(void) { return 1; }
+inline TaskHandle_t xTaskGetCurrentTaskHandle(void) { return NULL; }
+inline TaskHandle_t xTaskGetCurrentTaskHandleForCPU(BaseType_t) { return NULL; }
+inline TaskHandle_t xTaskGetIdleTaskHandleForCPU(BaseType_t) { return NULL; }
+inline TaskHandle_t xTaskGetHandle(const char*) { return NULL; }
+inline UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) { return 2048; }
+#define portNUM_PROCESSORS 2
+
+#include "driver/gpio.h"
+
+#endif
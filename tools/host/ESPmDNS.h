@@ -0,0 +1,18 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// ホスト用のESPmDNS.h: 何もしない
+////////////////////////////////////////////////////////////////////////////////
+#ifndef HOST_ESPMDNS_H
+#define HOST_ESPMDNS_H
+
+class MDNSResponder {
+public:
+  bool begin(const char*) { return false; }
+  void addService(const char*, const char*, int) {}
+};
+inline MDNSResponder MDNS;
+
+#endif
@@ -0,0 +1,53 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// ホスト用のFastLED.h: 色の保持のみ（表示しない、FastLED.leds が addLeds() の配列）
+////////////////////////////////////////////////////////////////////////////////
+#ifndef HOST_FASTLED_H
+#define HOST_FASTLED_H
+
+#include "Arduino.h"
+
+struct CRGB {
+  uint8_t r, g, b;
+  enum { Black = 0x000000, White = 0xFFFFFF, Red = 0xFF0000, Green = 0x008000, Blue = 0x0000FF,
+         Yellow = 0xFFFF00, Orange = 0xFFA500, Cyan = 0x00FFFF, Magenta = 0xFF00FF, Purple = 0x800080 };
+  CRGB() : r(0), g(0), b(0) {}
+  CRGB(uint32_t c) : r(c >> 16), g(c >> 8), b(c) {}
+  CRGB(uint8_t R, uint8_t G, uint8_t B) : r(R), g(G), b(B) {}
+  bool operator==(const CRGB& o) const { return r == o.r && g == o.g && b == o.b; }
+  bool operator!=(const CRGB& o) const { return !(*this == o); }
+};
+struct CHSV {
+  uint8_t h, s, v;
+  CHSV(uint8_t H, uint8_t S, uint8_t V) : h(H), s(S), v(V) {}
+  operator CRGB() const {
+    int i = h / 43, f = (h - i * 43) * 6;
+    uint8_t p = v * (255 - s) / 255, q = v * (255 - s * f / 255) / 255, t = v * (255 - s * (255 - f) / 255) / 255;
+    switch (i) {
+      case 0: return CRGB(v, t, p);
+      case 1: return CRGB(q, v, p);
+      case 2: return CRGB(p, v, t);
+      case 3: return CRGB(p, q, v);
+      case 4: return CRGB(t, p, v);
+      default: return CRGB(v, p, q);
+    }
+  }
+};
+enum EOrder { RGB, GRB };
+template <int PIN, EOrder O> class WS2812 {};
+
+class CFastLED {
+public:
+  unsigned long shows = 0;
+  CRGB* leds = NULL;
+  int count = 0;
+  template <template <int, EOrder> class C, int PIN, EOrder O> void addLeds(CRGB* l, int n) { leds = l; count = n; }
+  void setBrightness(uint8_t) {}
+  void show(void) { shows++; }
+};
+inline CFastLED FastLED;
+
+#endif
@@ -0,0 +1,44 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// ホスト用のM5Atom.h: IMUの値は host_imu() に書いたものを返す
+////////////////////////////////////////////////////////////////////////////////
+#ifndef HOST_M5ATOM_H
+#define HOST_M5ATOM_H
+
+#include "Arduino.h"
+#include "FastLED.h"
+
+#ifndef HOST_IMU
+#define HOST_IMU
+struct HostImu { float gyro[3]; float accl[3]; float temp; };
+inline HostImu& host_imu(void) { static HostImu imu = {{0,0,0},{0,0,1},25}; return imu; }
+#endif
+
+class HostIMU {
+public:
+  int Init(void) { return 0; }
+  void getGyroData(float* x, float* y, float* z) { *x = host_imu().gyro[0]; *y = host_imu().gyro[1]; *z = host_imu().gyro[2]; }
+  void getAccelData(float* x, float* y, float* z) { *x = host_imu().accl[0]; *y = host_imu().accl[1]; *z = host_imu().accl[2]; }
+  void getTempData(float* t) { *t = host_imu().temp; }
+};
+class HostButton {
+public:
+  bool pressed = false;
+  bool wasPressed(void) { bool p = pressed; pressed = false; return p; }
+  bool isPressed(void) { return pressed; }
+  bool wasReleased(void) { return false; }
+  bool pressedFor(uint32_t) { return false; }
+};
+class HostM5 {
+public:
+  HostIMU IMU;
+  HostButton Btn;
+  void begin(bool = true, bool = true, bool = true) {}
+  void update(void) {}
+};
+inline HostM5 M5;
+
+#endif
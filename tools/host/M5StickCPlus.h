@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// ホスト用のM5StickCPlus.h: IMUの値は host_imu() に書いたものを返す
+//  LCDは表示しない（描画の座標を checksum に足すだけ）
+//  AXPの電圧/電流は host_axp() に書いたものを返す
+////////////////////////////////////////////////////////////////////////////////
+#ifndef HOST_M5STICKCPLUS_H
+#define HOST_M5STICKCPLUS_H
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#define TFT_BLACK 0x0000
+#define TFT_WHITE 0xFFFF
+#define TFT_RED 0xF800
+#define TFT_GREEN 0x07E0
+#define TFT_BLUE 0x001F
+#define TFT_CYAN 0x07FF
+#define TFT_MAGENTA 0xF81F
+#define TFT_YELLOW 0xFFE0
+#define TFT_ORANGE 0xFDA0
+#define TFT_PINK 0xFE19
+
+#ifndef HOST_IMU
+#define HOST_IMU
+struct HostImu { float gyro[3]; float accl[3]; float temp; };
+inline HostImu& host_imu(void) { static HostImu imu = {{0,0,0},{0,0,1},25}; return imu; }
+#endif
+
+// AXP192 rails [mV], [mA]
+struct HostAxp { float vin, iin, vusb, iusb, vbat, ibat; };
+inline HostAxp& host_axp(void) { static HostAxp axp = {5000,100,0,0,4000,0}; return axp; }
+
+typedef struct { uint16_t Year; uint8_t Month, Date, WeekDay; } RTC_DateTypeDef;
+typedef struct { uint8_t Hours, Minutes, Seconds; } RTC_TimeTypeDef;
+
+class TFT_eSPI : public Print {
+public:
+  int W, H;
+  unsigned long checksum = 0;
+  TFT_eSPI(int w = 135, int h = 240) : W(w), H(h) {}
+  size_t write(const uint8_t* b, size_t n) override { for (size_t i = 0; i < n; i++) checksum += b[i]; return n; }
+  int width(void) { return W; }
+  int height(void) { return H; }
+  void setRotation(int) {}
+  void setTextSize(int) {}
+  void setTextColor(int c) { checksum += c; }
+  void setTextColor(int c, int) { checksum += c; }
+  void setCursor(int x, int y) { checksum += x + y; }
+  void fillScreen(int c) { checksum += c; }
+  void drawLine(int x0, int y0, int x1, int y1, int c) { checksum += x0 + y0 + x1 + y1 + c; }
+  void drawFastHLine(int x, int y, int w, int c) { checksum += x + y + w + c; }
+  void drawFastVLine(int x, int y, int h, int c) { checksum += x + y + h + c; }
+  void drawRect(int x, int y, int w, int h, int c) { checksum += x + y + w + h + c; }
+  void fillRect(int x, int y, int w, int h, int c) { checksum += x + y + w + h + c; }
+  void qrcode(const char*, int = 0, int = 0, int = 0, int = 0) {}
+};
+class TFT_eSprite : public TFT_eSPI {
+public:
+  TFT_eSprite(TFT_eSPI*) {}
+  void* createSprite(int w, int h) { W = w; H = h; return this; }
+  void pushSprite(int, int) {}
+};
+
+class HostAXP {
+public:
+  void ScreenBreath(int) {}
+  float GetVinData(void) { return host_axp().vin / 1.7; }
+  float GetIinData(void) { return host_axp().iin / 0.625; }
+  float GetVusbinData(void) { return host_axp().vusb / 1.7; }
+  float GetIusbinData(void) { return host_axp().iusb / 0.375; }
+  float GetBatVoltage(void) { return host_axp().vbat / 1000.0; }
+  float GetBatCurrent(void) { return host_axp().ibat; }
+  void PowerOff(void) {}
+};
+class HostRTC {
+public:
+  void GetTime(RTC_TimeTypeDef* t) { unsigned long s = millis() / 1000; t->Hours = s / 3600 % 24; t->Minutes = s / 60 % 60; t->Seconds = s % 60; }
+  void GetData(RTC_DateTypeDef* d) { d->Year = 2000; d->Month = 1; d->Date = 1; d->WeekDay = 6; }
+  void SetTime(RTC_TimeTypeDef*) {}
+  void SetData(RTC_DateTypeDef*) {}
+};
+class HostStickIMU {
+public:
+  int Init(void) { return 0; }
+  void getGyroData(float* x, float* y, float* z) { *x = host_imu().gyro[0]; *y = host_imu().gyro[1]; *z = host_imu().gyro[2]; }
+  void getAccelData(float* x, float* y, float* z) { *x = host_imu().accl[0]; *y = host_imu().accl[1]; *z = host_imu().accl[2]; }
+  void getTempData(float* t) { *t = host_imu().temp; }
+};
+class HostStickButton {
+public:
+  bool pressed = false;
+  bool isPressed(void) { return pressed; }
+  bool wasPressed(void) { return pressed; }
+  bool pressedFor(uint32_t) { return false; }
+};
+class HostStick {
+public:
+  TFT_eSPI Lcd;
+  HostAXP Axp;
+  HostRTC Rtc;
+  HostStickIMU IMU;
+  HostStickButton BtnA, BtnB;
+  void begin(bool = true, bool = true, bool = true) {}
+  void update(void) {}
+};
+inline HostStick M5;
+
+#endif
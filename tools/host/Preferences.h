@@ -0,0 +1,42 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// ホスト用のPreferences.h: プロセス内のメモリに保存（電源断なし）
+////////////////////////////////////////////////////////////////////////////////
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include "Arduino.h"
+#include <map>
+
+inline std::map<std::string,std::string>& host_nvs(void) { static std::map<std::string,std::string> nvs; return nvs; }
+
+class Preferences {
+  std::string name;
+  bool readOnly = false;
+  std::string path(const char* key) const { return name + "/" + key; }
+public:
+  bool begin(const char* ns, bool ro = false) { name = ns; readOnly = ro; return true; }
+  void end(void) {}
+  size_t getBytes(const char* key, void* buf, size_t n) {
+    auto it = host_nvs().find(path(key));
+    if (it == host_nvs().end()) return 0;
+    n = min(n, it->second.size());
+    memcpy(buf, it->second.data(), n);
+    return n;
+  }
+  size_t putBytes(const char* key, const void* buf, size_t n) {
+    if (readOnly) return 0;
+    host_nvs()[path(key)].assign((const char*)buf, n);
+    return n;
+  }
+  size_t getBytesLength(const char* key) {
+    auto it = host_nvs().find(path(key));
+    return it == host_nvs().end()? 0: it->second.size();
+  }
+  bool remove(const char* key) { return host_nvs().erase(path(key)) > 0; }
+};
+
+#endif
@@ -0,0 +1,53 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// ホスト用のTicker.h: 仮想時計で host_tickers() が期限の来た処理を呼ぶ
+////////////////////////////////////////////////////////////////////////////////
+#ifndef HOST_TICKER_H
+#define HOST_TICKER_H
+
+#include "Arduino.h"
+#include <vector>
+
+class Ticker;
+inline std::vector<Ticker*>& host_ticker_list(void) { static std::vector<Ticker*> list; return list; }
+
+class Ticker {
+public:
+  void (*func)(void) = NULL;
+  unsigned long usec = 0;
+  unsigned long next = 0;
+  bool repeat = false;
+  void attach_ms(uint32_t ms, void (*f)(void), bool rep = true) {
+    detach();
+    usec = (ms > 0? ms: 1) * 1000UL;
+    next = micros() + usec;
+    func = f;
+    repeat = rep;
+    host_ticker_list().push_back(this);
+  }
+  void once_ms(uint32_t ms, void (*f)(void)) { attach_ms(ms, f, false); }
+  void detach(void) {
+    func = NULL;
+    std::vector<Ticker*>& list = host_ticker_list();
+    list.erase(std::remove(list.begin(), list.end(), this), list.end());
+  }
+  ~Ticker() { detach(); }
+};
+
+// run tickers due by now (call after advancing host_clock)
+inline void host_tickers(void) {
+  std::vector<Ticker*> list = host_ticker_list();
+  for (Ticker* t : list) {
+    while (t->func && (long)(micros() - t->next) >= 0) {
+      void (*f)(void) = t->func;
+      if (t->repeat) t->next += t->usec;
+      else t->detach();
+      f();
+    }
+  }
+}
+
+#endif
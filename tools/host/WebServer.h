@@ -0,0 +1,52 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// ホスト用のWebServer.h: 応答は最後の1件を保持（host_reply()）
+//  要求ヘッダは host_header() で与え、応答ヘッダと状態は host_sent()/host_status()
+////////////////////////////////////////////////////////////////////////////////
+#ifndef HOST_WEBSERVER_H
+#define HOST_WEBSERVER_H
+
+#include "Arduino.h"
+#include "WiFi.h"
+
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_POST };
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+
+inline std::string& host_reply(void) { static std::string s; return s; }
+inline std::string& host_header(void) { static std::string s; return s; }  // "If-None-Match" value
+inline std::string& host_sent(void) { static std::string s; return s; }    // "Name: value\n"...
+inline int& host_status(void) { static int code; return code; }
+inline std::string& host_uri(void) { static std::string s = "/"; return s; }
+
+class WebServer {
+public:
+  typedef void (*THandlerFunction)(void);
+  WebServer(int) {}
+  void on(const char*, HTTPMethod, THandlerFunction) {}
+  void on(const char*, THandlerFunction) {}
+  void onNotFound(THandlerFunction) {}
+  void begin(void) {}
+  void handleClient(void) {}
+  int args(void) { return 0; }
+  String arg(int) { return String(); }
+  String arg(const char*) { return String(); }
+  String argName(int) { return String(); }
+  String uri(void) { return String(host_uri().c_str()); }
+  bool hasArg(const char*) { return false; }
+  void collectHeaders(const char**, size_t) {}
+  String header(const char*) { return String(host_header().c_str()); }
+  String header(int) { return String(host_header().c_str()); }
+  bool hasHeader(const char*) { return !host_header().empty(); }
+  void sendHeader(const char* name, const char* value, bool = false) { host_sent() += std::string(name) + ": " + value + "\n"; }
+  void setContentLength(size_t) {}
+  void send(int code, const char* = NULL, const char* body = "") { host_status() = code; host_reply() = body; }
+  void send(int code, const char* type, const String& body) { send(code, type, body.c_str()); }
+  void send_P(int code, const char*, const char* body, size_t n) { host_status() = code; host_reply().assign(body, n); }
+  void sendContent(const char* s) { host_reply() += s; }
+  void sendContent(const char* s, size_t n) { host_reply().append(s, n); }
+};
+
+#endif
@@ -0,0 +1,45 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// ホスト用のWiFi.h: 何もしない（STA接続は host_wifi() の状態を返すだけ）
+////////////////////////////////////////////////////////////////////////////////
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include "Arduino.h"
+#include "WiFiClient.h"
+
+#define WIFI_OFF 0
+#define WIFI_STA 1
+#define WIFI_AP 2
+#define WL_CONNECTED 3
+#define WL_DISCONNECTED 6
+
+inline int& host_wifi(void) { static int status = WL_CONNECTED; return status; }
+
+class WiFiClass {
+public:
+  void mode(int) {}
+  bool softAP(const char*, const char* = NULL) { return true; }
+  bool softAPConfig(IPAddress, IPAddress, IPAddress) { return true; }
+  IPAddress softAPIP(void) { return IPAddress(192,168,4,1); }
+  void begin(void) {}
+  void begin(const char*, const char* = NULL) {}
+  void disconnect(void) {}
+  bool setSleep(bool) { return true; }
+  int status(void) { return host_wifi(); }
+  IPAddress broadcastIP(void) { return IPAddress(127,0,0,1); }
+};
+inline WiFiClass WiFi;
+
+class WiFiServer {
+public:
+  WiFiServer(int) {}
+  void begin(void) {}
+  void end(void) {}
+  WiFiClient available(void) { return WiFiClient(); }
+};
+
+#endif
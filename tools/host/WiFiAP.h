@@ -0,0 +1,13 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// ホスト用のWiFiAP.h: softAP() は WiFi.h にある
+////////////////////////////////////////////////////////////////////////////////
+#ifndef HOST_WIFIAP_H
+#define HOST_WIFIAP_H
+
+#include "WiFi.h"
+
+#endif
@@ -0,0 +1,21 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// ホスト用のWiFiClient.h: 書き込みは捨てる
+////////////////////////////////////////////////////////////////////////////////
+#ifndef HOST_WIFICLIENT_H
+#define HOST_WIFICLIENT_H
+
+#include "Arduino.h"
+
+class WiFiClient : public Stream {
+public:
+  size_t write(const uint8_t*, size_t n) override { return n; }
+  bool connected(void) { return false; }
+  void stop(void) {}
+  operator bool(void) { return false; }
+};
+
+#endif
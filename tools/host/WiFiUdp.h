@@ -0,0 +1,51 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// ホスト用のWiFiUdp.h: POSIXのUDPソケットで実際に送る（ループバックの試験用）
+//  host_udp_loss() [%] で送信パケットを捨てる（受信側の欠落検出の確認）
+////////////////////////////////////////////////////////////////////////////////
+#ifndef HOST_WIFIUDP_H
+#define HOST_WIFIUDP_H
+
+#include "Arduino.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <string>
+
+inline int& host_udp_loss(void) { static int loss = 0; return loss; }
+
+class WiFiUDP : public Stream {
+  int fd = -1;
+  sockaddr_in to = {};
+  std::string buf;
+public:
+  ~WiFiUDP() { stop(); }
+  uint8_t begin(uint16_t) { return 1; }
+  int beginPacket(IPAddress ip, uint16_t port) {
+    if (fd < 0) {
+      fd = socket(AF_INET, SOCK_DGRAM, 0);
+      int on = 1;
+      setsockopt(fd, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+    }
+    to.sin_family = AF_INET;
+    to.sin_port = htons(port);
+    to.sin_addr.s_addr = (uint32_t)ip;
+    buf.clear();
+    return fd >= 0;
+  }
+  size_t write(const uint8_t* b, size_t n) override { buf.append((const char*)b, n); return n; }
+  int endPacket(void) {
+    if (host_udp_loss() > 0 && rand() % 100 < host_udp_loss()) return 1;
+    return sendto(fd, buf.data(), buf.size(), 0, (sockaddr*)&to, sizeof(to)) == (ssize_t)buf.size();
+  }
+  void stop(void) {
+    if (fd >= 0) close(fd);
+    fd = -1;
+  }
+  int parsePacket(void) { return 0; }
+};
+
+#endif
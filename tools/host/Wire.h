@@ -0,0 +1,24 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// ホスト用のWire.h: 読み出しは0を返す
+////////////////////////////////////////////////////////////////////////////////
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include "Arduino.h"
+
+class TwoWire {
+public:
+  void begin(int = -1, int = -1, uint32_t = 0) {}
+  void beginTransmission(uint8_t) {}
+  uint8_t endTransmission(bool = true) { return 0; }
+  size_t write(uint8_t) { return 1; }
+  uint8_t requestFrom(uint8_t, uint8_t n) { return n; }
+  int read(void) { return 0; }
+};
+inline TwoWire Wire, Wire1;
+
+#endif
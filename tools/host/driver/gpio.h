@@ -0,0 +1,22 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// ホスト用のdriver/gpio.h: プルアップ/ダウンとスリープ復帰の設定は何もしない
+////////////////////////////////////////////////////////////////////////////////
+#ifndef HOST_DRIVER_GPIO_H
+#define HOST_DRIVER_GPIO_H
+
+typedef int gpio_num_t;
+#define GPIO_NUM_25 25
+#define GPIO_NUM_26 26
+#define GPIO_NUM_32 32
+#define GPIO_NUM_36 36
+typedef enum { GPIO_INTR_DISABLE = 0, GPIO_INTR_POSEDGE, GPIO_INTR_NEGEDGE, GPIO_INTR_ANYEDGE, GPIO_INTR_LOW_LEVEL, GPIO_INTR_HIGH_LEVEL } gpio_int_type_t;
+inline int gpio_pulldown_dis(gpio_num_t) { return 0; }
+inline int gpio_pullup_dis(gpio_num_t) { return 0; }
+inline int gpio_wakeup_enable(gpio_num_t, gpio_int_type_t) { return 0; }
+inline int gpio_wakeup_disable(gpio_num_t) { return 0; }
+
+#endif
@@ -0,0 +1,16 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// ホスト用のesp_freertos_hooks.h: ティックもアイドルもないのでフックは呼ばれない
+////////////////////////////////////////////////////////////////////////////////
+#ifndef HOST_ESP_FREERTOS_HOOKS_H
+#define HOST_ESP_FREERTOS_HOOKS_H
+
+#include "Arduino.h"
+
+typedef void (*esp_freertos_tick_cb_t)(void);
+inline int esp_register_freertos_tick_hook_for_cpu(esp_freertos_tick_cb_t, BaseType_t) { return 0; }
+
+#endif
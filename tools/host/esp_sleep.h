@@ -0,0 +1,18 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// ホスト用のesp_sleep.h: ライトスリープはタイマの時間だけ仮想時計を進める
+////////////////////////////////////////////////////////////////////////////////
+#ifndef HOST_ESP_SLEEP_H
+#define HOST_ESP_SLEEP_H
+
+#include "Arduino.h"
+
+inline uint64_t& host_sleep_us(void) { static uint64_t us = 0; return us; }
+inline int esp_sleep_enable_gpio_wakeup(void) { return 0; }
+inline int esp_sleep_enable_timer_wakeup(uint64_t us) { host_sleep_us() = us; return 0; }
+inline int esp_light_sleep_start(void) { host_clock() += host_sleep_us(); return 0; }
+
+#endif
@@ -0,0 +1,28 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// ホスト用のesp_timer.h: タイマは起動しない
+////////////////////////////////////////////////////////////////////////////////
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include "Arduino.h"
+
+#define ESP_OK 0
+typedef void* esp_timer_handle_t;
+typedef enum { ESP_TIMER_TASK } esp_timer_dispatch_t;
+typedef struct {
+  void (*callback)(void*);
+  void* arg;
+  esp_timer_dispatch_t dispatch_method;
+  const char* name;
+  bool skip_unhandled_events;
+} esp_timer_create_args_t;
+inline int esp_timer_create(const esp_timer_create_args_t*, esp_timer_handle_t* h) { *h = NULL; return ESP_OK; }
+inline int esp_timer_start_once(esp_timer_handle_t, uint64_t) { return ESP_OK; }
+inline int esp_timer_start_periodic(esp_timer_handle_t, uint64_t) { return ESP_OK; }
+inline int esp_timer_stop(esp_timer_handle_t) { return ESP_OK; }
+
+#endif
@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// notchbench: 自動ノッチ（VibrationFFT）で上げられるKDの余裕を閉ループで調べる
+//  GyroM5Core.hpp の ServoPID と GyroM5Atom.hpp の VibrationFFT を仮想時計（tools/host）で動かす
+//  車両: サーボ（1次遅れ20msec）→ ヨーレート（1次遅れ100msec）
+//  ジャイロ: ヨーレート + モータ振動（80→120Hzに掃引）+ シャシ共振（150Hz）+ 雑音
+//  評価（最初の3秒を除く）:
+//   CHATTER  サーボ出力の10Hz以上の成分のRMS[usec]（サーボの発熱と摩耗）
+//   TRACK    振動なしの同じ閉ループとのヨーレートの差のRMS[deg/sec]
+//  KD（設定画面の整数値）ごとに NOTCH=0（なし）と NOTCH=2（自動）を比べ、
+//  CHATTER が許容値以下になる最大のKDを表示（差がKDの余裕）
+//
+// build:
+//  g++ -O2 -std=c++17 -fno-strict-aliasing -Ihost -I../libraries/GyroM5Core/src -I../GyroM5Atom -o notchbench notchbench.cpp
+// usage:
+//  ./notchbench [-a AMP] [-l LIMIT] [-r HZ] [-p KP] [-g KG]
+//   -a: モータ振動の振幅[deg/sec]（既定8、共振はその半分）  -l: CHATTERの許容値（既定15usec）
+//   -r: 制御周期（既定400Hz）  -p/-g: KP/KG（設定画面の整数値、既定 50/50）
+////////////////////////////////////////////////////////////////////////////////
+#include "Arduino.h"
+#include "M5Atom.h"
+#include "GyroM5Atom.hpp"
+
+#include <unistd.h>
+#include <math.h>
+
+static const float SECONDS = 20.0F;
+static const float SETTLE = 3.0F;
+static const float CAR_GAIN = 0.5F;   // yaw rate per servo [deg/sec/usec]
+static const float TAU_SERVO = 0.02F;
+static const float TAU_YAW = 0.10F;
+
+struct Result {
+  float chatter;  // [usec]
+  float track;    // [deg/sec]
+  float notch[2]; // last notch centers [Hz]
+};
+
+static const int STEPS = 100000;
+
+// one closed loop run (yaw rate to trace, compared with ref if given)
+static Result simulate(int KD, int notch, float amp, float hz, int KP, int KG, const float* ref, float* trace) {
+  host_clock() = 0;
+  ServoPID PID;
+  PID.setup(KP/50.0, 10/250.0, KD/5000.0, 1000,1500,2000, hz);
+  PID.setTimer(true);
+  VibrationFFT* VIB = new VibrationFFT();
+  VIB->setup(notch);
+  float kg = KG/50.0 * 500./180.0;
+  float dt = 1.0F/hz;
+  int steps = SECONDS*hz;
+  float servo = 0.0F, yaw = 0.0F, out = 1500.0F;
+  float lp1 = 1500.0F, lp2 = 1500.0F;
+  double chatter = 0.0, track = 0.0;
+  int count = 0;
+  unsigned long seed = 12345;
+  for (int i=0; i<steps && i<STEPS; i++) {
+    float t = i*dt;
+    host_clock() = (unsigned long)(t*1e6);
+    // plant from the last output
+    servo += dt/(TAU_SERVO + dt)*((out - 1500.0F) - servo);
+    yaw += dt/(TAU_YAW + dt)*(CAR_GAIN*servo - yaw);
+    trace[i] = yaw;
+    // gyro with vibration (motor 80->120Hz, chassis 150Hz)
+    seed = seed*1103515245UL + 12345UL;
+    float noise = ((seed >> 16) & 0x7FFF)/32768.0F - 0.5F;
+    float gz = yaw + amp*sinf(2.0F*PI*(80.0F*t + 20.0F*t*t/SECONDS)) + 0.5F*amp*sinf(2.0F*PI*150.0F*t) + (amp > 0? 2.0F*noise: 0.0F);
+    // stick: slow sweep left/right
+    float ch1 = 1500.0F + 300.0F*sinf(2.0F*PI*0.4F*t);
+    float pv = VIB->loop(gz);
+    VIB->analyze();
+    out = PID.loop(ch1, -kg*pv);
+    // chatter: output minus 2nd order 10Hz low pass
+    float a = dt/(1.0F/(2.0F*PI*10.0F) + dt);
+    lp1 += a*(out - lp1);
+    lp2 += a*(lp1 - lp2);
+    if (t >= SETTLE) {
+      chatter += (out - lp2)*(out - lp2);
+      if (ref) track += (trace[i] - ref[i])*(trace[i] - ref[i]);
+      count++;
+    }
+  }
+  Result R;
+  R.chatter = sqrt(chatter/count);
+  R.track = sqrt(track/count);
+  R.notch[0] = VIB->getNotch(0);
+  R.notch[1] = VIB->getNotch(1);
+  delete VIB;
+  return R;
+}
+
+int main(int argc, char** argv) {
+  float amp = 8.0F, limit = 15.0F, hz = 400.0F;
+  int KP = 50, KG = 50;
+  int c;
+  while ((c = getopt(argc, argv, "a:l:r:p:g:")) != -1) {
+    switch (c) {
+      case 'a': amp = atof(optarg); break;
+      case 'l': limit = atof(optarg); break;
+      case 'r': hz = atof(optarg); break;
+      case 'p': KP = atoi(optarg); break;
+      case 'g': KG = atoi(optarg); break;
+      default:
+        fprintf(stderr, "usage: %s [-a AMP] [-l LIMIT] [-r HZ] [-p KP] [-g KG]\n", argv[0]);
+        return 1;
+    }
+  }
+  printf("amp=%.1fdeg/sec limit=%.1fusec rate=%.0fHz KP=%d KG=%d\n", amp, limit, hz, KP, KG);
+  printf("%4s %12s %12s %12s %12s %12s\n", "KD", "chatter_off", "chatter_on", "track_off", "track_on", "notch_Hz");
+  static float ref[STEPS], trace[STEPS];
+  int best[2] = {-1, -1};
+  for (int KD=0; KD<=100; KD+=5) {
+    simulate(KD, 0, 0.0F, hz, KP, KG, NULL, ref);
+    Result off = simulate(KD, 0, amp, hz, KP, KG, ref, trace);
+    Result on = simulate(KD, 2, amp, hz, KP, KG, ref, trace);
+    printf("%4d %12.1f %12.1f %12.2f %12.2f %6.1f/%5.1f\n", KD, off.chatter, on.chatter, off.track, on.track, on.notch[0], on.notch[1]);
+    if (off.chatter <= limit) best[0] = KD;
+    if (on.chatter <= limit) best[1] = KD;
+  }
+  printf("max KD within limit: off=%d auto=%d\n", best[0], best[1]);
+  return 0;
+}
@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// pidbench: PIDEngine.hpp のホスト用ベンチマークと QuickPID との比較
+//  同じ入力列（目標値のステップ/正弦波、1次遅れの車両モデル、雑音）で
+//  QuickPID (float) と PIDEngine (float, Q16, Q15) の出力を比べる
+//  出力: 最大誤差[usec]、RMSE[usec]、1回あたりの計算時間[nsec]
+//
+// build (QuickPID のソースを指定、ホスト用 Arduino.h は tools/host):
+//  g++ -O2 -std=c++17 -Ihost -I../libraries/GyroM5Core/src -I$QUICKPID/src -o pidbench pidbench.cpp $QUICKPID/src/QuickPID.cpp
+// build (QuickPID なし、ベンチマークのみ):
+//  g++ -O2 -std=c++11 -DNO_QUICKPID -I../libraries/GyroM5Core/src -o pidbench pidbench.cpp
+// usage:
+//  ./pidbench [KP KI KD Hz]   (整数ゲインは設定画面と同じ、既定 50 30 10 400)
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include "PIDEngine.hpp"
+#ifndef NO_QUICKPID
+#include "Arduino.h"
+#include "QuickPID.h"
+#endif
+
+static const int STEPS = 20000;
+static const int LOOPS = 50;
+static const float MIN = -500.0F, MAX = 500.0F;
+
+// test signals: setpoint and measurement noise (fixed seed)
+struct Signal {
+  float sp[STEPS];
+  float noise[STEPS];
+  Signal(float dt) {
+    unsigned long seed = 12345;
+    for (int i=0; i<STEPS; i++) {
+      float t = i*dt;
+      float step = ((i/(STEPS/8))%2? 300.0F: -200.0F);
+      sp[i] = step + 100.0F*sinf(2.0F*3.14159F*1.5F*t);
+      seed = seed*1103515245UL + 12345UL;
+      noise[i] = ((seed >> 16) & 0x7FFF)/32768.0F*20.0F - 10.0F;
+    }
+  }
+};
+
+// plant: yaw rate (in usec) follows output by 1st order lag
+struct Plant {
+  float y, a;
+  Plant(float dt, float tau=0.08F) : y(0.0F), a(dt/(tau+dt)) {}
+  float step(float u) { y += a*(0.9F*u - y); return y; }
+};
+
+// run PIDEngine<T> in closed loop
+template <class T>
+static void runEngine(const Signal& S, float Kp, float Ki, float Kd, float dt, float* out) {
+  PIDEngine<T,PID_AW_CLAMP,PID_D_MEAS> pid;
+  pid.setLimits(MIN,MAX);
+  pid.setTunings(Kp,Ki,Kd,dt);
+  Plant P(dt);
+  float y = 0.0F;
+  for (int i=0; i<STEPS; i++) {
+    out[i] = (float)pid.compute(T(S.sp[i]), T(y + S.noise[i]));
+    y = P.step(out[i]);
+  }
+}
+
+#ifndef NO_QUICKPID
+// run QuickPID in closed loop with virtual clock
+static void runQuick(const Signal& S, float Kp, float Ki, float Kd, float dt, float* out) {
+  float Setpoint = 0.0F, Input = 0.0F, Output = 0.0F;
+  unsigned long us = (unsigned long)(dt*1000000 + 0.5F);
+  host_clock() = 0;
+  QuickPID pid(&Input, &Output, &Setpoint, Kp,Ki,Kd, QuickPID::Action::direct);
+  pid.SetAntiWindupMode(QuickPID::iAwMode::iAwClamp);
+  pid.SetOutputLimits(MIN,MAX);
+  pid.SetSampleTimeUs(us);
+  pid.SetTunings(Kp,Ki,Kd);
+  pid.SetMode(QuickPID::Control::automatic);
+  Plant P(dt);
+  float y = 0.0F;
+  for (int i=0; i<STEPS; i++) {
+    host_clock() += us;
+    Setpoint = S.sp[i];
+    Input = y + S.noise[i];
+    pid.Compute();
+    out[i] = Output;
+    y = P.step(out[i]);
+  }
+}
+#endif
+
+// time of compute() in open loop
+template <class T>
+static double benchEngine(const Signal& S, float Kp, float Ki, float Kd, float dt) {
+  PIDEngine<T,PID_AW_CLAMP,PID_D_MEAS> pid;
+  pid.setLimits(MIN,MAX);
+  pid.setTunings(Kp,Ki,Kd,dt);
+  volatile float sink = 0.0F;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int n=0; n<LOOPS; n++)
+    for (int i=0; i<STEPS; i++) sink = (float)pid.compute(T(S.sp[i]), T(S.noise[i]));
+  auto t1 = std::chrono::steady_clock::now();
+  (void)sink;
+  return std::chrono::duration<double,std::nano>(t1 - t0).count() / (double(LOOPS)*STEPS);
+}
+
+#ifndef NO_QUICKPID
+static double benchQuick(const Signal& S, float Kp, float Ki, float Kd, float dt) {
+  float Setpoint = 0.0F, Input = 0.0F, Output = 0.0F;
+  QuickPID pid(&Input, &Output, &Setpoint, Kp,Ki,Kd, QuickPID::Action::direct);
+  pid.SetAntiWindupMode(QuickPID::iAwMode::iAwClamp);
+  pid.SetOutputLimits(MIN,MAX);
+  pid.SetSampleTimeUs((unsigned long)(dt*1000000 + 0.5F));
+  pid.SetTunings(Kp,Ki,Kd);
+  pid.SetMode(QuickPID::Control::timer);
+  volatile float sink = 0.0F;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int n=0; n<LOOPS; n++)
+    for (int i=0; i<STEPS; i++) {
+      Setpoint = S.sp[i];
+      Input = S.noise[i];
+      pid.Compute();
+      sink = Output;
+    }
+  auto t1 = std::chrono::steady_clock::now();
+  (void)sink;
+  return std::chrono::duration<double,std::nano>(t1 - t0).count() / (double(LOOPS)*STEPS);
+}
+#endif
+
+// max abs diff and RMSE against reference
+static void compare(const float* ref, const float* out, float& maxd, float& rmse) {
+  double sum = 0.0;
+  maxd = 0.0F;
+  for (int i=0; i<STEPS; i++) {
+    float d = fabsf(out[i] - ref[i]);
+    if (d > maxd) maxd = d;
+    sum += double(d)*d;
+  }
+  rmse = (float)sqrt(sum/STEPS);
+}
+
+static float REF[STEPS], OUT[STEPS];
+
+template <class T>
+static bool report(const char* name, const Signal& S, float Kp, float Ki, float Kd, float dt, bool golden, float tol) {
+  float maxd = 0.0F, rmse = 0.0F;
+  runEngine<T>(S,Kp,Ki,Kd,dt,OUT);
+  if (golden) compare(REF,OUT,maxd,rmse);
+  double ns = benchEngine<T>(S,Kp,Ki,Kd,dt);
+  bool ok = !golden || maxd <= tol;
+  if (golden) printf("%-12s %10.4f %10.4f %10.1f %s\n", name, maxd, rmse, ns, ok? "ok": "NG");
+  else printf("%-12s %10s %10s %10.1f\n", name, "-", "-", ns);
+  return ok;
+}
+
+int main(int argc, char** argv) {
+  // integer gains as CONFIG (GyroM5Atom.ino: CNF_KP, CNF_KI, CNF_KD)
+  int KP = (argc > 1? atoi(argv[1]): 50);
+  int KI = (argc > 2? atoi(argv[2]): 30);
+  int KD = (argc > 3? atoi(argv[3]): 10);
+  int HZ = (argc > 4? atoi(argv[4]): 400);
+  if (HZ < 50) HZ = 50;
+  float Kp = KP/50.0F, Ki = KI/250.0F, Kd = KD/5000.0F;
+  float dt = 1.0F/HZ;
+  Signal S(dt);
+
+  printf("# KP=%d KI=%d KD=%d Hz=%d steps=%d\n", KP, KI, KD, HZ, STEPS);
+  printf("%-12s %10s %10s %10s\n", "engine", "max[us]", "rmse[us]", "ns/call");
+  bool ok = true;
+#ifndef NO_QUICKPID
+  runQuick(S,Kp,Ki,Kd,dt,REF);
+  printf("%-12s %10.4f %10.4f %10.1f\n", "QuickPID", 0.0, 0.0, benchQuick(S,Kp,Ki,Kd,dt));
+  const bool golden = true;
+#else
+  const bool golden = false;
+#endif
+  // float must follow QuickPID, fixed point within 1 usec of servo pulse
+  ok &= report<float>("PID<float>", S,Kp,Ki,Kd,dt, golden, 0.01F);
+  ok &= report<Q16>("PID<Q16>", S,Kp,Ki,Kd,dt, golden, 1.0F);
+  ok &= report<Q15>("PID<Q15>", S,Kp,Ki,Kd,dt, golden, 1.0F);
+  return ok? 0: 2;
+}
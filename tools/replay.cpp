@@ -0,0 +1,355 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// replay: 記録した走行ログを GyroM5Atom.ino の control() で再計算する
+//  仮想時計（tools/host）で PulsePort/M5StackAHRS/ServoPID を実機と同じ順に動かす
+//  入力ログ（CSV、1行が1周期）:
+//   USEC,CH1,GX,GY,GZ,AX,AY,AZ[,SRV]  生データ（usec, usec, o/s, G, usec）
+//   GyroM5Stick の /csv                SEC,CH1,SRV,YAW（10Hz、1msに補間して再生）
+//  出力:
+//   DIR/<log>.trace.csv  USEC,CH1,RATE,ROLL,SRV,OUT,NS（NSは1周期の計算時間）
+//   標準出力              ファイルごとの比較（基準のSRVとの最大誤差、RMSE、計算時間）
+//  基準: -b DIR の同名トレース（別ビルドの出力）、なければログのSRV列
+//  ファイルごとに別プロセスで並列実行（スケッチのクラスは静的メンバで状態を持つため）
+//
+// build (A/B は -I で別ツリーの libraries/GyroM5Core/src と GyroM5Atom を指定して2つ作る):
+//  g++ -O2 -std=c++17 -fno-strict-aliasing -Ihost -I../libraries/GyroM5Core/src -I../GyroM5Atom -o replay replay.cpp
+// usage:
+//  ./replay [-j N] [-o DIR] [-b DIR] [-r HZ] [-c KEY=VAL]... log.csv...
+//   -j: 並列数（既定はCPU数）  -o: トレース出力先  -b: 基準トレース
+//   -r: 受信機のフレーム周波数（既定50Hz）  -c: CONFIGの変更（例 -c KP=60）
+////////////////////////////////////////////////////////////////////////////////
+#include "GyroM5Atom.ino"
+
+#include <unistd.h>
+#include <sys/wait.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// one control tick of log
+struct Sample {
+  unsigned long usec;
+  float ch1;
+  float gyro[3];
+  float accl[3];
+  float srv;
+};
+
+struct Log {
+  std::vector<Sample> rows;
+  std::vector<std::pair<std::string,int>> conf;
+  bool hasSrv = false;
+};
+
+// split CSV line into fields
+static int split(char* line, char** f, int max) {
+  int n = 0;
+  char* p = line;
+  while (n < max) {
+    f[n++] = p;
+    p = strchr(p, ',');
+    if (!p) break;
+    *p++ = '\0';
+  }
+  for (int i=0; i<n; i++) f[i][strcspn(f[i], "\r\n")] = '\0';
+  return n;
+}
+static int column(char** f, int n, const char* name) {
+  for (int i=0; i<n; i++) if (strcmp(f[i], name)==0) return i;
+  return -1;
+}
+
+// raw log: USEC,CH1,GX,GY,GZ,AX,AY,AZ[,SRV]
+static bool loadRaw(FILE* fp, char* head, Log& log) {
+  char* f[32];
+  int n = split(head, f, 32);
+  const char* names[] = {"USEC","CH1","GX","GY","GZ","AX","AY","AZ"};
+  int col[8];
+  for (int k=0; k<8; k++) if ((col[k] = column(f, n, names[k])) < 0) return false;
+  int srv = column(f, n, "SRV");
+  log.hasSrv = (srv >= 0);
+  char line[1024];
+  while (fgets(line, sizeof(line), fp)) {
+    int m = split(line, f, 32);
+    if (m < n) continue;
+    Sample s;
+    s.usec = strtoul(f[col[0]], NULL, 10);
+    s.ch1 = atof(f[col[1]]);
+    for (int i=0; i<3; i++) s.gyro[i] = atof(f[col[2+i]]);
+    for (int i=0; i<3; i++) s.accl[i] = atof(f[col[5+i]]);
+    s.srv = (srv >= 0? atof(f[srv]): 0.0F);
+    if (!log.rows.empty() && s.usec <= log.rows.back().usec) continue;
+    log.rows.push_back(s);
+  }
+  return !log.rows.empty();
+}
+
+// GyroM5Stick /csv: KEYS, CONFIG, SEC,CH1,SRV,YAW (relative to neutral, YAW = Kg*yawrate)
+static bool loadStick(FILE* fp, char* keys, Log& log) {
+  char vals[1024], head[1024], line[1024];
+  char *k[32], *v[32], *f[8];
+  if (!fgets(vals, sizeof(vals), fp) || !fgets(head, sizeof(head), fp)) return false;
+  int nk = split(keys, k, 32);
+  int nv = split(vals, v, 32);
+  int KG = 50, REV = 0, MEAN = 1500;
+  for (int i=0; i<nk && i<nv; i++) {
+    int val = atoi(v[i]);
+    if (strcmp(k[i],"KG")==0) KG = val;
+    if (strcmp(k[i],"CH1")==0) REV = val;
+    // Stick names to GyroM5Atom CONFIG
+    const char* key = (strcmp(k[i],"CH1")==0? "REV": strcmp(k[i],"PWM")==0? "FREQ": k[i]);
+    if (strcmp(key,"CH3")!=0 && strcmp(key,"END")!=0) log.conf.push_back(std::make_pair(std::string(key),val));
+  }
+  if (split(head, f, 8) < 4 || strcmp(f[0],"SEC")!=0) return false;
+  float Kg = (KG != 0? KG/20.0F: 1.0F) * (REV? -1.0F: 1.0F);
+  std::vector<Sample> raw;
+  while (fgets(line, sizeof(line), fp)) {
+    if (split(line, f, 8) < 4) continue;
+    Sample s;
+    s.usec = (unsigned long)(atof(f[0])*1000000 + 0.5);
+    s.ch1 = MEAN + atof(f[1]);
+    s.srv = MEAN + atof(f[2]);
+    s.gyro[0] = s.gyro[1] = 0.0F;
+    s.gyro[2] = atof(f[3]) / Kg;
+    s.accl[0] = s.accl[1] = 0.0F;
+    s.accl[2] = 1.0F;
+    raw.push_back(s);
+  }
+  // interpolate 10Hz to 1kHz
+  for (size_t i=0; i+1<raw.size(); i++) {
+    const Sample& a = raw[i];
+    const Sample& b = raw[i+1];
+    for (unsigned long t=a.usec; t<b.usec; t+=1000) {
+      float w = float(t - a.usec)/(b.usec - a.usec);
+      Sample s = a;
+      s.usec = t;
+      s.ch1 = a.ch1 + w*(b.ch1 - a.ch1);
+      s.srv = a.srv + w*(b.srv - a.srv);
+      s.gyro[2] = a.gyro[2] + w*(b.gyro[2] - a.gyro[2]);
+      log.rows.push_back(s);
+    }
+  }
+  log.hasSrv = true;
+  return !log.rows.empty();
+}
+
+static bool loadLog(const char* path, Log& log) {
+  FILE* fp = fopen(path, "r");
+  if (!fp) return false;
+  char head[1024];
+  bool ok = false;
+  if (fgets(head, sizeof(head), fp)) {
+    if (strncmp(head, "USEC", 4)==0) ok = loadRaw(fp, head, log);
+    else if (strncmp(head, "KG", 2)==0) ok = loadStick(fp, head, log);
+  }
+  fclose(fp);
+  return ok;
+}
+
+// trace column SRV of file written by other build
+static bool loadTrace(const std::string& path, std::vector<float>& srv) {
+  FILE* fp = fopen(path.c_str(), "r");
+  if (!fp) return false;
+  char line[1024];
+  char* f[16];
+  int col = -1;
+  if (fgets(line, sizeof(line), fp)) col = column(f, split(line, f, 16), "SRV");
+  while (col >= 0 && fgets(line, sizeof(line), fp)) {
+    if (split(line, f, 16) > col) srv.push_back(atof(f[col]));
+  }
+  fclose(fp);
+  return col >= 0;
+}
+
+static std::string baseName(const char* path) {
+  std::string s(path);
+  size_t p = s.find_last_of('/');
+  if (p != std::string::npos) s = s.substr(p+1);
+  p = s.find_last_of('.');
+  if (p != std::string::npos) s = s.substr(0, p);
+  return s;
+}
+
+
+struct Options {
+  int jobs = 0;
+  int rxHz = 50;
+  const char* outDir = NULL;
+  const char* baseDir = NULL;
+  std::vector<std::pair<std::string,int>> conf;
+};
+
+// replay one log in this process, print one result line
+static int replay(const char* path, const Options& opt, FILE* res) {
+  Log log;
+  if (!loadLog(path, log)) {
+    fprintf(res, "%s,error,cannot read log\n", path);
+    return 1;
+  }
+
+  // CONFIG: defaults, log, command line (saved for setup())
+  WWW.CONF.init();
+  for (auto& kv : log.conf) WWW.CONF.setCONF(kv.first.c_str(), kv.second);
+  for (auto& kv : opt.conf) WWW.CONF.setCONF(kv.first.c_str(), kv.second);
+  WWW.CONF.save();
+
+  // boot with the first IMU sample as still
+  const Sample& s0 = log.rows[0];
+  for (int i=0; i<3; i++) host_imu().gyro[i] = s0.gyro[i];
+  for (int i=0; i<3; i++) host_imu().accl[i] = s0.accl[i];
+  setup();
+
+  // trace file
+  std::string name = baseName(path);
+  FILE* out = NULL;
+  if (opt.outDir) {
+    out = fopen((std::string(opt.outDir) + "/" + name + ".trace.csv").c_str(), "w");
+    if (out) fprintf(out, "USEC,CH1,RATE,ROLL,SRV,OUT,NS\n");
+  }
+
+  // CH1 pulses at receiver frame rate, width from the log
+  const int pin = GRV_PIN[0];
+  const unsigned long frame = 1000000UL / (opt.rxHz > 0? opt.rxHz: 50);
+  const unsigned long t0 = micros() - s0.usec;
+  unsigned long rise = micros();
+  unsigned long fall = 0;
+  bool high = false;
+
+  std::vector<float> srv;
+  srv.reserve(log.rows.size());
+  double nsSum = 0.0, nsMax = 0.0;
+  auto w0 = std::chrono::steady_clock::now();
+  for (const Sample& s : log.rows) {
+    unsigned long now = t0 + s.usec;
+    // edges due by now
+    while (true) {
+      if (high && fall <= now) {
+        host_clock() = fall;
+        host_edge(pin, LOW);
+        host_tickers();
+        high = false;
+      } else
+      if (!high && rise <= now) {
+        int width = (int)s.ch1;
+        if (width > 0) {
+          host_clock() = rise;
+          host_edge(pin, HIGH);
+          host_tickers();
+          fall = rise + width;
+          high = true;
+        }
+        rise += frame;
+      } else break;
+    }
+    host_clock() = now;
+    host_tickers();
+    for (int i=0; i<3; i++) host_imu().gyro[i] = s.gyro[i];
+    for (int i=0; i<3; i++) host_imu().accl[i] = s.accl[i];
+
+    auto c0 = std::chrono::steady_clock::now();
+    control();
+    auto c1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double,std::nano>(c1 - c0).count();
+    nsSum += ns;
+    if (ns > nsMax) nsMax = ns;
+
+    float duty = host_duty(PulsePort::CH2PWM(0));
+    float usec = duty * (1000000.0F/PWM_FREQ) / 65536.0F;
+    // no receiver input yet (boot) is not compared
+    srv.push_back(CH1_USEC > 0? PID_USEC: NAN);
+    if (out) fprintf(out, "%lu,%.0f,%.3f,%.3f,%.9g,%.9g,%.0f\n", s.usec, CH1_USEC, IMU_RATE, IMU_ROLL, PID_USEC, usec, ns);
+  }
+  auto w1 = std::chrono::steady_clock::now();
+  if (out) fclose(out);
+
+  // reference: baseline trace or SRV recorded in log
+  std::vector<float> ref;
+  const char* refName = "-";
+  if (opt.baseDir && loadTrace(std::string(opt.baseDir) + "/" + name + ".trace.csv", ref)) refName = "base";
+  else if (log.hasSrv) {
+    for (const Sample& s : log.rows) ref.push_back(s.srv);
+    refName = "log";
+  }
+  double maxd = 0.0, sum = 0.0;
+  size_t n = min(ref.size(), srv.size());
+  size_t m = 0;
+  for (size_t i=0; i<n; i++) {
+    if (isnan(srv[i])) continue;
+    double d = fabs(srv[i] - ref[i]);
+    m++;
+    if (d > maxd) maxd = d;
+    sum += d*d;
+  }
+  double sec = (log.rows.back().usec - s0.usec) / 1e6;
+  double wall = std::chrono::duration<double>(w1 - w0).count();
+  fprintf(res, "%s,%zu,%.1f,%s,%.2f,%.3f,%.0f,%.0f,%.0f\n", name.c_str(), log.rows.size(), sec, refName,
+    maxd, (m? sqrt(sum/m): 0.0), nsSum/log.rows.size(), nsMax, (wall > 0? sec/wall: 0.0));
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  Options opt;
+  int c;
+  while ((c = getopt(argc, argv, "j:o:b:r:c:")) != -1) {
+    switch (c) {
+      case 'j': opt.jobs = atoi(optarg); break;
+      case 'o': opt.outDir = optarg; break;
+      case 'b': opt.baseDir = optarg; break;
+      case 'r': opt.rxHz = atoi(optarg); break;
+      case 'c': {
+        const char* eq = strchr(optarg, '=');
+        if (eq) opt.conf.push_back(std::make_pair(std::string(optarg, eq - optarg), atoi(eq+1)));
+        break;
+      }
+      default:
+        fprintf(stderr, "usage: %s [-j N] [-o DIR] [-b DIR] [-r HZ] [-c KEY=VAL]... log.csv...\n", argv[0]);
+        return 1;
+    }
+  }
+  int files = argc - optind;
+  if (files <= 0) {
+    fprintf(stderr, "no log files\n");
+    return 1;
+  }
+  if (opt.jobs <= 0) opt.jobs = max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+
+  // one process per file, results back through pipes in file order
+  std::vector<FILE*> pipes(files, (FILE*)NULL);
+  std::vector<pid_t> pids(files, (pid_t)0);
+  int running = 0, next = 0, done = 0, fails = 0;
+  printf("log,ticks,sec,ref,max_us,rmse_us,ns_mean,ns_max,x_realtime\n");
+  while (done < files) {
+    while (running < opt.jobs && next < files) {
+      int fd[2];
+      if (pipe(fd) != 0) return 1;
+      fflush(stdout);
+      pid_t pid = fork();
+      if (pid == 0) {
+        close(fd[0]);
+        FILE* res = fdopen(fd[1], "w");
+        int rc = replay(argv[optind+next], opt, res);
+        fclose(res);
+        _exit(rc);
+      }
+      close(fd[1]);
+      pipes[next] = fdopen(fd[0], "r");
+      pids[next] = pid;
+      running++;
+      next++;
+    }
+    // collect the oldest one to keep output in order
+    char line[1024] = "";
+    if (!fgets(line, sizeof(line), pipes[done])) snprintf(line, sizeof(line), "%s,error,worker died\n", argv[optind+done]);
+    fclose(pipes[done]);
+    int status = 0;
+    waitpid(pids[done], &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) fails++;
+    fputs(line, stdout);
+    running--;
+    done++;
+  }
+  return fails? 2: 0;
+}
@@ -0,0 +1,59 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// rxdecode: 記録したシリアル受信機のバイト列をホストで復号する
+//  (RxDecoder.hpp の確認用、ロジックアナライザ等で記録した生バイト列を入力)
+//
+// build:
+//  g++ -O2 -std=c++11 -I../GyroM5Atom -o rxdecode rxdecode.cpp
+// usage:
+//  ./rxdecode sbus|ibus|crsf capture.bin > frames.csv
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+#include "RxDecoder.hpp"
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s sbus|ibus|crsf capture.bin\n", argv[0]);
+    return 1;
+  }
+  int proto = RxDecoder::NONE;
+  if (strcmp(argv[1],"sbus")==0) proto = RxDecoder::SBUS;
+  else if (strcmp(argv[1],"ibus")==0) proto = RxDecoder::IBUS;
+  else if (strcmp(argv[1],"crsf")==0) proto = RxDecoder::CRSF;
+  else {
+    fprintf(stderr, "unknown protocol: %s\n", argv[1]);
+    return 1;
+  }
+  FILE* fp = (strcmp(argv[2],"-")==0? stdin: fopen(argv[2],"rb"));
+  if (!fp) {
+    perror(argv[2]);
+    return 1;
+  }
+
+  RxDecoder DEC;
+  DEC.setup(proto);
+  long offset = 0;
+  bool head = true;
+  int c;
+  while ((c = fgetc(fp)) != EOF) {
+    if (DEC.put((uint8_t)c)) {
+      if (head) {
+        printf("BYTE,FS");
+        for (int ch=0; ch<DEC.getChannels(); ch++) printf(",CH%d", ch+1);
+        printf("\n");
+        head = false;
+      }
+      printf("%ld,%d", offset, DEC.isFailsafe()? 1: 0);
+      for (int ch=0; ch<DEC.getChannels(); ch++) printf(",%d", DEC.getUsec(ch));
+      printf("\n");
+    }
+    offset++;
+  }
+  if (fp != stdin) fclose(fp);
+  fprintf(stderr, "frames=%lu errors=%lu bytes=%ld\n", DEC.getFrames(), DEC.getErrors(), offset);
+  return 0;
+}
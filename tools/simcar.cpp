@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// simcar: テレメトリ送信の模擬車両（collector のループバック試験用）
+//  GyroM5Atom.hpp の TelemetryTx をそのまま使い、合成した走行データを実時間で送る
+//  仮想時計（tools/host）を実時間に合わせて進める（-s で起動時刻、-d で水晶の誤差）
+//  車載タスクの代わりに10msecごとに flush() を呼ぶ
+//  終了時に put()/flush() の1回の時間（平均と最大）を表示（車載の負荷の目安）
+//
+// build:
+//  g++ -O2 -std=c++17 -fno-strict-aliasing -Ihost -I../libraries/GyroM5Core/src -I../GyroM5Atom -o simcar simcar.cpp
+// usage:
+//  ./simcar [-c ID] [-r HZ] [-t SEC] [-l LOSS%] [-s USEC] [-d PPM] [-p PORT]
+//   -c: 車両ID（既定1）  -r: 制御周期（既定400Hz）  -t: 送信時間（既定10秒）
+//   -l: 送信パケットを捨てる割合  -s: 車載時計の初期値（4294000000 で一巡を試す）
+//  例: ./collector -t 12 -o /tmp/tlm & ./simcar -c 1 & ./simcar -c 2 -l 5 -d 40; wait
+////////////////////////////////////////////////////////////////////////////////
+#include "Arduino.h"
+#include "M5Atom.h"
+#include "GyroM5Atom.hpp"
+
+#include <unistd.h>
+#include <math.h>
+#include <chrono>
+#include <thread>
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsedNs(Clock::time_point t0) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+}
+
+struct Cost {
+  double sum = 0, worst = 0;
+  long count = 0;
+  void put(double ns) { sum += ns; count++; if (ns > worst) worst = ns; }
+};
+
+int main(int argc, char** argv) {
+  uint32_t car = 1;
+  double hz = 400, seconds = 10, ppm = 0;
+  unsigned long start = 0;
+  int port = TELEMETRY_PORT;
+  int c;
+  while ((c = getopt(argc, argv, "c:r:t:l:s:d:p:")) != -1) {
+    switch (c) {
+      case 'c': car = strtoul(optarg, NULL, 0); break;
+      case 'r': hz = atof(optarg); break;
+      case 't': seconds = atof(optarg); break;
+      case 'l': host_udp_loss() = atoi(optarg); break;
+      case 's': start = strtoul(optarg, NULL, 0); break;
+      case 'd': ppm = atof(optarg); break;
+      case 'p': port = atoi(optarg); break;
+      default:
+        fprintf(stderr, "usage: %s [-c ID] [-r HZ] [-t SEC] [-l LOSS%%] [-s USEC] [-d PPM] [-p PORT]\n", argv[0]);
+        return 1;
+    }
+  }
+  if (hz <= 0) return 1;
+
+  static TelemetryTx TLM;
+  host_clock() = start;
+  TLM.setup(1, IPAddress(127,0,0,1), car, port);
+
+  Cost put, flush;
+  long steps = 0;
+  Clock::time_point t0 = Clock::now();
+  Clock::time_point next = t0;
+  double lastFlush = 0;
+  while (elapsedNs(t0) < seconds*1e9) {
+    next += std::chrono::nanoseconds((long)(1e9/hz));
+    std::this_thread::sleep_until(next);
+    double t = elapsedNs(t0)/1e9;
+    host_clock() = start + (unsigned long)(t*(1.0 + ppm*1e-6)*1e6);
+    // figure eight with counter steer (car id shifts the phase)
+    double ph = 2*M_PI*(t/4.0 + car*0.1);
+    TelemetrySample S;
+    S.time = micros();
+    S.ch1 = 1500 + 400*sin(ph);
+    S.rate = 10*(120*sin(ph - 0.3));
+    S.out = constrain(S.ch1 - 0.8*S.rate/10, 1000, 2000);
+    S.roll = 100*(3*sin(ph - 0.5));
+    S.pitch = 100*(1*cos(2*ph));
+    S.slip = 100*(25*sin(ph - 0.6));
+    S.loop = hz;
+    S.flags = (steps % (int)std::max(1.0, hz/50) == 0? TELEMETRY_EDGE: 0);
+    Clock::time_point a = Clock::now();
+    TLM.put(S);
+    put.put(elapsedNs(a));
+    steps++;
+    // the core-0 task of the car
+    if (t - lastFlush >= 0.01) {
+      lastFlush = t;
+      a = Clock::now();
+      TLM.flush();
+      flush.put(elapsedNs(a));
+    }
+  }
+  TLM.flush(true);
+  TLM.stop();
+  printf("simcar %08x: %ld samples, dropped=%u\n", car, steps, (unsigned)TLM.getDropped());
+  printf(" put:   avg %.0f ns, max %.0f ns\n", put.sum/std::max(1L, put.count), put.worst);
+  printf(" flush: avg %.1f usec, max %.1f usec (%ld calls)\n", flush.sum/std::max(1L, flush.count)/1e3, flush.worst/1e3, flush.count);
+  return 0;
+}
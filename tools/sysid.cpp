@@ -0,0 +1,333 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// sysid: 走行ログからステアリング→ヨーレートのモデルを同定してゲインを提案する
+//  モデル: 1次遅れ+むだ時間 (FOPDT)  w(s) = K exp(-L s) / (T s + 1) u(s)
+//   u: サーボ出力[usec]（中立から）、w: ヨーレート[o/s]
+//  1) むだ時間Lごとに ARX  w[k] = a w[k-1] + b u[k-1-d] + c  を最小二乗（式誤差で選択）
+//  2) ARXの時定数を初期値にLとTを探索して出力誤差（シミュレーション誤差）を最小化
+//  提案ゲイン: スティック全開で最大ヨーレートの80%を目標とするKG、
+//   IMC-PID（閉ループ時定数 = L）の KP/KI/KD（設定画面の整数値、0-100）
+//  入力: GyroM5Stick の /csv（SEC,CH1,SRV,YAW）、replay のトレース（USEC,RATE,SRV）
+//        または生ログ（USEC,GZ,SRV）
+//  （ARXはファイルとむだ時間の組ごと、出力誤差はファイルごとにスレッドで並列に計算）
+//
+// build:
+//  g++ -O2 -std=c++11 -pthread -o sysid sysid.cpp
+// usage:
+//  ./sysid [-j N] [-a] [-l MAXMS] data.csv...
+//   -j: スレッド数（既定はCPU数）  -a: KGをGyroM5Atomの尺度で表示（既定はStick）
+//   -l: むだ時間の探索範囲[msec]（既定300）
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Series {
+  std::string name;
+  double dt = 0.0;       // sampling time [sec]
+  std::vector<double> u; // servo [usec] from neutral
+  std::vector<double> w; // yaw rate [o/s]
+  std::string error;
+};
+
+struct Fit {
+  double K = 0.0, T = 0.0, L = 0.0, fit = -1e9;
+  double c = 0.0, sse = 1e300; // offset and equation error (ARX)
+};
+
+struct Result {
+  std::vector<Fit> arx; // by dead time
+  Fit best;             // ARX best
+  Fit fopdt;            // refined
+};
+
+
+// split CSV line into fields
+static int split(char* line, char** f, int max) {
+  int n = 0;
+  char* p = line;
+  while (n < max) {
+    f[n++] = p;
+    p = strchr(p, ',');
+    if (!p) break;
+    *p++ = '\0';
+  }
+  for (int i=0; i<n; i++) f[i][strcspn(f[i], "\r\n")] = '\0';
+  return n;
+}
+static int column(char** f, int n, const char* name) {
+  for (int i=0; i<n; i++) if (strcmp(f[i], name)==0) return i;
+  return -1;
+}
+
+// /csv of GyroM5Stick or trace/raw log with USEC
+static void load(const char* path, Series& S) {
+  S.name = path;
+  FILE* fp = fopen(path, "r");
+  if (!fp) { S.error = "cannot open"; return; }
+  char line[1024], vals[1024];
+  char *f[32], *v[32];
+  double Kg = 1.0, MEAN = 0.0;
+  int ct = -1, cu = -1, cw = -1;
+  double tscale = 1.0;
+  if (!fgets(line, sizeof(line), fp)) { S.error = "empty"; fclose(fp); return; }
+  if (strncmp(line, "KG", 2)==0) {
+    // KEYS and CONFIG, then SEC,CH1,SRV,YAW with YAW = Kg*w (Kg = KG/20, signed by CH1)
+    if (!fgets(vals, sizeof(vals), fp)) { S.error = "no config"; fclose(fp); return; }
+    int nk = split(line, f, 32);
+    int nv = split(vals, v, 32);
+    int KG = 50, REV = 0;
+    for (int i=0; i<nk && i<nv; i++) {
+      if (strcmp(f[i],"KG")==0) KG = atoi(v[i]);
+      if (strcmp(f[i],"CH1")==0) REV = atoi(v[i]);
+    }
+    Kg = (KG != 0? KG/20.0: 1.0) * (REV? -1.0: 1.0);
+    if (!fgets(line, sizeof(line), fp)) { S.error = "no data"; fclose(fp); return; }
+  }
+  int n = split(line, f, 32);
+  if ((ct = column(f, n, "SEC")) >= 0) tscale = 1.0;
+  else if ((ct = column(f, n, "USEC")) >= 0) tscale = 1e-6;
+  cu = column(f, n, "SRV");
+  if ((cw = column(f, n, "YAW")) < 0) {
+    Kg = 1.0;
+    if ((cw = column(f, n, "RATE")) < 0) cw = column(f, n, "GZ");
+    MEAN = 1500.0; // absolute servo pulse in trace/raw log
+  }
+  if (ct < 0 || cu < 0 || cw < 0) { S.error = "columns SEC|USEC, SRV, YAW|RATE|GZ required"; fclose(fp); return; }
+
+  std::vector<double> t;
+  while (fgets(line, sizeof(line), fp)) {
+    if (split(line, f, 32) < n) continue;
+    double u = atof(f[cu]);
+    double w = atof(f[cw]);
+    if (u == 0.0 && w == 0.0 && S.u.empty()) continue; // empty ring buffer
+    t.push_back(atof(f[ct])*tscale);
+    S.u.push_back(u != 0.0? u - MEAN: 0.0);
+    S.w.push_back(w / Kg);
+  }
+  fclose(fp);
+  if (t.size() < 50) { S.error = "too short"; return; }
+  // median of sampling time
+  std::vector<double> d;
+  for (size_t i=1; i<t.size(); i++) d.push_back(t[i] - t[i-1]);
+  std::nth_element(d.begin(), d.begin() + d.size()/2, d.end());
+  S.dt = d[d.size()/2];
+  if (S.dt <= 0.0) S.error = "bad time";
+}
+
+// 3x3 linear solve by Gauss elimination (normal equations)
+static bool solve3(double A[3][3], double b[3], double x[3]) {
+  for (int i=0; i<3; i++) {
+    int p = i;
+    for (int r=i+1; r<3; r++) if (fabs(A[r][i]) > fabs(A[p][i])) p = r;
+    if (fabs(A[p][i]) < 1e-12) return false;
+    for (int c=0; c<3; c++) std::swap(A[i][c], A[p][c]);
+    std::swap(b[i], b[p]);
+    for (int r=i+1; r<3; r++) {
+      double m = A[r][i]/A[i][i];
+      for (int c=i; c<3; c++) A[r][c] -= m*A[i][c];
+      b[r] -= m*b[i];
+    }
+  }
+  for (int i=2; i>=0; i--) {
+    double s = b[i];
+    for (int c=i+1; c<3; c++) s -= A[i][c]*x[c];
+    x[i] = s/A[i][i];
+  }
+  return true;
+}
+
+// fit = 100*(1 - |y - yhat|/|y - mean(y)|) of simulated output
+static double fitOf(const Series& S, double K, double T, int d, double c0) {
+  double a = exp(-S.dt/T), y = 0.0, mean = 0.0, e2 = 0.0, v2 = 0.0;
+  size_t N = S.w.size();
+  for (size_t k=0; k<N; k++) mean += S.w[k];
+  mean /= N;
+  for (size_t k=1; k<N; k++) {
+    double u = (k >= (size_t)d+1? S.u[k-1-d]: 0.0);
+    y = a*y + (1.0 - a)*K*u;
+    double e = S.w[k] - (y + c0);
+    e2 += e*e;
+    v2 += (S.w[k] - mean)*(S.w[k] - mean);
+  }
+  return v2 > 0.0? 100.0*(1.0 - sqrt(e2/v2)): -1e9;
+}
+
+// ARX with dead time d samples
+static Fit arx(const Series& S, int d) {
+  double A[3][3] = {{0}}, b[3] = {0}, x[3] = {0}, yy = 0.0;
+  for (size_t k=d+1; k<S.w.size(); k++) {
+    double phi[3] = {S.w[k-1], S.u[k-1-d], 1.0};
+    for (int i=0; i<3; i++) {
+      for (int j=0; j<3; j++) A[i][j] += phi[i]*phi[j];
+      b[i] += phi[i]*S.w[k];
+    }
+    yy += S.w[k]*S.w[k];
+  }
+  double bb[3] = {b[0], b[1], b[2]};
+  Fit F;
+  if (!solve3(A, b, x) || x[0] <= 0.0 || x[0] >= 1.0) return F;
+  F.K = x[1]/(1.0 - x[0]);
+  F.T = -S.dt/log(x[0]);
+  F.L = d*S.dt;
+  F.c = x[2]/(1.0 - x[0]);
+  F.sse = yy - (x[0]*bb[0] + x[1]*bb[1] + x[2]*bb[2]);
+  return F;
+}
+
+// output error with dead time d: grid on T around T0, K by least squares of unit-gain response
+static Fit outputError(const Series& S, int d, double T0, std::vector<double>& x) {
+  Fit best;
+  size_t N = S.w.size();
+  double mw = 0.0, syy = 0.0;
+  for (size_t k=0; k<N; k++) mw += S.w[k];
+  mw /= N;
+  for (size_t k=0; k<N; k++) syy += (S.w[k] - mw)*(S.w[k] - mw);
+  for (int i=0; i<=40; i++) {
+    double T = T0 * pow(4.0, (i - 20)/20.0); // T0/4 .. 4T0
+    if (T < S.dt*0.1) continue;
+    double a = exp(-S.dt/T), y = 0.0, mx = 0.0;
+    for (size_t k=0; k<N; k++) {
+      double u = (k >= (size_t)d+1? S.u[k-1-d]: 0.0);
+      if (k > 0) y = a*y + (1.0 - a)*u;
+      x[k] = y;
+      mx += y;
+    }
+    mx /= N;
+    double sxy = 0.0, sxx = 0.0;
+    for (size_t k=0; k<N; k++) {
+      sxy += (x[k] - mx)*(S.w[k] - mw);
+      sxx += (x[k] - mx)*(x[k] - mx);
+    }
+    if (sxx <= 0.0 || syy <= 0.0) continue;
+    double K = sxy/sxx;
+    // residual of least squares: syy - sxy^2/sxx
+    double f = 100.0*(1.0 - sqrt(std::max(0.0, syy - K*sxy)/syy));
+    if (f > best.fit) {
+      best.K = K;
+      best.T = T;
+      best.L = d*S.dt;
+      best.fit = f;
+    }
+  }
+  return best;
+}
+
+// FOPDT: coarse then fine search of dead time (ARX is biased by output noise)
+static Fit refine(const Series& S, const Fit& init, int dmax) {
+  Fit best = init;
+  std::vector<double> x(S.w.size());
+  int step = std::max(1, dmax/30);
+  int dbest = (int)(init.L/S.dt + 0.5);
+  for (int d=0; d<=dmax; d+=step) {
+    Fit F = outputError(S, d, init.T, x);
+    if (F.fit > best.fit) { best = F; dbest = d; }
+  }
+  for (int d=std::max(0, dbest-step+1); d<=std::min(dmax, dbest+step-1); d++) {
+    Fit F = outputError(S, d, best.T, x);
+    if (F.fit > best.fit) best = F;
+  }
+  return best;
+}
+
+static int clampGain(double g) {
+  int v = (int)lround(g);
+  return v < 0? 0: (v > 100? 100: v);
+}
+
+int main(int argc, char** argv) {
+  int jobs = 0;
+  bool atom = false;
+  double maxL = 0.3;
+  int argi = 1;
+  for (; argi < argc && argv[argi][0] == '-'; argi++) {
+    if (strcmp(argv[argi], "-j")==0 && argi+1 < argc) jobs = atoi(argv[++argi]);
+    else if (strcmp(argv[argi], "-a")==0) atom = true;
+    else if (strcmp(argv[argi], "-l")==0 && argi+1 < argc) maxL = atof(argv[++argi])/1000.0;
+    else {
+      fprintf(stderr, "usage: %s [-j N] [-a] [-l MAXMS] data.csv...\n", argv[0]);
+      return 1;
+    }
+  }
+  if (argi >= argc) {
+    fprintf(stderr, "no data files\n");
+    return 1;
+  }
+  if (jobs <= 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+
+  int files = argc - argi;
+  std::vector<Series> S(files);
+  std::vector<Result> R(files);
+  std::atomic<int> next(0);
+
+  // worker threads pulling indexes
+  auto pool = [&](int count, const std::function<void(int)>& work) {
+    std::vector<std::thread> th;
+    next = 0;
+    for (int j=0; j<jobs; j++) th.emplace_back([&]() {
+      for (int i; (i = next++) < count; ) work(i);
+    });
+    for (auto& t : th) t.join();
+  };
+  // threads over files (load)
+  pool(files, [&](int i) { load(argv[argi+i], S[i]); });
+
+  // threads over (file, dead time)
+  std::vector<std::pair<int,int>> tasks;
+  for (int i=0; i<files; i++) {
+    if (!S[i].error.empty()) continue;
+    int dmax = std::max(1, (int)(maxL/S[i].dt + 0.5));
+    R[i].arx.resize(dmax+1);
+    for (int d=0; d<=dmax; d++) tasks.push_back(std::make_pair(i, d));
+  }
+  pool((int)tasks.size(), [&](int t) { R[tasks[t].first].arx[tasks[t].second] = arx(S[tasks[t].first], tasks[t].second); });
+
+  // threads over files (refine)
+  pool(files, [&](int i) {
+    if (!S[i].error.empty()) return;
+    for (const Fit& F : R[i].arx) if (F.sse < R[i].best.sse) R[i].best = F;
+    Fit& B = R[i].best;
+    if (B.T > 0.0) B.fit = fitOf(S[i], B.K, B.T, (int)(B.L/S[i].dt + 0.5), B.c);
+    if (R[i].best.T > 0.0) R[i].fopdt = refine(S[i], R[i].best, (int)R[i].arx.size()-1);
+  });
+
+  int fails = 0;
+  for (int i=0; i<files; i++) {
+    printf("%s\n", S[i].name.c_str());
+    if (!S[i].error.empty() || R[i].fopdt.T <= 0.0) {
+      printf(" error: %s\n", S[i].error.empty()? "no stable fit": S[i].error.c_str());
+      fails++;
+      continue;
+    }
+    const Fit& A = R[i].best;
+    const Fit& F = R[i].fopdt;
+    printf(" samples: %zu  dt: %.1f ms\n", S[i].w.size(), S[i].dt*1000);
+    printf(" ARX   : K=%8.4f (o/s)/us  T=%6.1f ms  L=%6.1f ms  fit=%5.1f %%\n", A.K, A.T*1000, A.L*1000, A.fit);
+    printf(" FOPDT : K=%8.4f (o/s)/us  T=%6.1f ms  L=%6.1f ms  fit=%5.1f %%\n", F.K, F.T*1000, F.L*1000, F.fit);
+
+    // KG: full stick (500us) asks 80% of max yaw rate
+    double K = fabs(F.K), T = F.T, L = F.L;
+    double Kg = 1.0/(0.8*K);
+    double Kpl = Kg*K;
+    // IMC-PID for FOPDT with closed-loop time constant L
+    double Tc = std::max(L, std::max(S[i].dt, 0.1*T));
+    double Kc = (T + L/2)/(Kpl*(Tc + L/2));
+    double Ti = T + L/2;
+    double Td = T*L/(2*T + L);
+    // integer gains: Kg = KG/20 (Stick) or KG/18 (Atom), Kp = KP/50, Ki = KI/250, Kd = KD/5000
+    printf(" gains : KG=%d KP=%d KI=%d KD=%d (%s)%s\n",
+      clampGain(Kg*(atom? 18.0: 20.0)), clampGain(Kc*50), clampGain(Kc/Ti*250), clampGain(Kc*Td*5000),
+      atom? "GyroM5Atom": "GyroM5Stick", F.K < 0? " reverse": "");
+  }
+  return fails? 2: 0;
+}
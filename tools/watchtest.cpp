@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// watchtest: SYNC=1 の制御周期で Supervisor（締切の監視）が誤検出しないかの試験
+//  GyroM5Core.hpp の Supervisor と GyroM5Atom.hpp の ControlTask::getPeriod, RateLock を仮想時計（tools/host）で動かす
+//  入力フレームごと（RATE=1 なら div 等分）に control() の代わりに tick() を呼ぶ
+//  正常なフレームで遅れ（MISSED）と縮退出力が0、途中で止めたフレームでは遅れを数えれば OK
+//  比較のため、以前の PID 周期（400Hz）を渡した場合の遅れの数も表示
+//
+// build:
+//  g++ -O2 -std=c++17 -fno-strict-aliasing -Ihost -I../libraries/GyroM5Core/src -I../GyroM5Atom -o watchtest watchtest.cpp
+// usage:
+//  ./watchtest   （NG があれば終了コード1）
+////////////////////////////////////////////////////////////////////////////////
+#include "Arduino.h"
+#include "M5Atom.h"
+#include "GyroM5Atom.hpp"
+
+static int FALLBACKS = 0;
+static int inUsec(int) { return 1500; }
+static bool outUsec(int, float) { FALLBACKS++; return true; }
+
+struct Result {
+  int missed;
+  int fallbacks;
+};
+
+// frames of frameUs for 4 sec, control() divided by div, no input for stallMs at 2 sec
+static Result run(int frameUs, int div, int stallMs, bool pidPeriod) {
+  RateLock RX;
+  ControlTask::setDivider(div, frameUs);
+  int missed0 = Supervisor::getMissed();
+  FALLBACKS = 0;
+  Supervisor::start();
+  Supervisor::tick(0);  // no period of the last run
+  unsigned long end = host_clock() + 4000000UL;
+  unsigned long stall = host_clock() + 2000000UL;
+  unsigned long next = host_clock() + frameUs;
+  while (host_clock() < end) {
+    // each frame: control() at the edge and div-1 sub ticks
+    for (int k=0; k<div; k++) {
+      unsigned long at = next + (unsigned long)k*frameUs/div;
+      while (host_clock() < at) { host_clock() += 100; host_tickers(); }
+      if (k == 0) RX.put(at);
+      int period = pidPeriod? 2500: ControlTask::getPeriod(RX.getPeriod());
+      Supervisor::tick(period);
+    }
+    next += frameUs;
+    if (stallMs > 0 && next >= stall) {
+      next += stallMs*1000UL;
+      stallMs = 0;
+    }
+  }
+  Supervisor::stop();
+  Result R;
+  R.missed = Supervisor::getMissed() - missed0;
+  R.fallbacks = FALLBACKS;
+  return R;
+}
+
+int main(void) {
+  Supervisor::setMode(1, 1500);
+  Supervisor::setup(inUsec, outUsec);
+  struct { int frameUs, div; } CASE[] = {{20000,1}, {14000,1}, {7000,1}, {20000,2}, {14000,3}};
+  int ng = 0;
+  printf("%8s %4s %10s %10s %12s %10s\n", "frame", "div", "missed", "fallback", "stall_missed", "old_missed");
+  for (auto& c : CASE) {
+    Result ok = run(c.frameUs, c.div, 0, false);
+    Result stalled = run(c.frameUs, c.div, 100, false);
+    Result old = run(c.frameUs, c.div, 0, true);
+    bool pass = ok.missed == 0 && ok.fallbacks == 0 && stalled.missed > 0;
+    printf("%8d %4d %10d %10d %12d %10d %s\n", c.frameUs, c.div, ok.missed, ok.fallbacks, stalled.missed, old.missed, (pass? "OK": "NG"));
+    if (!pass) ng++;
+  }
+  return ng? 1: 0;
+}
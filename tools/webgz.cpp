@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////
+// ドリフトRCカー用ジャイロシステムGyroM5
+// GyroM5 system for RC drift car
+// https://github.com/hshin-git/GyroM5
+////////////////////////////////////////////////////////////////////////////////
+// webgz: 設定画面のHTMLをgzip圧縮してフラッシュ用のヘッダ(WebUI.h)に変換
+//  各スケッチの html/*.html が元（Arduinoのビルドは src/ 以外のサブフォルダを無視）
+//  行頭の空白と空行を除いてから圧縮（gzipのmtimeは0、同じ入力なら同じ出力）
+//  ETag は圧縮後のデータのFNV-1aハッシュ（HTMLを変えたら必ず作り直す）
+//
+//  出力: ファイル名 index.html に対して
+//   WEBUI_INDEX[] (PROGMEM), WEBUI_INDEX_LEN, WEBUI_INDEX_ETAG
+//
+// build:
+//  g++ -O2 -std=c++17 -o webgz webgz.cpp -lz
+// usage:
+//  ./webgz ../GyroM5Atom/WebUI.h ../GyroM5Atom/html/index.html ../GyroM5Atom/html/save.html
+//  ./webgz ../GyroM5Stick/WebUI.h ../GyroM5Stick/html/index.html
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <string>
+#include <zlib.h>
+
+static bool readFile(const char* path, std::string& text) {
+  FILE* fp = fopen(path, "rb");
+  if (!fp) return false;
+  char buf[4096];
+  size_t n;
+  text.clear();
+  while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) text.append(buf, n);
+  fclose(fp);
+  return true;
+}
+
+// drop indent and blank lines (no <pre> or template strings in the pages)
+static std::string squeeze(const std::string& text) {
+  std::string out;
+  size_t p = 0;
+  while (p < text.size()) {
+    size_t e = text.find('\n', p);
+    if (e == std::string::npos) e = text.size();
+    size_t b = p;
+    while (b < e && (text[b] == ' ' || text[b] == '\t' || text[b] == '\r')) b++;
+    size_t t = e;
+    while (t > b && (text[t-1] == ' ' || text[t-1] == '\t' || text[t-1] == '\r')) t--;
+    if (t > b) { out.append(text, b, t-b); out += '\n'; }
+    p = e + 1;
+  }
+  return out;
+}
+
+// gzip with zero mtime (windowBits 15+16)
+static bool gzip(const std::string& in, std::string& out) {
+  z_stream z;
+  memset(&z, 0, sizeof(z));
+  if (deflateInit2(&z, Z_BEST_COMPRESSION, Z_DEFLATED, 15+16, 9, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+  out.resize(deflateBound(&z, in.size()) + 32);
+  z.next_in = (Bytef*)in.data();
+  z.avail_in = in.size();
+  z.next_out = (Bytef*)&out[0];
+  z.avail_out = out.size();
+  int ret = deflate(&z, Z_FINISH);
+  out.resize(z.total_out);
+  deflateEnd(&z);
+  return ret == Z_STREAM_END;
+}
+
+static uint32_t fnv1a(const std::string& s) {
+  uint32_t h = 2166136261u;
+  for (unsigned char c: s) { h ^= c; h *= 16777619u; }
+  return h;
+}
+
+// "html/index.html" -> "INDEX"
+static std::string symbol(const char* path) {
+  const char* b = strrchr(path, '/');
+  b = b? b+1: path;
+  std::string s;
+  for (; *b && *b != '.'; b++) s += isalnum((unsigned char)*b)? toupper((unsigned char)*b): '_';
+  return s;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: webgz OUT.h FILE.html ...\n");
+    return 1;
+  }
+  FILE* fp = fopen(argv[1], "w");
+  if (!fp) { fprintf(stderr, "webgz: cannot write %s\n", argv[1]); return 1; }
+  fprintf(fp, "////////////////////////////////////////////////////////////////////////////////\n");
+  fprintf(fp, "// WebUI.h: 設定画面（gzip圧縮済み）\n");
+  fprintf(fp, "//  tools/webgz で html/*.html から生成（直接編集しない）\n");
+  fprintf(fp, "////////////////////////////////////////////////////////////////////////////////\n");
+  fprintf(fp, "#ifndef WEBUI_H\n#define WEBUI_H\n\n");
+  for (int i=2; i<argc; i++) {
+    std::string html, gz;
+    if (!readFile(argv[i], html)) { fprintf(stderr, "webgz: cannot read %s\n", argv[i]); return 1; }
+    html = squeeze(html);
+    if (!gzip(html, gz)) { fprintf(stderr, "webgz: deflate failed %s\n", argv[i]); return 1; }
+    std::string name = "WEBUI_" + symbol(argv[i]);
+    const char* base = strrchr(argv[i], '/');
+    fprintf(fp, "// %s: %u -> %u bytes\n", base? base+1: argv[i], (unsigned)html.size(), (unsigned)gz.size());
+    fprintf(fp, "const char %s_ETAG[] = \"\\\"%08x\\\"\";\n", name.c_str(), fnv1a(gz));
+    fprintf(fp, "const size_t %s_LEN = %u;\n", name.c_str(), (unsigned)gz.size());
+    fprintf(fp, "const uint8_t %s[] PROGMEM = {", name.c_str());
+    for (size_t k=0; k<gz.size(); k++) fprintf(fp, "%s0x%02x,", k%16? "": "\n ", (unsigned char)gz[k]);
+    fprintf(fp, "\n};\n\n");
+    printf("%s: %u -> %u bytes\n", argv[i], (unsigned)html.size(), (unsigned)gz.size());
+  }
+  fprintf(fp, "#endif\n");
+  fclose(fp);
+  return 0;
+}